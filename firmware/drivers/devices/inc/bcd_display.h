@@ -0,0 +1,120 @@
+#ifndef BCD_DISPLAY_H
+#define BCD_DISPLAY_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup BCD_DISPLAY BCD Display
+ ** @{ */
+
+/** \brief Driver for N digits multiplexed displays driven through BCD to 7 segments decoders.
+ *
+ * The display shares 4 BCD lines between all the digits, and each digit has its own
+ * selection line. A timer periodically scans the digits (one digit per time slot),
+ * so the application only needs to write the value to show.
+ *
+ * @note The GPIO writes for each digit are precomputed as port masks, and new values
+ * are loaded in a back buffer that is swapped at the start of the next scan frame.
+ *
+ * @note Example of connection (3 digits display in ESP-EDU):
+ * |   Display      |   EDU-CIAA	|
+ * |:--------------:|:-------------:|
+ * | 	BCD1		| 	GPIO_20		|
+ * | 	BCD2	 	| 	GPIO_21		|
+ * | 	BCD3	 	| 	GPIO_22		|
+ * | 	BCD4	 	| 	GPIO_23		|
+ * | 	SEL1	 	| 	GPIO_19		|
+ * | 	SEL2	 	| 	GPIO_18		|
+ * | 	SEL3	 	| 	GPIO_9		|
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_mcu.h"
+#include "timer_mcu.h"
+/*==================[macros]=================================================*/
+#define BCD_DISPLAY_BITS			4		/*!< Number of BCD lines */
+#define BCD_DISPLAY_MAX_DIGITS		8		/*!< Maximum number of digits */
+#define BCD_DISPLAY_REFRESH_HZ		100		/*!< Default refresh rate (complete frames per second) */
+/*==================[typedef]================================================*/
+/**
+ * @brief GPIO configuration for a display line
+ */
+typedef struct {
+	gpio_t pin;			/*!< GPIO pin number */
+} bcd_pin_conf_t;
+
+/**
+ * @brief Display configuration struct
+ */
+typedef struct {
+	bcd_pin_conf_t *bcd_map;	/*!< BCD lines (bcd_map[0]: b0 ... bcd_map[3]: b3) */
+	bcd_pin_conf_t *digit_map;	/*!< Digit selection lines (digit_map[0]: most significant digit) */
+	uint8_t digits;				/*!< Number of digits (up to BCD_DISPLAY_MAX_DIGITS) */
+	timer_mcu_t timer;			/*!< Timer used to scan the display */
+	uint16_t refresh_hz;		/*!< Frames per second (0: BCD_DISPLAY_REFRESH_HZ) */
+} bcd_display_config_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Display initialization. Configures the GPIOs and starts the scan timer.
+ *
+ * @param config Display configuration
+ * @return true if success, false if the configuration is not valid
+ */
+bool BcdDisplayInit(bcd_display_config_t *config);
+
+/**
+ * @brief Display a value.
+ *
+ * @note The value is shown from the next scan frame, without blocking.
+ *
+ * @param value Number to display
+ * @return true if the value fits in the display, false in other case
+ */
+bool BcdDisplayWrite(uint32_t value);
+
+/**
+ * @brief Display an array of BCD digits.
+ *
+ * @param bcd Array of digits (bcd[0]: most significant digit). Values higher
+ * than 9 are usually shown as blank by the decoders.
+ */
+void BcdDisplayWriteDigits(const uint8_t *bcd);
+
+/**
+ * @brief Read value displayed.
+ *
+ * @return uint32_t value displayed.
+ */
+uint32_t BcdDisplayRead(void);
+
+/**
+ * @brief Turn off display (all digits blank).
+ */
+void BcdDisplayOff(void);
+
+/**
+ * @brief Stop the display scan and release its timer.
+ *
+ * @return true
+ */
+bool BcdDisplayDeInit(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* #ifndef BCD_DISPLAY_H */
+
+/*==================[end of file]============================================*/
@@ -7,8 +7,15 @@
 /** \addtogroup BUZZER Buzzer
  ** @{ */
 
-/** @brief 
+/** @brief Buzzer driver.
  *
+ * Tones and RTTTL melodies can be played blocking the calling task (BuzzerPlayTone(),
+ * BuzzerPlayRtttl()) or in background (BuzzerPlay(), BuzzerAlarm()). In background,
+ * songs are played note by note from a timer callback: songs are queued, and alarms 
+ * interrupt the song being played.
+ * 
+ * @note RTTTL melodies must be converted to an array of notes with BuzzerParseRtttl()
+ * before playing them in background. The array must remain valid while the song is played.
  *
  * @author Albano Peñalva
  * 
@@ -17,13 +24,18 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 08/04/2024 | Document creation		                         |
+ * | 19/10/2026 | Background player, queue and alarms            |
  *
  */
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
+#include <stdbool.h>
 #include <gpio_mcu.h>
+#include "timer_mcu.h"
 /*==================[macros]=================================================*/
+#define BUZZER_QUEUE_LEN	4		/*!< Max number of songs waiting to be played */
+
 /* Note frequency (in Hz) */
 #define NOTE_B0  31
 #define NOTE_C1  33
@@ -115,6 +127,13 @@
 #define NOTE_D8  4699
 #define NOTE_DS8 4978
 /*==================[typedef]================================================*/
+/**
+ * @brief Note of a song
+ */
+typedef struct {
+	uint16_t freq;			/*!< Tone frequency in Hz (0: silence) */
+	uint16_t duration;		/*!< Note duration in ms */
+} buzzer_note_t;
 
 /*==================[external data declaration]==============================*/
 
@@ -161,6 +180,66 @@ void BuzzerPlayTone(uint16_t freq, uint16_t duration);
  */
 void BuzzerPlayRtttl(const char * rtttl_melody);
 
+/**
+ * @brief Converts a RTTTL melody to an array of notes.
+ * 
+ * @note Notes are played in octaves 4 to 7: other octaves are moved to the nearest one.
+ * 
+ * @param rtttl_melody String containing text with a RTTTL melody.
+ * @param notes Array to store the notes.
+ * @param max_notes Size of the array.
+ * @return uint16_t Number of notes stored.
+ */
+uint16_t BuzzerParseRtttl(const char * rtttl_melody, buzzer_note_t *notes, uint16_t max_notes);
+
+/**
+ * @brief Background player initialization.
+ * 
+ * @note The timer callback selects the notes, and a task (created here) changes 
+ * the PWM frequency, which can't be done from an interrupt.
+ * 
+ * @param timer Timer used to play the notes.
+ */
+void BuzzerPlayerInit(timer_mcu_t timer);
+
+/**
+ * @brief Plays a song in background. If other song is playing, the song is queued.
+ * 
+ * @param notes Song notes.
+ * @param length Number of notes.
+ * @return true if the song is queued, false if the queue is full.
+ */
+bool BuzzerPlay(const buzzer_note_t *notes, uint16_t length);
+
+/**
+ * @brief Plays an alarm in background, interrupting the song being played (if any). 
+ * 
+ * @note The interrupted song is discarded (it doesn't resume after the alarm). Songs 
+ * still in the queue are played after the alarm. 
+ * 
+ * @param notes Alarm notes.
+ * @param length Number of notes.
+ * @param repeat Repeat the alarm until BuzzerStopAlarm() is called.
+ */
+void BuzzerAlarm(const buzzer_note_t *notes, uint16_t length, bool repeat);
+
+/**
+ * @brief Stops the alarm being played. Queued songs continue playing.
+ */
+void BuzzerStopAlarm(void);
+
+/**
+ * @brief Stops playing and discards the queued songs.
+ */
+void BuzzerStop(void);
+
+/**
+ * @brief Checks if the background player is playing.
+ * 
+ * @return true if a song or alarm is playing.
+ */
+bool BuzzerIsPlaying(void);
+
 /**
  * @brief Buzzer de-initialization.
  */
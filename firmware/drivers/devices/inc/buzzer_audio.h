@@ -0,0 +1,103 @@
+#ifndef BUZZER_AUDIO_H
+#define BUZZER_AUDIO_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup BUZZER_AUDIO Buzzer Audio
+ ** @{ */
+
+/** @brief Audio samples playback through the buzzer.
+ *
+ * Plays IMA-ADPCM compressed sounds (4 bits per sample, 8 kHz to 16 kHz) with 
+ * the sigma-delta modulator (SDM) of the ESP32-C6 connected to the buzzer pin.
+ * 
+ * A timer callback loads one sample per period in the SDM, from one of two 
+ * buffers, while a task decodes the next samples in the other buffer.
+ * 
+ * @note Sounds are generated with the tool firmware/tools/wav2adpcm.py, that 
+ * converts a WAV file into a C source file with a buzzer_audio_t variable.
+ * 
+ * @note The SDM takes the control of the pin. Call BuzzerInit() again to play 
+ * tones after BuzzerAudioDeinit().
+ *
+ * @author Albano Peñalva
+ * 
+ * @section changelog
+ *
+ * |   Date	    | Description                                    |
+ * |:----------:|:-----------------------------------------------|
+ * | 19/10/2026 | Document creation		                         |
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_mcu.h"
+#include "timer_mcu.h"
+/*==================[macros]=================================================*/
+#define BUZZER_AUDIO_BUF_LEN	256		/*!< Samples per buffer */
+#define BUZZER_AUDIO_RATE_MIN	8000	/*!< Min sample rate (Hz) */
+#define BUZZER_AUDIO_RATE_MAX	16000	/*!< Max sample rate (Hz) */
+/*==================[typedef]================================================*/
+/**
+ * @brief IMA-ADPCM sound (mono, two samples per byte, low nibble first)
+ */
+typedef struct {
+	const uint8_t *data;		/*!< Compressed samples */
+	uint32_t samples;			/*!< Number of samples */
+	uint16_t sample_rate;		/*!< Sample rate (Hz) */
+	int16_t predictor;			/*!< Initial decoder predictor (first sample) */
+	uint8_t step_index;			/*!< Initial decoder step index */
+} buzzer_audio_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Audio playback initialization.
+ * 
+ * @param pin GPIO connected to the buzzer.
+ * @param timer Timer used to output the samples.
+ * @return true if success
+ */
+bool BuzzerAudioInit(gpio_t pin, timer_mcu_t timer);
+
+/**
+ * @brief Plays a sound in background. A sound being played is stopped.
+ * 
+ * @param sound Sound to play. It must remain valid while it is played.
+ * @return true if success, false if the sample rate is not supported
+ */
+bool BuzzerAudioPlay(const buzzer_audio_t *sound);
+
+/**
+ * @brief Stops the sound being played.
+ */
+void BuzzerAudioStop(void);
+
+/**
+ * @brief Checks if a sound is being played.
+ * 
+ * @return true if playing
+ */
+bool BuzzerAudioIsPlaying(void);
+
+/**
+ * @brief Sets the playback volume.
+ * 
+ * @param volume Volume in % (0 to 100)
+ */
+void BuzzerAudioSetVolume(uint8_t volume);
+
+/**
+ * @brief Audio playback de-initialization. Releases the SDM channel.
+ */
+void BuzzerAudioDeinit(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* #ifndef BUZZER_AUDIO_H */
+
+/*==================[end of file]============================================*/
@@ -15,6 +15,9 @@
  * 
  * @note Created with http://www.eran.io/the-dot-factory-an-lcd-font-and-image-generator/
  * 
+ * @note Anti-aliased fonts (aa_font_t) are created with tools/font2ili9341.py from TrueType
+ * fonts, with only the characters used by the project.
+ * 
  * @author Albano Peñalva
  *
  * @section changelog
@@ -22,12 +25,15 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 05/04/2024 | Document creation		                         						|
+ * | 19/10/2026 | Anti-aliased compressed fonts (aa_font_t)								|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
+#include <stdbool.h>
 /*==================[macros]=================================================*/
+#define AA_FONT_NO_CHAR		0xFF	/*!< Character not included in an anti-aliased font */
 
 /*==================[typedef]================================================*/
 /**
@@ -46,6 +52,35 @@ typedef struct{
 	const uint8_t 	*data; 			/*!< Font array */
 } Font_t;
 
+/**
+ * @brief Anti-aliased character information
+ */
+typedef struct{
+	uint8_t width;		/*<! Character width in pixels (including the space to the next one) */
+	uint32_t offset;	/*<! Character position in font array */
+} aa_char_info_t;
+/**
+ * @brief  Anti-aliased font structure
+ *
+ * Each character is a font_height x width bitmap of coverage levels (0: background,
+ * (1 << bpp) - 1: foreground), row by row without padding (only the first row starts
+ * in a new byte):
+ * - rle = false: levels packed in bytes, first pixel in the most significant bits.
+ * - rle = true: runs of pixels with the same level (may continue in the next row). First
+ * byte: level in the bpp most significant bits, run length - 1 in the rest. If the run
+ * length bits are all ones, the next byte is added to the run length.
+ */
+typedef struct{
+	uint8_t 				font_height;	/*!< Font height in pixels */
+	uint8_t 				bpp;			/*!< Bits per pixel: 2 or 4 */
+	bool 					rle;			/*!< Run length encoded characters */
+	char 					first;			/*!< First character of map */
+	char 					last;			/*!< Last character of map */
+	const uint8_t 			*map;			/*!< Info index of each character from first to last (AA_FONT_NO_CHAR: not included) */
+	const aa_char_info_t 	*info;			/*!< Character info array */
+	const uint8_t 			*data;			/*!< Font array */
+} aa_font_t;
+
 /*==================[external data declaration]==============================*/
 /**
  * @brief  11 pixels font height structure
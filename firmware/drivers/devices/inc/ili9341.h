@@ -12,6 +12,9 @@
  * TFT color display connected to the ESP-EDU. It uses a SPI port and 3 GPIOs to 
  * communicate with the ILI9341 LCD driver chip.
  *
+ * @note Pixels are sent by DMA in chunks of 4 KB (one chunk is filled while the
+ * previous one is sent), so drawing functions can return before the transfer ends.
+ *
  * @author Albano Peñalva
  *
  * @note Hardware connections:
@@ -33,11 +36,20 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 18/01/2024 | Document creation		                         |
+ * | 19/10/2026 | SPI device added once, DMA queued pixel chunks |
+ * | 19/10/2026 | Area writes from DMA buffers (scene renderer)  |
+ * | 19/10/2026 | Strings drawn by lines, cached glyphs          |
+ * | 19/10/2026 | Lines, circles and triangles drawn by spans    |
+ * | 19/10/2026 | Compressed images (RLE and palette)            |
+ * | 19/10/2026 | Hardware vertical scrolling                    |
+ * | 19/10/2026 | Anti-aliased compressed fonts                  |
+ * | 19/10/2026 | Sprites (clipping, color key) and area reads   |
  *
  */
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
+#include <stdbool.h>
 #include "spi_mcu.h"
 #include "fonts.h"
 #include "icons.h"
@@ -46,6 +58,8 @@
 #define ILI9341_WIDTH       240			/*!< LCD width in pixels */
 #define ILI9341_HEIGHT      320			/*!< LCD height in pixels */
 #define ILI9341_PIXEL_MAX	76800
+#define ILI9341_NO_KEY		0x10000		/*!< Sprite without transparent color (see ILI9341DrawSprite()) */
+#define ILI9341_SPRITE_MAX_WIDTH	320	/*!< Max width of the sprite images (see ILI9341DrawSprite()) */
 /* 16bits colors (RGB565) */			/*	 R,   G,   B */
 #define ILI9341_BLACK          	0x0000  /*   0,   0,   0 */
 #define ILI9341_NAVY           	0x000F 	/*   0,   0, 128 */
@@ -80,6 +94,42 @@ typedef enum ili9341_orientation {
 	ILI9341_Landscape_1, 	/*!< Landscape orientation mode 1 */
 	ILI9341_Landscape_2  	/*!< Landscape orientation mode 2 */
 } ili9341_orientation_t;
+
+/**
+ * @brief  Image compression formats
+ * 
+ * RLE packets start with a header byte: bit 7 set means a run of (bits 6..0 + 1) 
+ * copies of the next pixel, bit 7 clear means (bits 6..0 + 1) literal pixels follow.
+ */
+typedef enum ili9341_image_format {
+	ILI9341_IMAGE_RAW,			/*!< RGB565 pixels, high byte first (same as ILI9341DrawPicture()) */
+	ILI9341_IMAGE_RLE,			/*!< RLE packets of RGB565 pixels (high byte first) */
+	ILI9341_IMAGE_PALETTE,		/*!< Palette indexes of bpp bits, packed MSB first */
+	ILI9341_IMAGE_PALETTE_RLE	/*!< RLE packets of 8 bits palette indexes */
+} ili9341_image_format_t;
+
+/**
+ * @brief  Image asset (generated with firmware/tools/img2ili9341.py)
+ */
+typedef struct {
+	uint16_t width;				/*!< Width in pixels */
+	uint16_t height;			/*!< Height in pixels */
+	uint8_t format;				/*!< Compression format (ili9341_image_format_t) */
+	uint8_t bpp;				/*!< Bits per palette index (1, 2, 4 or 8), ILI9341_IMAGE_PALETTE only */
+	const uint16_t *palette;	/*!< Palette colors (RGB565), NULL if not used */
+	const uint8_t *data;		/*!< Compressed pixels */
+	uint32_t size;				/*!< Bytes of compressed pixels */
+} ili9341_image_t;
+
+/**
+ * @brief  Area of the LCD (coordinates included in the area)
+ */
+typedef struct {
+	int16_t x0;					/*!< Left column */
+	int16_t y0;					/*!< Top row */
+	int16_t x1;					/*!< Right column */
+	int16_t y1;					/*!< Bottom row */
+} ili9341_area_t;
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
@@ -174,6 +224,30 @@ void ILI9341DrawString(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t
  */
 void ILI9341GetStringSize(char* str, Font_t* font, uint16_t* width, uint16_t* height);
 
+/**
+ * @brief  		Draws a string with an anti-aliased font (edges blended with the background color)
+ * @note		Characters not included in the font are skipped. Characters that don't fit
+ * 				completely in the LCD aren't drawn (there is no wrapping).
+ * @param[in]  	x: X position of top left corner of first character
+ * @param[in]  	y: Y position of top left corner of first character
+ * @param[in]  	str: Pointer to first character ("\n": new line)
+ * @param[in]  	font: Pointer to anti-aliased font
+ * @param[in]  	foreground: Color for string (RGB565)
+ * @param[in]  	background: Color for string background (RGB565)
+ * @retval 		None
+ */
+void ILI9341DrawAAString(uint16_t x, uint16_t y, const char *str, const aa_font_t *font, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Gets width and height of box with text of an anti-aliased font
+ * @param[in]  	str: Pointer to first character
+ * @param[in] 	font: Pointer to anti-aliased font
+ * @param[out]	width: Pointer to variable to store width (of the longest line)
+ * @param[out]	height: Pointer to variable to store height
+ * @retval 		None
+ */
+void ILI9341GetAAStringSize(const char *str, const aa_font_t *font, uint16_t *width, uint16_t *height);
+
 /**
  * @brief  		Draws line on the LCD
  * @param[in]  	x0: X coordinate of starting point
@@ -267,6 +341,123 @@ void ILI9341DrawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, i
  */
 void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pic);
 
+/**
+ * @brief  		Draw a compressed image on the LCD
+ * @note		Pixels are decoded directly in the DMA buffers, one chunk is decoded 
+ * 				while the previous one is sent.
+ * @param[in] 	x: X position of top left corner of image
+ * @param[in]  	y: Y position of top left corner of image
+ * @param[in]  	image: Image
+ * @retval 		false if the image format is not valid (nothing is drawn)
+ */
+bool ILI9341DrawImage(uint16_t x, uint16_t y, const ili9341_image_t *image);
+
+/**
+ * @brief  		Write an area of the LCD from a buffer of pixels, using DMA without copies
+ * @note		The buffer must be DMA capable (see SpiDmaMalloc()) and can't be modified
+ * 				until the next call to any ILI9341 function (that waits the end of the transfer).
+ * @param[in] 	x: X position of top left corner of the area
+ * @param[in]  	y: Y position of top left corner of the area
+ * @param[in] 	width: Area width in pixels
+ * @param[in]  	height: Area height in pixels
+ * @param[in]  	pixels: Pixels (2 bytes/pixel, high byte first), row by row
+ * @retval 		None
+ */
+void ILI9341WriteArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pixels);
+
+/**
+ * @brief  		Read an area of the LCD frame memory
+ * @note		Needs the SDO line of the LCD connected to MISO. Reads use a 6 MHz clock
+ * 				(the LCD read cycle is 150 ns): the SPI device is added again with that
+ * 				clock, and with the write clock at the end (see SpiSetBitrate()).
+ * @param[in] 	x: X position of top left corner of the area
+ * @param[in]  	y: Y position of top left corner of the area
+ * @param[in] 	width: Area width in pixels
+ * @param[in]  	height: Area height in pixels
+ * @param[out] 	pixels: Pixels (2 bytes/pixel, high byte first), row by row
+ * @retval 		None
+ */
+void ILI9341ReadArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t* pixels);
+
+/**
+ * @brief  		Write an area of the LCD from a rectangle of a bigger buffer of pixels
+ * @note		Pixels are copied to the DMA buffers of the driver: the buffer can be in any
+ * 				memory and can be modified when the function returns.
+ * @param[in] 	x: X position of top left corner of the area
+ * @param[in]  	y: Y position of top left corner of the area
+ * @param[in] 	width: Area width in pixels
+ * @param[in]  	height: Area height in pixels
+ * @param[in]  	pixels: First pixel of the rectangle (2 bytes/pixel, high byte first)
+ * @param[in]  	stride: Pixels from the start of a row of the buffer to the next one
+ * @retval 		None
+ */
+void ILI9341WriteSubArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pixels, uint16_t stride);
+
+/**
+ * @brief  		Draw an image clipped to an area, with a transparent color
+ * @note		Transparent pixels (equal to key) are taken from background. Without background
+ * 				they are left as they are: each run of visible pixels is drawn in its own window.
+ * @param[in] 	x: X position of top left corner (can be out of the LCD)
+ * @param[in]  	y: Y position of top left corner (can be out of the LCD)
+ * @param[in]  	image: Image (any format, up to ILI9341_SPRITE_MAX_WIDTH pixels wide)
+ * @param[in]  	key: Transparent color (RGB565), ILI9341_NO_KEY: none
+ * @param[in]  	clip: Area where the image can be drawn (NULL: the entire LCD)
+ * @param[in]  	background: Pixels under the visible area (see ILI9341SpriteArea()), with the
+ * 				format of ILI9341ReadArea(). NULL: none
+ * @retval 		false if the image is not valid
+ */
+bool ILI9341DrawSprite(int16_t x, int16_t y, const ili9341_image_t *image, uint32_t key, const ili9341_area_t *clip, const uint8_t *background);
+
+/**
+ * @brief  		Visible area of an image drawn with ILI9341DrawSprite()
+ * @param[in] 	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	image: Image
+ * @param[in]  	clip: Area where the image can be drawn (NULL: the entire LCD)
+ * @param[out]  area: Visible area
+ * @retval 		false if no pixel is visible
+ */
+bool ILI9341SpriteArea(int16_t x, int16_t y, const ili9341_image_t *image, const ili9341_area_t *clip, ili9341_area_t *area);
+
+/**
+ * @brief  		LCD width in the actual orientation
+ * @retval 		Width in pixels
+ */
+uint16_t ILI9341GetWidth(void);
+
+/**
+ * @brief  		LCD height in the actual orientation
+ * @retval 		Height in pixels
+ */
+uint16_t ILI9341GetHeight(void);
+
+/**
+ * @brief  		LCD actual orientation
+ * @retval 		Orientation
+ */
+ili9341_orientation_t ILI9341GetOrientation(void);
+
+/**
+ * @brief  		Define the vertical scrolling area (VSCRDEF)
+ * @note		Scrolling works on frame memory lines, along the 320 pixels side of the LCD
+ * 				(vertical in portrait, horizontal in landscape). Line 0 is y = 0 (x = 0 in 
+ * 				landscape) in ILI9341_Portrait_1 and ILI9341_Landscape_1, and the last line 
+ * 				(ILI9341_HEIGHT - 1) in the other orientations. Lines out of the area are fixed.
+ * @param[in]  	top_fixed: Lines before the scrolling area
+ * @param[in]  	lines: Lines of the scrolling area
+ * @retval 		None
+ */
+void ILI9341SetScrollArea(uint16_t top_fixed, uint16_t lines);
+
+/**
+ * @brief  		Set the frame memory line shown at the start of the scrolling area (VSCRSAD)
+ * @note		Following lines of the area are shown after it, wrapping at the end of the area. 
+ * 				Drawing functions keep writing the frame memory without scroll.
+ * @param[in]  	line: Frame memory line (inside the scrolling area)
+ * @retval 		None
+ */
+void ILI9341Scroll(uint16_t line);
+
 /**
  * @brief  	De-initializes ILI9341 LCD
  * @param	None
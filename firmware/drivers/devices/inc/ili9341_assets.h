@@ -0,0 +1,140 @@
+#ifndef ILI9341_ASSETS_H_
+#define ILI9341_ASSETS_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup ILI9341_Assets ILI9341_Assets
+ ** @{ */
+
+/** \brief Images, fonts and icons stored in a flash partition.
+ *
+ * Assets compiled into the application (fonts.c, icons.c, images generated with
+ * img2ili9341.py) take space of the firmware, and any change means building and
+ * flashing everything again. Instead, they can be packed in a data partition with
+ * firmware/tools/assets2ili9341.py and flashed only when they change.
+ *
+ * The partition is mapped in the address space (esp_partition_mmap()), and each asset
+ * is found by name in its index. The ILI9341Assets*() functions fill the usual
+ * descriptors (ili9341_image_t, Font_t, aa_font_t, icon_font_t) with pointers to the
+ * mapped flash, so they are drawn with the ILI9341*() functions without copying
+ * pixels or glyphs to RAM.
+ *
+ * Partition table (partitions.csv of the project, CONFIG_PARTITION_TABLE_CUSTOM):
+ *
+ *     # Name,   Type, SubType, Offset, Size
+ *     assets,   data, 0x40,    ,       1M
+ *
+ * Flashing the assets (the application isn't changed):
+ *
+ *     python3 assets2ili9341.py assets.bin --font font_30=fonts.c:font_30 --image logo=logo.png
+ *     parttool.py write_partition --partition-name assets --input assets.bin
+ *
+ * Partition format (little endian, offsets from the start of the partition):
+ * - Header: magic "ILAS", version (16 bits), number of assets (16 bits), bytes used (32 bits).
+ * - Index: one 32 bytes entry per asset, sorted by name: name (20 bytes, ending with '\0'),
+ * type (8 bits, ili9341_asset_type_t), 3 reserved bytes, offset and size (32 bits each).
+ * - Assets, starting at offsets multiple of 4: a header with the fields of the descriptor,
+ * followed by the arrays the descriptor points to (see ili9341_assets.c).
+ *
+ * @note The descriptors must remain valid while used (declare them static or global):
+ * the glyph cache identifies the fonts by address.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ili9341.h"
+#include "fonts.h"
+#include "icons.h"
+/*==================[macros]=================================================*/
+#define ILI9341_ASSETS_SUBTYPE		0x40	/*!< Data partition subtype of the assets */
+#define ILI9341_ASSETS_NAME_LEN		20		/*!< Max name length (with the ending '\0') */
+/*==================[typedef]================================================*/
+/**
+ * @brief  Asset types
+ */
+typedef enum ili9341_asset_type {
+	ILI9341_ASSET_IMAGE = 1,	/*!< ili9341_image_t */
+	ILI9341_ASSET_FONT,			/*!< Font_t */
+	ILI9341_ASSET_AA_FONT,		/*!< aa_font_t */
+	ILI9341_ASSET_ICONS			/*!< icon_font_t */
+} ili9341_asset_type_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Maps the assets partition
+ * @param[in]  	label: Partition name (NULL: first data partition of subtype ILI9341_ASSETS_SUBTYPE)
+ * @retval 		true if success, false if the partition isn't found or has no valid assets
+ */
+bool ILI9341AssetsInit(const char *label);
+
+/**
+ * @brief  		Number of assets in the partition
+ * @retval 		Number of assets (0 if the partition isn't mapped)
+ */
+uint16_t ILI9341AssetsCount(void);
+
+/**
+ * @brief  		Look for an asset
+ * @param[in]  	name: Asset name
+ * @param[out]  type: Asset type (NULL: not used)
+ * @param[out]  size: Asset size in bytes (NULL: not used)
+ * @retval 		true if the asset is in the partition
+ */
+bool ILI9341AssetsFind(const char *name, ili9341_asset_type_t *type, uint32_t *size);
+
+/**
+ * @brief  		Image from the partition (draw it with ILI9341DrawImage())
+ * @param[in]  	name: Asset name
+ * @param[out]  image: Descriptor, pointing to the mapped flash
+ * @retval 		false if there is no image with that name (or it is corrupted)
+ */
+bool ILI9341AssetsImage(const char *name, ili9341_image_t *image);
+
+/**
+ * @brief  		Font from the partition (draw it with ILI9341DrawString())
+ * @param[in]  	name: Asset name
+ * @param[out]  font: Descriptor, pointing to the mapped flash
+ * @retval 		false if there is no font with that name (or it is corrupted)
+ */
+bool ILI9341AssetsFont(const char *name, Font_t *font);
+
+/**
+ * @brief  		Anti-aliased font from the partition (draw it with ILI9341DrawAAString())
+ * @param[in]  	name: Asset name
+ * @param[out]  font: Descriptor, pointing to the mapped flash
+ * @retval 		false if there is no anti-aliased font with that name (or it is corrupted)
+ */
+bool ILI9341AssetsAAFont(const char *name, aa_font_t *font);
+
+/**
+ * @brief  		Icon font from the partition (draw it with ILI9341DrawIcon())
+ * @param[in]  	name: Asset name
+ * @param[out]  icons: Descriptor, pointing to the mapped flash
+ * @retval 		false if there is no icon font with that name
+ */
+bool ILI9341AssetsIcons(const char *name, icon_font_t *icons);
+
+/**
+ * @brief  		Unmaps the partition (descriptors filled before can't be used anymore)
+ * @retval 		None
+ */
+void ILI9341AssetsDeinit(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ILI9341_ASSETS_H_ */
+
+/*==================[end of file]============================================*/
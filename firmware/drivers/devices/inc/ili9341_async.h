@@ -0,0 +1,195 @@
+#ifndef ILI9341_ASYNC_H_
+#define ILI9341_ASYNC_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup ILI9341_Async ILI9341_Async
+ ** @{ */
+
+/** \brief Asynchronous drawing on the ILI9341 display.
+ *
+ * The ILI9341Async*() functions don't draw: they put a small command in a queue and
+ * return (a few microseconds), so several tasks can draw without waiting the display.
+ * A service task takes the commands and draws them with the ILI9341*() functions,
+ * in the same order they were queued.
+ *
+ * The service task takes all the commands waiting in the queue (up to
+ * ILI9341_ASYNC_BATCH) and, before drawing them:
+ * - drops the commands completely covered by a later opaque command (filled
+ * rectangles, pictures, images, numbers and single line strings, that paint their
+ * whole area), for example old values of a label updated faster than the display;
+ * - merges consecutive filled rectangles of the same color that form a rectangle.
+ *
+ * @note After ILI9341AsyncInit() only the service task must call the ILI9341*()
+ * drawing functions (they aren't reentrant).
+ *
+ * @note Strings are copied in the command (up to ILI9341_ASYNC_TEXT_LEN - 1 characters).
+ * Fonts, pictures and images must remain valid until they are drawn (see ILI9341AsyncWait()).
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ili9341.h"
+/*==================[macros]=================================================*/
+#define ILI9341_ASYNC_QUEUE_LEN		32		/*!< Commands in the queue */
+#define ILI9341_ASYNC_BATCH			16		/*!< Commands merged and drawn together */
+#define ILI9341_ASYNC_TEXT_LEN		24		/*!< Max string length (with the ending '\0') */
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Creates the command queue and the service task
+ * @note		Call it after ILI9341Init().
+ * @retval 		true if success, false if there is no memory
+ */
+bool ILI9341AsyncInit(void);
+
+/**
+ * @brief  		Queue a fill of the entire LCD (see ILI9341Fill())
+ * @param[in]	color: Color (RGB565)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncFill(uint16_t color);
+
+/**
+ * @brief  		Queue a pixel (see ILI9341DrawPixel())
+ * @param[in]  	x: X position
+ * @param[in]  	y: Y position
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncPixel(uint16_t x, uint16_t y, uint16_t color);
+
+/**
+ * @brief  		Queue a line (see ILI9341DrawLine())
+ * @param[in]  	x0: X coordinate of starting point
+ * @param[in]  	y0: Y coordinate of starting point
+ * @param[in]  	x1: X coordinate of ending point
+ * @param[in]  	y1: Y coordinate of ending point
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+
+/**
+ * @brief  		Queue a rectangle (see ILI9341DrawRectangle() and ILI9341DrawFilledRectangle())
+ * @param[in]  	x0: X coordinate of top left corner
+ * @param[in]  	y0: Y coordinate of top left corner
+ * @param[in]  	x1: X coordinate of bottom right corner
+ * @param[in]  	y1: Y coordinate of bottom right corner
+ * @param[in]  	color: Color (RGB565)
+ * @param[in]  	filled: true: filled rectangle, false: only the border
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color, bool filled);
+
+/**
+ * @brief  		Queue a circle (see ILI9341DrawCircle() and ILI9341DrawFilledCircle())
+ * @param[in]  	x: X coordinate of center
+ * @param[in]  	y: Y coordinate of center
+ * @param[in]  	r: Radius
+ * @param[in]  	color: Color (RGB565)
+ * @param[in]  	filled: true: filled circle, false: only the border
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncCircle(int16_t x, int16_t y, int16_t r, uint16_t color, bool filled);
+
+/**
+ * @brief  		Queue a triangle (see ILI9341DrawTriangle() and ILI9341DrawFilledTriangle())
+ * @param[in]  	x0: X coordinate of first vertex
+ * @param[in]  	y0: Y coordinate of first vertex
+ * @param[in]  	x1: X coordinate of second vertex
+ * @param[in]  	y1: Y coordinate of second vertex
+ * @param[in]  	x2: X coordinate of third vertex
+ * @param[in]  	y2: Y coordinate of third vertex
+ * @param[in]  	color: Color (RGB565)
+ * @param[in]  	filled: true: filled triangle, false: only the border
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color, bool filled);
+
+/**
+ * @brief  		Queue a string (see ILI9341DrawString())
+ * @param[in] 	x: X position of top left corner of first character
+ * @param[in]  	y: Y position of top left corner of first character
+ * @param[in]  	str: String (copied, up to ILI9341_ASYNC_TEXT_LEN - 1 characters)
+ * @param[in]  	font: Font
+ * @param[in]  	foreground: Color for string (RGB565)
+ * @param[in]  	background: Color for string background (RGB565)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncString(uint16_t x, uint16_t y, const char *str, Font_t *font, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Queue an integer (see ILI9341DrawInt())
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	num: Number
+ * @param[in] 	dig: Number of digits
+ * @param[in]  	font: Font
+ * @param[in]  	foreground: Color for digits (RGB565)
+ * @param[in]  	background: Color for background (RGB565)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t *font, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Queue an icon (see ILI9341DrawIcon())
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	icon: Icon
+ * @param[in]  	icon_font: Icon font
+ * @param[in]  	foreground: Color for icon (RGB565)
+ * @param[in]  	background: Color for icon background (RGB565)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t *icon_font, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Queue a picture (see ILI9341DrawPicture())
+ * @param[in] 	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	width: Picture width in pixels
+ * @param[in]  	height: Picture height in pixels
+ * @param[in]  	pic: Picture (not copied)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *pic);
+
+/**
+ * @brief  		Queue a compressed image (see ILI9341DrawImage())
+ * @param[in] 	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	image: Image (not copied)
+ * @retval 		false if the queue is full (the command is discarded)
+ */
+bool ILI9341AsyncImage(uint16_t x, uint16_t y, const ili9341_image_t *image);
+
+/**
+ * @brief  		Wait until all the commands queued before are drawn
+ * @note 		The task notifications of the caller aren't used (a semaphore is).
+ * 				Several tasks can wait, one after the other.
+ * @param[in]  	timeout_ms: Max time to wait
+ * @retval 		false if the timeout expired
+ */
+bool ILI9341AsyncWait(uint32_t timeout_ms);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ILI9341_ASYNC_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,96 @@
+#ifndef ILI9341_CHART_H_
+#define ILI9341_CHART_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup ILI9341_Chart ILI9341_Chart
+ ** @{ */
+
+/** \brief Real time strip chart for the ILI9341 display.
+ *
+ * Plots a stream of samples (for example the values read with analog_io_mcu)
+ * as a trace that moves along the screen, like an oscilloscope in roll mode or
+ * an ECG monitor. The chart uses the vertical scrolling of the ILI9341: each new
+ * sample only writes one line of pixels (background, grid and trace segment) over
+ * the oldest one and moves the scroll pointer, so the rest of the chart is never
+ * redrawn. Consecutive samples are written in a single window.
+ *
+ * In landscape orientations time goes from left to right and values from bottom to
+ * top; in portrait orientations time goes from top to bottom and values from left
+ * to right.
+ *
+ * @note The scroll axis is the 320 pixels side of the LCD, and scrolling moves whole
+ * lines of the LCD: the chart always uses the full 240 pixels side. Only the areas
+ * before and after the chart (along the scroll axis) can be drawn with the ILI9341*()
+ * functions.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ili9341.h"
+/*==================[macros]=================================================*/
+#define ILI9341_CHART_BATCH		16		/*!< Max samples written in one window */
+/*==================[typedef]================================================*/
+/**
+ * @brief Chart configuration
+ */
+typedef struct {
+	uint16_t start;			/*!< First line of the chart along the scroll axis (x in landscape, y in portrait) */
+	uint16_t length;		/*!< Lines of the chart (samples shown) */
+	uint16_t min;			/*!< Sample value at the bottom (left in portrait) */
+	uint16_t max;			/*!< Sample value at the top (right in portrait) */
+	uint16_t color;			/*!< Trace color (RGB565) */
+	uint16_t background;	/*!< Background color (RGB565) */
+	uint16_t grid_color;	/*!< Grid color (RGB565) */
+	uint16_t grid_step;		/*!< Pixels between grid lines, in both axes (0: no grid) */
+} ili9341_chart_config_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Chart initialization. The chart area is cleared.
+ * @note		Call it after ILI9341Init() and ILI9341Rotate().
+ * @param[in]  	config: Chart configuration
+ * @retval 		true if success, false if the chart doesn't fit in the LCD or there is no memory
+ */
+bool ILI9341ChartInit(const ili9341_chart_config_t *config);
+
+/**
+ * @brief  		Add samples to the chart. The oldest samples are scrolled out.
+ * @note		Nothing is done if the chart isn't initialized.
+ * @param[in]  	samples: Samples
+ * @param[in]  	n: Number of samples
+ * @retval 		None
+ */
+void ILI9341ChartPush(const uint16_t *samples, uint16_t n);
+
+/**
+ * @brief  		Clear the chart (samples, grid and scroll position)
+ * @note		Nothing is done if the chart isn't initialized.
+ * @retval 		None
+ */
+void ILI9341ChartClear(void);
+
+/**
+ * @brief  		Chart de-initialization. The scrolling of the LCD is disabled.
+ * @retval 		None
+ */
+void ILI9341ChartDeinit(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ILI9341_CHART_H_ */
+
+/*==================[end of file]============================================*/
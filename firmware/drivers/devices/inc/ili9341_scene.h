@@ -0,0 +1,188 @@
+#ifndef ILI9341_SCENE_H_
+#define ILI9341_SCENE_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup ILI9341_Scene ILI9341_Scene
+ ** @{ */
+
+/** \brief Retained mode renderer for the ILI9341 display.
+ *
+ * The screen is described by a list of items (rectangles, lines, circles, texts
+ * and pictures), drawn in the order they were added. Adding, moving, changing or
+ * removing an item doesn't draw anything, it only marks the area it covers as dirty.
+ * ILI9341SceneFlush() redraws only the dirty areas: each one is rendered in RAM by
+ * strips of a few rows (background and all the items that cover it) and sent
+ * to the display once, so overlapping items don't redraw the same pixels many times.
+ *
+ * @note A full framebuffer (150 KB) doesn't fit in RAM. Two strips of
+ * ILI9341_HEIGHT x strip_rows pixels are used, one is rendered while the other is sent.
+ *
+ * @note Areas of the screen drawn by the scene must not be drawn with the ILI9341*()
+ * functions (they would be overwritten in the next flush).
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ili9341.h"
+/*==================[macros]=================================================*/
+#define ILI9341_SCENE_MAX_ITEMS		32		/*!< Max items in the scene */
+#define ILI9341_SCENE_MAX_DIRTY		8		/*!< Max dirty areas (more areas are merged) */
+#define ILI9341_SCENE_STRIP_ROWS	16		/*!< Default rows of the render strips */
+#define ILI9341_SCENE_NO_ITEM		0xFF	/*!< Item returned when the scene is full */
+/*==================[typedef]================================================*/
+/**
+ * @brief Scene item handle
+ */
+typedef uint8_t ili9341_item_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Scene initialization. The whole screen is marked as dirty.
+ * @note		Call it after ILI9341Init().
+ * @param[in]  	background: Background color (RGB565)
+ * @param[in]  	strip_rows: Rows of the render strips (0: ILI9341_SCENE_STRIP_ROWS)
+ * @retval 		true if success, false if there is no memory
+ */
+bool ILI9341SceneInit(uint16_t background, uint16_t strip_rows);
+
+/**
+ * @brief  		Remove all the items and change the background color.
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+void ILI9341SceneClear(uint16_t background);
+
+/**
+ * @brief  		Add a rectangle to the scene
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Rectangle width
+ * @param[in]  	height: Rectangle height
+ * @param[in]  	color: Color (RGB565)
+ * @param[in]  	filled: true: filled rectangle, false: only the border
+ * @retval 		Item handle (ILI9341_SCENE_NO_ITEM if the scene is full)
+ */
+ili9341_item_t ILI9341SceneAddRect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint16_t color, bool filled);
+
+/**
+ * @brief  		Add a line to the scene
+ * @param[in]  	x0: X coordinate of start point
+ * @param[in]  	y0: Y coordinate of start point
+ * @param[in]  	x1: X coordinate of end point
+ * @param[in]  	y1: Y coordinate of end point
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		Item handle (ILI9341_SCENE_NO_ITEM if the scene is full)
+ */
+ili9341_item_t ILI9341SceneAddLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+/**
+ * @brief  		Add a circle to the scene
+ * @param[in]  	x: X coordinate of center
+ * @param[in]  	y: Y coordinate of center
+ * @param[in]  	r: Radius
+ * @param[in]  	color: Color (RGB565)
+ * @param[in]  	filled: true: filled circle, false: only the border
+ * @retval 		Item handle (ILI9341_SCENE_NO_ITEM if the scene is full)
+ */
+ili9341_item_t ILI9341SceneAddCircle(int16_t x, int16_t y, uint16_t r, uint16_t color, bool filled);
+
+/**
+ * @brief  		Add a single line text to the scene (transparent background)
+ * @note		The string is not copied, it must remain valid while the item exists.
+ * 				Call ILI9341SceneSetText() after changing it.
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	str: String
+ * @param[in]  	font: Font
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		Item handle (ILI9341_SCENE_NO_ITEM if the scene is full)
+ */
+ili9341_item_t ILI9341SceneAddText(int16_t x, int16_t y, const char *str, Font_t *font, uint16_t color);
+
+/**
+ * @brief  		Add a picture to the scene (same format as ILI9341DrawPicture())
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Picture width in pixels
+ * @param[in]  	height: Picture height in pixels
+ * @param[in]  	pic: Pointer to first byte of picture
+ * @retval 		Item handle (ILI9341_SCENE_NO_ITEM if the scene is full)
+ */
+ili9341_item_t ILI9341SceneAddPicture(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *pic);
+
+/**
+ * @brief  		Move an item
+ * @param[in]  	item: Item handle
+ * @param[in]  	dx: X displacement
+ * @param[in]  	dy: Y displacement
+ * @retval 		None
+ */
+void ILI9341SceneMove(ili9341_item_t item, int16_t dx, int16_t dy);
+
+/**
+ * @brief  		Change the color of an item (not used in pictures)
+ * @param[in]  	item: Item handle
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		None
+ */
+void ILI9341SceneSetColor(ili9341_item_t item, uint16_t color);
+
+/**
+ * @brief  		Change the string of a text item
+ * @param[in]  	item: Item handle
+ * @param[in]  	str: String (it is not copied)
+ * @retval 		None
+ */
+void ILI9341SceneSetText(ili9341_item_t item, const char *str);
+
+/**
+ * @brief  		Show or hide an item
+ * @param[in]  	item: Item handle
+ * @param[in]  	visible: true: show, false: hide
+ * @retval 		None
+ */
+void ILI9341SceneSetVisible(ili9341_item_t item, bool visible);
+
+/**
+ * @brief  		Remove an item from the scene
+ * @param[in]  	item: Item handle
+ * @retval 		None
+ */
+void ILI9341SceneRemove(ili9341_item_t item);
+
+/**
+ * @brief  		Mark an area of the screen to be redrawn in the next flush
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Area width
+ * @param[in]  	height: Area height
+ * @retval 		None
+ */
+void ILI9341SceneInvalidate(int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+/**
+ * @brief  		Redraw the dirty areas of the screen
+ * @note		Returns when the last strip is queued, it is sent in background.
+ * @retval 		Number of pixels sent to the display
+ */
+uint32_t ILI9341SceneFlush(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ILI9341_SCENE_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,113 @@
+#ifndef ILI9341_SPRITE_H_
+#define ILI9341_SPRITE_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup ILI9341_Sprite ILI9341_Sprite
+ ** @{ */
+
+/** \brief Moving sprites for the ILI9341 display.
+ *
+ * A sprite is an image (any ili9341_image_t format, RGB565 or palettized) that moves
+ * over what is already drawn on the LCD (gauge needles, markers, cursors), without
+ * redrawing the background. The pixels under the sprite are read from the LCD and
+ * saved in a RAM buffer of the size of the sprite; they are written back when the
+ * sprite moves away or is hidden.
+ *
+ * Each move reads the new area, draws the sprite in a single window (transparent
+ * pixels, equal to the color key, take the saved background) and restores only the
+ * part of the old area not covered by the new one, so the overlapping pixels go
+ * straight from the old to the new sprite, without flicker. The sprite is clipped to
+ * its viewport and to the LCD.
+ *
+ * @note The background is read back from the LCD (see ILI9341ReadArea()). Drawing under
+ * a visible sprite with other ILI9341*() functions is overwritten when the sprite
+ * moves: hide the sprite first.
+ *
+ * @note Sprites are drawn in the order they are moved: overlapping sprites must be hidden
+ * and shown again in reverse order.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ili9341.h"
+/*==================[macros]=================================================*/
+
+/*==================[typedef]================================================*/
+/**
+ * @brief Sprite (fields managed by the ILI9341Sprite*() functions)
+ */
+typedef struct {
+	const ili9341_image_t *image;	/*!< Actual frame */
+	uint32_t key;					/*!< Transparent color (RGB565), ILI9341_NO_KEY: none */
+	ili9341_area_t viewport;		/*!< Area where the sprite can be drawn */
+	bool use_viewport;				/*!< false: the entire LCD */
+	int16_t x;						/*!< Position of the top left corner */
+	int16_t y;
+	bool visible;					/*!< Drawn on the LCD */
+	ili9341_area_t area;			/*!< Visible area, while visible */
+	uint8_t *saved;					/*!< Background under the visible area */
+	uint8_t *spare;					/*!< Buffer for the background of the next position */
+	uint32_t size;					/*!< Bytes of each buffer */
+} ili9341_sprite_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Sprite initialization (hidden). Allocates two buffers of the size of the image.
+ * @param[out]  sprite: Sprite
+ * @param[in]  	image: Image of the sprite (not copied)
+ * @param[in]  	key: Transparent color (RGB565), ILI9341_NO_KEY: none
+ * @param[in]  	viewport: Area where the sprite can be drawn (NULL: the entire LCD)
+ * @retval 		true if success, false if the image is too big or there is no memory
+ */
+bool ILI9341SpriteInit(ili9341_sprite_t *sprite, const ili9341_image_t *image, uint32_t key, const ili9341_area_t *viewport);
+
+/**
+ * @brief  		Draw the sprite at a position (restoring the background at the previous one)
+ * @param[in]  	sprite: Sprite
+ * @param[in]  	x: X position of top left corner (can be out of the viewport)
+ * @param[in]  	y: Y position of top left corner (can be out of the viewport)
+ * @retval 		None
+ */
+void ILI9341SpriteMove(ili9341_sprite_t *sprite, int16_t x, int16_t y);
+
+/**
+ * @brief  		Change the image of the sprite (animation frames), in the same position
+ * @param[in]  	sprite: Sprite
+ * @param[in]  	image: New image, with the same width and height (not copied)
+ * @retval 		false if the image size is different
+ */
+bool ILI9341SpriteSetImage(ili9341_sprite_t *sprite, const ili9341_image_t *image);
+
+/**
+ * @brief  		Remove the sprite from the LCD (the background is restored)
+ * @param[in]  	sprite: Sprite
+ * @retval 		None
+ */
+void ILI9341SpriteHide(ili9341_sprite_t *sprite);
+
+/**
+ * @brief  		Free the buffers of the sprite (the LCD isn't changed)
+ * @param[in]  	sprite: Sprite
+ * @retval 		None
+ */
+void ILI9341SpriteDeinit(ili9341_sprite_t *sprite);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ILI9341_SPRITE_H_ */
+
+/*==================[end of file]============================================*/
@@ -26,18 +26,30 @@
  * | 	3A		 	| 	GPIO_18		|
  * | 	4A		 	| 	GPIO_9		|
  *
+ * @note Closed loop speed control: 
+ * Each motor can have a quadrature encoder (counted by a PCNT unit, in x4 mode). 
+ * The speed of the motors is measured, and a PID controller (fixed point) 
+ * sets the PWM duty cycle, running from a timer every 1 ms. Speed targets are set
+ * in RPM with L293SetRpm().
+ *
  * @section changelog
  *
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 17/05/2024 | Document creation		                         |
+ * | 19/10/2026 | Encoder input and closed loop speed control    |
  *
  */
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
-
+#include <stdbool.h>
+#include "gpio_mcu.h"
+#include "timer_mcu.h"
 /*==================[macros]=================================================*/
+#define L293_CTRL_HZ		1000	/*!< Speed control loop frequency (Hz) */
+#define L293_SPEED_WINDOW	16		/*!< Number of control periods used to measure the speed */
+#define L293_Q16_ONE		65536	/*!< 1.0 in Q16 */
 
 /*==================[typedef]================================================*/
 /**
@@ -49,6 +61,20 @@ typedef enum
 	MOTOR_2,  	/*!< Motor 2 */
 } l293_motor_t;
 
+/**
+ * @brief  PID gains (Q16 fixed point). 
+ * 
+ * Controller output is the duty cycle, as a fraction (-1.0 to 1.0) of full speed.
+ * Error is in RPM, so kp is in (duty / RPM), ki in (duty / (RPM.s)) and 
+ * kd in (duty.s / RPM).
+ */
+typedef struct
+{
+	int32_t kp;		/*!< Proportional gain (Q16) */
+	int32_t ki;		/*!< Integral gain (Q16) */
+	int32_t kd;		/*!< Derivative gain (Q16) */
+} l293_pid_gains_t;
+
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
@@ -70,6 +96,55 @@ uint8_t L293Init(void);
  */
 uint8_t L293SetSpeed(l293_motor_t motor, int8_t speed);
 
+/**
+ * @brief  		Initializes the encoder of a motor
+ * @param[in]  	motor: 	motor to be configured
+ * @param[in]  	enc_a: 	encoder channel A GPIO
+ * @param[in]  	enc_b: 	encoder channel B GPIO
+ * @param[in]  	counts_per_rev: encoder counts per output shaft revolution 
+ * 						(x4: 4 times the encoder lines, times the gear ratio)
+ * @retval 		1 when success, 0 when fails
+ */
+uint8_t L293EncoderInit(l293_motor_t motor, gpio_t enc_a, gpio_t enc_b, uint16_t counts_per_rev);
+
+/**
+ * @brief  		Starts the speed measurement and control loop
+ * @param[in]  	timer: 	timer used to run the loop (every 1/L293_CTRL_HZ s)
+ * @retval 		1 when success, 0 when fails
+ */
+uint8_t L293ControlInit(timer_mcu_t timer);
+
+/**
+ * @brief  		Sets the PID gains of a motor
+ * @param[in]  	motor: 	motor to be configured
+ * @param[in]  	gains: 	PID gains
+ * @retval 		1 when success, 0 when fails
+ */
+uint8_t L293SetGains(l293_motor_t motor, const l293_pid_gains_t *gains);
+
+/**
+ * @brief  		Sets the speed target of a motor, and enables the closed loop control.
+ * 				Closed loop control is disabled by L293SetSpeed().
+ * @param[in]  	motor: 	motor to be configured
+ * @param[in]  	rpm: 	speed target (negative: backward)
+ * @retval 		1 when success, 0 when fails
+ */
+uint8_t L293SetRpm(l293_motor_t motor, int16_t rpm);
+
+/**
+ * @brief  		Reads the speed of a motor
+ * @param[in]  	motor: 	motor
+ * @retval 		speed in RPM (negative: backward)
+ */
+int16_t L293GetRpm(l293_motor_t motor);
+
+/**
+ * @brief  		Reads the execution time of the control loop (both motors)
+ * @param[out]  last_ns: last execution time in ns
+ * @param[out]  max_ns: max execution time in ns since the last call
+ */
+void L293GetLoopTime(uint32_t *last_ns, uint32_t *max_ns);
+
 /**
  * @brief  	De-initializes L293 Driver
  * @param	None
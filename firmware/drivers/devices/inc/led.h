@@ -11,6 +11,9 @@
  *
  * @note ESP-EDU have 3 LEDs LED_1: green, LED_2: yellow, LED_3: red
  * 
+ * @note Blinking and dimming patterns can be assigned to each LED with LedSetPattern().
+ * All the patterns are evaluated from a single periodic timer (see LedsPatternInit()).
+ * 
  * @author Albano Peñalva
  *
  * @section changelog
@@ -18,13 +21,18 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Timer driven blink and dimming patterns         						|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include <stdbool.h>
 #include <stdint.h>
+#include "timer_mcu.h"
+#include "pwm_mcu.h"
 /*==================[macros]=================================================*/
+#define LED_TICK_MS		10		/*!< Pattern evaluation period (in ms) */
+#define LED_PWM_FREQ	1000	/*!< PWM frequency for dimmable LEDs (in Hz) */
 /**
  * @brief List of available LEDs in ESP-EDU board.
  */
@@ -36,6 +44,22 @@ typedef enum LEDs {
     LED_1 = (1 << 2), /**< Color green. Routed to GPIO_11 */
 } led_t; //cada uno tiene un valor en mascara binaria
 /*==================[typedef]================================================*/
+/**
+ * @brief LED pattern description.
+ * 
+ * Each period starts with the LED on for (period_ms * duty / 100) ms, and then off
+ * for the rest of the period. 
+ * 
+ * @note brightness and fade_ms are only used for LEDs attached to a PWM output 
+ * (see LedAttachPwm()), other LEDs just turn on at any brightness.
+ */
+typedef struct {
+	uint16_t period_ms;		/*!< Blink period in ms (0: steady on) */
+	uint8_t duty;			/*!< Time on in % of the period (0 to 100) */
+	uint16_t count;			/*!< Number of periods to run before turning off (0: forever) */
+	uint8_t brightness;		/*!< Brightness when on, in % (1 to 100, 0: 100%) */
+	uint16_t fade_ms;		/*!< Ramp time to reach brightness when turning on, and to reach 0 when turning off */
+} led_pattern_t;
 
 /*==================[external data declaration]==============================*/
 
@@ -86,6 +110,55 @@ uint8_t LedsOffAll(void);
  */
 uint8_t LedsMask(uint8_t mask);
 
+/**
+ * @brief Start the timer that evaluates the LEDs patterns.
+ * 
+ * @note One timer is used for all LEDs. LedsInit() must be called first.
+ * 
+ * @param timer Timer used as pattern tick (see timer_mcu.h)
+ * @return uint8_t 
+ */
+uint8_t LedsPatternInit(timer_mcu_t timer);
+
+/**
+ * @brief Drive a LED through a PWM output, so its brightness can be changed.
+ * 
+ * @param led LED number
+ * @param out PWM output to use (see pwm_mcu.h)
+ * @return uint8_t false: if invalid LED number 
+ */
+uint8_t LedAttachPwm(led_t led, pwm_out_t out);
+
+/**
+ * @brief Assign a pattern to one or more LEDs.
+ * 
+ * @note LedOn(), LedOff() and LedToggle() cancel the pattern of the LED.
+ * 
+ * @param leds LEDs mask (i.e. LED_1 | LED_3)
+ * @param pattern Pattern description (it is copied, so it can be a local variable)
+ * @return uint8_t 
+ */
+uint8_t LedSetPattern(uint8_t leds, const led_pattern_t *pattern);
+
+/**
+ * @brief Stop the pattern of one or more LEDs and turn them off.
+ * 
+ * LEDs attached to a PWM output fade from their actual brightness to 0 in the 
+ * fade_ms of their pattern (LedPatternRunning() is true until the ramp ends).
+ * 
+ * @param leds LEDs mask (i.e. LED_1 | LED_3)
+ * @return uint8_t 
+ */
+uint8_t LedStopPattern(uint8_t leds);
+
+/**
+ * @brief Check if a LED has a running pattern.
+ * 
+ * @param led LED number
+ * @return true if pattern is running, false if it has finished or was stopped
+ */
+bool LedPatternRunning(led_t led);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -0,0 +1,111 @@
+#ifndef NEOPIXEL_ANIM_H
+#define NEOPIXEL_ANIM_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup NeoPixel_Anim NeoPixel_Anim
+ ** @{ */
+
+/** \brief Animation engine for NeoPixel stripes.
+ *
+ * A task draws the frames of the running effect at a fixed frame rate, on the 
+ * stripe initialized with NeoPixelInit(). Effects are computed from the elapsed 
+ * time (not from the number of frames), so if the system is busy the late frames
+ * are dropped and the animation keeps its speed.
+ *
+ * @note While an animation is running, the application must not change the stripe.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "neopixel_stripe.h"
+/*==================[macros]=================================================*/
+#define NEOPIXEL_ANIM_FPS		50		/*!< Default frame rate */
+/*==================[typedef]================================================*/
+/**
+ * @brief Available effects
+ */
+typedef enum {
+	NEOPIXEL_ANIM_RAINBOW,		/*!< Moving rainbow (uses sat, val and reps) */
+	NEOPIXEL_ANIM_CHASE,		/*!< One of every "width" pixels on with color, the others with color2, moving */
+	NEOPIXEL_ANIM_FADE,			/*!< All pixels fade from color to color2 and back */
+	NEOPIXEL_ANIM_BREATHE,		/*!< All pixels with color, brightness going up and down */
+	NEOPIXEL_ANIM_SCANNER		/*!< A dot of color (with a tail of "width" pixels) goes back and forth */
+} neopixel_anim_effect_t;
+
+/**
+ * @brief Animation description
+ */
+typedef struct {
+	neopixel_anim_effect_t effect;	/*!< Effect */
+	uint32_t period_ms;				/*!< Duration of one cycle of the effect */
+	neopixel_color_t color;			/*!< Main color */
+	neopixel_color_t color2;		/*!< Second color (chase background, fade target) */
+	uint8_t width;					/*!< Chase spacing / scanner tail length (in pixels) */
+	uint8_t sat;					/*!< Rainbow saturation */
+	uint8_t val;					/*!< Rainbow value */
+	uint8_t reps;					/*!< Rainbow repetitions along the stripe */
+} neopixel_anim_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Animation engine initialization. Creates the animation task.
+ * 
+ * @note Call it after NeoPixelInit().
+ * 
+ * @param fps Frame rate (0: NEOPIXEL_ANIM_FPS)
+ * @return true if success
+ */
+bool NeoPixelAnimInit(uint16_t fps);
+
+/**
+ * @brief Start an animation (replaces the running one).
+ * 
+ * @param anim Animation description (it is copied)
+ */
+void NeoPixelAnimStart(const neopixel_anim_t *anim);
+
+/**
+ * @brief Stop the running animation. The stripe keeps the last frame.
+ */
+void NeoPixelAnimStop(void);
+
+/**
+ * @brief Check if an animation is running.
+ * 
+ * @return true if running
+ */
+bool NeoPixelAnimRunning(void);
+
+/**
+ * @brief Frames drawn in the last second.
+ * 
+ * @return uint16_t Achieved frame rate
+ */
+uint16_t NeoPixelAnimGetFps(void);
+
+/**
+ * @brief Frames dropped since the animation started.
+ * 
+ * @return uint32_t Dropped frames
+ */
+uint32_t NeoPixelAnimGetDropped(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif
+
+/*==================[end of file]============================================*/
@@ -9,9 +9,19 @@
 
 /** \brief NeoPixel driver for the ESP-EDU Board.
  *
- * @note This driver can handle only one stripe of NeoPixel at a time
- * (with no limits in the qty of leds in the array).
+ * @note Each stripe is handled through a neopixel_stripe_t, with its own colors,
+ * brightness, white balance and transactions. A stripe can have its own RMT channel 
+ * (NeoPixelStripeInit(), 2 in ESP32-C6), or be part of a group of up to 8 stripes 
+ * (NeoPixelGroupInit()) that are transmitted at the same time, so refreshing the group
+ * takes the time of the longest stripe.
  * 
+ * @note NeoPixel*() functions (without Stripe) handle a default stripe initialized 
+ * with NeoPixelInit().
+ * 
+ * @note Changes are transmitted only for the pixels that changed. Several changes 
+ * can be grouped between NeoPixelBegin() and NeoPixelCommit() to transmit them
+ * together, and transmissions can be limited to a max frame rate (NeoPixelSetMaxFps()).
+ *
  * @note ESP-EDU have one individual NeoPixel connected to GPIO_8, that can be used with this driver.
  * 
  * @author Albano Peñalva
@@ -21,6 +31,11 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Stripe updated in background (RMT)									|
+ * | 19/10/2026 | Transactions, dirty tracking and frame rate limit						|
+ * | 19/10/2026 | Brightness, white balance and gamma lookup tables						|
+ * | 19/10/2026 | Batch HSV gradient													|
+ * | 19/10/2026 | Stripe handles, groups of stripes transmitted in parallel				|
  * 
  **/
 
@@ -33,6 +48,8 @@
 #define BUILT_IN_RGB_LED_PIN          GPIO_8        /*> ESP32-C6-DevKitC-1 NeoPixel it's connected at GPIO_8 */
 #define BUILT_IN_RGB_LED_LENGTH       1             /*> ESP32-C6-DevKitC-1 NeoPixel has one pixel */
 
+#define NEOPIXEL_GROUP_MAX_STRIPES    8             /*> Max stripes in a group */
+
 #define NEOPIXEL_COLOR_WHITE          0x00FFFFFF  /*> Color white */
 #define NEOPIXEL_COLOR_RED            0x00FF0000  /*> Color red */
 #define NEOPIXEL_COLOR_ORANGE         0x00FF7D00  /*> Color orange */
@@ -69,12 +86,139 @@
  * 0x000000FF -> Blue
  */
 typedef uint32_t neopixel_color_t;
+
+/**
+ * @brief NeoPixel stripe handle
+ */
+typedef struct neopixel_stripe neopixel_stripe_t;
+
+/**
+ * @brief Group of stripes transmitted in parallel
+ */
+typedef struct neopixel_group neopixel_group_t;
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
 
 /**
- * @brief NeoPixel array initialization.
+ * @brief Stripe initialization, using its own RMT channel.
+ * 
+ * @param pin           GPIO number where NeoPixel data pin (DIN) will be connected
+ * @param len           Number of NeoPixels in the stripe
+ * @param color_array   Array of len length, to store each NeoPixel color
+ * @return neopixel_stripe_t* Stripe handle, NULL if there is no free channel or memory
+ */
+neopixel_stripe_t *NeoPixelStripeInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array);
+
+/**
+ * @brief Releases a stripe initialized with NeoPixelStripeInit().
+ * 
+ * @param stripe Stripe handle
+ */
+void NeoPixelStripeDeinit(neopixel_stripe_t *stripe);
+
+/**
+ * @brief Group of stripes initialization. All the stripes are transmitted at once.
+ * 
+ * @note Max length of each stripe is WS2812B_BUS_MAX_LEDS (see ws2812b.h).
+ * 
+ * @param pins          GPIO number of each stripe
+ * @param lens          Number of NeoPixels of each stripe
+ * @param color_arrays  Color array of each stripe
+ * @param n_stripes     Number of stripes (up to NEOPIXEL_GROUP_MAX_STRIPES)
+ * @return neopixel_group_t* Group handle, NULL if error
+ */
+neopixel_group_t *NeoPixelGroupInit(const gpio_t *pins, const uint16_t *lens, neopixel_color_t *const *color_arrays, uint8_t n_stripes);
+
+/**
+ * @brief Handle of a stripe of a group.
+ * 
+ * @note Changes in a stripe of the group transmit all the stripes. Use NeoPixelGroupBegin()
+ * and NeoPixelGroupCommit() to update several stripes in one transmission.
+ * 
+ * @param group Group handle
+ * @param index Stripe number (in the order given to NeoPixelGroupInit())
+ * @return neopixel_stripe_t* Stripe handle
+ */
+neopixel_stripe_t *NeoPixelGroupStripe(neopixel_group_t *group, uint8_t index);
+
+/**
+ * @brief Start a transaction in all the stripes of a group.
+ * 
+ * @param group Group handle
+ */
+void NeoPixelGroupBegin(neopixel_group_t *group);
+
+/**
+ * @brief End a group transaction, transmitting the changes of all the stripes at once.
+ * 
+ * @param group Group handle
+ */
+void NeoPixelGroupCommit(neopixel_group_t *group);
+
+/**
+ * @brief Start a transaction in a stripe (see NeoPixelBegin()).
+ */
+void NeoPixelStripeBegin(neopixel_stripe_t *stripe);
+
+/**
+ * @brief End a transaction in a stripe (see NeoPixelCommit()).
+ */
+void NeoPixelStripeCommit(neopixel_stripe_t *stripe);
+
+/**
+ * @brief Limit the frame rate of a stripe (see NeoPixelSetMaxFps()).
+ * @note A group is transmitted at the rate of its slowest stripe.
+ */
+void NeoPixelStripeSetMaxFps(neopixel_stripe_t *stripe, uint16_t fps);
+
+/**
+ * @brief Turn off all NeoPixels of a stripe (see NeoPixelAllOff()).
+ */
+void NeoPixelStripeAllOff(neopixel_stripe_t *stripe);
+
+/**
+ * @brief Change all NeoPixels of a stripe to the same color (see NeoPixelAllColor()).
+ */
+void NeoPixelStripeAllColor(neopixel_stripe_t *stripe, neopixel_color_t color);
+
+/**
+ * @brief Set an individual pixel of a stripe to a color (see NeoPixelSetPixel()).
+ */
+void NeoPixelStripeSetPixel(neopixel_stripe_t *stripe, uint16_t pixel, neopixel_color_t color);
+
+/**
+ * @brief Set all NeoPixels of a stripe from an array (see NeoPixelSetArray()).
+ */
+void NeoPixelStripeSetArray(neopixel_stripe_t *stripe, neopixel_color_t *color_array);
+
+/**
+ * @brief Shift the NeoPixel colors of a stripe 1 position (see NeoPixelShift()).
+ */
+void NeoPixelStripeShift(neopixel_stripe_t *stripe, bool upwards);
+
+/**
+ * @brief Change the brightness of a stripe (see NeoPixelBrightness()).
+ */
+void NeoPixelStripeBrightness(neopixel_stripe_t *stripe, uint8_t bright);
+
+/**
+ * @brief Change the white balance of a stripe (see NeoPixelWhiteBalance()).
+ */
+void NeoPixelStripeWhiteBalance(neopixel_stripe_t *stripe, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief Set all NeoPixels of a stripe with a gradient of colors (see NeoPixelRainbow()).
+ */
+void NeoPixelStripeRainbow(neopixel_stripe_t *stripe, uint16_t first_hue, uint8_t sat, uint8_t val, uint8_t reps);
+
+/**
+ * @brief Number of NeoPixels of a stripe.
+ */
+uint16_t NeoPixelStripeGetLength(neopixel_stripe_t *stripe);
+
+/**
+ * @brief NeoPixel array initialization (default stripe).
  * 
  * @param pin           GPIO number where NeoPixel data pin (DIN) will be connected
  * @param len           Number of NeoPixels in the stripe
@@ -82,9 +226,33 @@ typedef uint32_t neopixel_color_t;
  */
 void NeoPixelInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array);
 
+/**
+ * @brief Start a transaction. 
+ * 
+ * Changes made until NeoPixelCommit() are stored, but not transmitted.
+ * Transactions can be nested.
+ */
+void NeoPixelBegin(void);
+
+/**
+ * @brief End a transaction, transmitting all the changes made since NeoPixelBegin()
+ * (when the outermost transaction ends).
+ */
+void NeoPixelCommit(void);
+
+/**
+ * @brief Limit the frame rate of the stripe.
+ * 
+ * @note A transmission that comes too early waits the remaining time.
+ * 
+ * @param fps Max transmissions per second (0: no limit)
+ */
+void NeoPixelSetMaxFps(uint16_t fps);
+
 /**
  * @brief Turn off all NeoPixels.
  * 
+ * @note Pixel colors are kept, and sent again in the next update.
  */
 void NeoPixelAllOff(void);
 
@@ -105,6 +273,9 @@ void NeoPixelSetPixel(uint16_t pixel, neopixel_color_t color);
 
 /**
  * @brief Set all NeoPixels in the array with the color stored in an array.
+ * @note Colors are copied in the stripe color array (see NeoPixelInit()). The
+ * array given to NeoPixelInit() can be passed too, after changing it directly:
+ * then all the pixels are sent again.
  * 
  * @param color_array Array of 24 bits color
  */
@@ -126,6 +297,15 @@ void NeoPixelShift(bool upwards);
  */
 void NeoPixelBrightness(uint8_t bright);
 
+/**
+ * @brief Change NeoPixel white balance (scale of each color component).
+ * @note: by default all the components are at maximum (255)
+ * @param red Red scale (0 to 255).
+ * @param green Green scale (0 to 255).
+ * @param blue Blue scale (0 to 255).
+ */
+void NeoPixelWhiteBalance(uint8_t red, uint8_t green, uint8_t blue);
+
 /**
  * @brief Convert 3 individual color levels (R, G, B) to a 24bits color data.
  * 
@@ -147,6 +327,24 @@ neopixel_color_t NeoPixelRgb2Color(uint8_t red, uint8_t green, uint8_t blue);
  */
 neopixel_color_t NeoPixelHSV2Color(uint16_t hue, uint8_t sat, uint8_t val);
 
+/**
+ * @brief Fill an array with a gradient of colors (HSV color model).
+ * @note Saturation and value are the same for all the colors, only hue changes.
+ * @param colors Array to fill
+ * @param len Number of colors
+ * @param first_hue Hue of the first color
+ * @param hue_step_q8 Hue increment between colors (in 1/256 of hue units)
+ * @param sat Color saturation
+ * @param val Color value or brightness
+ */
+void NeoPixelHSVGradient(neopixel_color_t *colors, uint16_t len, uint16_t first_hue, uint32_t hue_step_q8, uint8_t sat, uint8_t val);
+
+/**
+ * @brief Number of NeoPixels in the stripe.
+ * @return uint16_t Stripe length
+ */
+uint16_t NeoPixelGetLength(void);
+
 /**
  * @brief Set all NeoPixels with a gradient of colors. 
  * 
@@ -9,7 +9,12 @@
 
 /** \brief Servo driver for the ESP-EDU Board.
  *
- * @note This driver can handle up to 4 SG90 microservos.
+ * @note This driver can handle up to 6 SG90 microservos.
+ * 
+ * @note Servo position can be set as an angle or as a pulse width in us (1 us 
+ * resolution). Servos can also follow a trajectory (linear, trapezoidal or S-curve 
+ * speed profile), updated by a timer once every PWM period. All the servos are 
+ * updated in the same PWM period.
  * 
  * @author Albano Peñalva
  *
@@ -18,6 +23,7 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/01/2024 | Document creation		                         						|
+ * | 19/10/2026 | Pulse width in us, up to 6 servos and motion profiles					|
  * 
  **/
 
@@ -25,36 +31,100 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "gpio_mcu.h"
+#include "timer_mcu.h"
 /*==================[macros]=================================================*/
-
+#define SERVO_PULSE_MIN_US		500		/*!< Pulse width for -90 degrees */
+#define SERVO_PULSE_MAX_US		2500	/*!< Pulse width for 90 degrees */
+#define SERVO_PULSE_CENTER_US	1500	/*!< Pulse width for 0 degrees */
+#define SERVO_TICK_MS			20		/*!< Trajectory update period (one PWM period) */
 /*==================[typedef]================================================*/
 typedef enum servo_out {
 	SERVO_0,    /**< uses PWM_0 out */
 	SERVO_1,	/**< uses PWM_1 out */
 	SERVO_2,	/**< uses PWM_2 out */
-	SERVO_3		/**< uses PWM_3 out */
+	SERVO_3,	/**< uses PWM_3 out */
+	SERVO_4,	/**< uses PWM_4 out */
+	SERVO_5		/**< uses PWM_5 out */
 } servo_out_t;
+
+/**
+ * @brief Speed profile of a servo trajectory
+ */
+typedef enum servo_profile {
+	SERVO_PROFILE_LINEAR,		/**< Constant speed */
+	SERVO_PROFILE_TRAPEZOIDAL,	/**< Constant acceleration during the first and last quarter of the movement */
+	SERVO_PROFILE_SCURVE		/**< Smooth acceleration (no steps in acceleration) */
+} servo_profile_t;
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
 /**
  * @brief Servo initialization.
  * 
+ * @note The servo starts in the center position (0 degrees).
+ * 
  * @param servo Servo number.
  * @param gpio  GPIO number to connect servo's PWM pin.
- * @return uint8_t 
+ * @return uint8_t 0: success, 1: error
  */
 uint8_t ServoInit(servo_out_t servo, gpio_t gpio);
 
 /**
  * @brief Change servo angle.
  * 
+ * @note Stops the trajectory of the servo, if any.
+ * 
  * @param servo Servo number
  * @param ang Servo angle (from -90 to 90 degrees)
- * @return uint8_t 
  */
 void ServoMove(servo_out_t servo, int8_t ang);
 
+/**
+ * @brief Change servo pulse width.
+ * 
+ * @note Stops the trajectory of the servo, if any.
+ * 
+ * @param servo Servo number
+ * @param pulse_us Pulse width in us (from SERVO_PULSE_MIN_US to SERVO_PULSE_MAX_US)
+ */
+void ServoSetPulseUs(servo_out_t servo, uint16_t pulse_us);
+
+/**
+ * @brief Read servo pulse width.
+ * 
+ * @param servo Servo number
+ * @return uint16_t Actual pulse width in us
+ */
+uint16_t ServoGetPulseUs(servo_out_t servo);
+
+/**
+ * @brief Trajectories initialization. 
+ * 
+ * @param timer Timer used to update the trajectories (every SERVO_TICK_MS)
+ */
+void ServoMotionInit(timer_mcu_t timer);
+
+/**
+ * @brief Move a servo from its actual position to a target position.
+ * 
+ * @note The function returns immediately, the servo is moved from the timer
+ * callback (ServoMotionInit() must be called first).
+ * 
+ * @param servo Servo number
+ * @param target_us Target pulse width in us
+ * @param duration_ms Movement duration in ms
+ * @param profile Speed profile
+ */
+void ServoMoveTo(servo_out_t servo, uint16_t target_us, uint32_t duration_ms, servo_profile_t profile);
+
+/**
+ * @brief Check if a servo is following a trajectory.
+ * 
+ * @param servo Servo number
+ * @return true if the servo is moving
+ */
+bool ServoIsMoving(servo_out_t servo);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -62,4 +132,3 @@ void ServoMove(servo_out_t servo, int8_t ang);
 #endif /* #ifndef SERVO_SG90_H */
 
 /*==================[end of file]============================================*/
-
@@ -12,6 +12,16 @@
  *
  * @note For handling NeoPixels arrays use "neopixel_stripe.h".
  * 
+ * @note Bits are generated by the RMT peripheral: a buffer of GRB bytes is 
+ * transmitted in background (without CPU intervention) followed by the reset 
+ * code, and a callback can be called at the end of the transmission.
+ * 
+ * @note Several stripes can be driven at the same time:
+ * - Each ws2812b_channel_t uses one RMT TX channel (2 in ESP32-C6). ws2812bInit() 
+ * functions use a default channel.
+ * - A ws2812b_bus_t uses the parallel IO peripheral to transmit up to 8 stripes 
+ * (one per GPIO) at once, so the transmission takes the time of the longest stripe.
+ * 
  * @author Albano Peñalva
  *
  * @section changelog
@@ -19,15 +29,21 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | RMT transmitter, asynchronous buffer transmission						|
+ * | 19/10/2026 | Several channels, parallel bus for up to 8 stripes					|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "sdkconfig.h"
 #include "esp_err.h"
 #include "gpio_mcu.h"
 /*==================[macros]=================================================*/
+#define WS2812B_BUS_MAX_LANES	8		/*!< Max stripes in a parallel bus */
+#define WS2812B_BUS_MAX_LEDS	440		/*!< Max leds per stripe in a parallel bus (PARLIO frame length) */
 
 /*==================[typedef]================================================*/
 /**
@@ -40,6 +56,25 @@ typedef struct rgb_led{
 	 uint8_t blue;  		// Blue
 } rgb_led_t;
 
+/**
+ * @brief Transmission end callback. 
+ * 
+ * @note It is called from an interrupt, so it must be short and can't block.
+ * 
+ * @param arg Argument passed to ws2812bTransmit()
+ */
+typedef void (*ws2812b_done_cb_t)(void *arg);
+
+/**
+ * @brief Single stripe transmitter (RMT channel)
+ */
+typedef struct ws2812b_channel ws2812b_channel_t;
+
+/**
+ * @brief Parallel stripes transmitter (parallel IO)
+ */
+typedef struct ws2812b_bus ws2812b_bus_t;
+
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
@@ -53,6 +88,9 @@ void ws2812bInit(gpio_t pin);
 /**
  * @brief Send color information to NeoPixel.
  * 
+ * @note Colors are stored (with gamma correction) and transmitted together by 
+ * ws2812bSendRet().
+ * 
  * @param data NeoPixel color
  */
 void ws2812bSend(rgb_led_t led_color);
@@ -60,9 +98,111 @@ void ws2812bSend(rgb_led_t led_color);
 /**
  * @brief Send a ret command to NeoPixel.
  * 
+ * @note Transmits the colors stored by ws2812bSend() and waits the end of the transmission.
  */
 void ws2812bSendRet(void);
 
+/**
+ * @brief Transmits a buffer of bytes (G, R, B for each NeoPixel) followed by the reset code.
+ * 
+ * @note The function returns immediately. The buffer must not be modified until 
+ * the transmission ends.
+ * 
+ * @param grb Buffer with the colors (no gamma correction is applied)
+ * @param len Buffer length in bytes
+ * @param done_cb Function called at the end of the transmission (NULL: none)
+ * @param arg Argument for done_cb
+ * @return true if the transmission started
+ */
+bool ws2812bTransmit(const uint8_t *grb, size_t len, ws2812b_done_cb_t done_cb, void *arg);
+
+/**
+ * @brief Waits the end of the transmissions in progress.
+ * 
+ * @param timeout_ms Max waiting time in ms (-1: wait forever)
+ * @return true if all the transmissions ended
+ */
+bool ws2812bWaitDone(int32_t timeout_ms);
+
+/**
+ * @brief Single stripe transmitter initialization.
+ * 
+ * @param pin GPIO number where NeoPixel data pin (DIN) will be connected
+ * @return ws2812b_channel_t* Channel, NULL if there is no free RMT channel
+ */
+ws2812b_channel_t *ws2812bChannelInit(gpio_t pin);
+
+/**
+ * @brief Releases a single stripe transmitter (waits the end of the transmissions).
+ * 
+ * @param ch Channel
+ */
+void ws2812bChannelDeinit(ws2812b_channel_t *ch);
+
+/**
+ * @brief Transmits a buffer of bytes through a channel (see ws2812bTransmit()).
+ * 
+ * @param ch Channel
+ * @param grb Buffer with the colors
+ * @param len Buffer length in bytes
+ * @param done_cb Function called at the end of the transmission (NULL: none)
+ * @param arg Argument for done_cb
+ * @return true if the transmission started
+ */
+bool ws2812bChannelTransmit(ws2812b_channel_t *ch, const uint8_t *grb, size_t len, ws2812b_done_cb_t done_cb, void *arg);
+
+/**
+ * @brief Waits the end of the transmissions of a channel.
+ * 
+ * @param ch Channel
+ * @param timeout_ms Max waiting time in ms (-1: wait forever)
+ * @return true if all the transmissions ended
+ */
+bool ws2812bChannelWaitDone(ws2812b_channel_t *ch, int32_t timeout_ms);
+
+/**
+ * @brief Parallel stripes transmitter initialization.
+ * 
+ * @param pins GPIO of each stripe (lane)
+ * @param lanes Number of stripes (1 to WS2812B_BUS_MAX_LANES)
+ * @param max_leds Length of the longest stripe (up to WS2812B_BUS_MAX_LEDS)
+ * @return ws2812b_bus_t* Bus, NULL if error
+ */
+ws2812b_bus_t *ws2812bBusInit(const gpio_t *pins, uint8_t lanes, uint16_t max_leds);
+
+/**
+ * @brief Transmits the colors of all the stripes of a bus at once.
+ * 
+ * @note The buffers are copied (interleaved) before the function returns, so
+ * they can be modified during the transmission.
+ * 
+ * @param bus Bus
+ * @param grb Buffer with the colors of each lane (G, R, B bytes for each led)
+ * @param leds Number of leds of each lane
+ * @param done_cb Function called at the end of the transmission (NULL: none)
+ * @param arg Argument for done_cb
+ * @return true if the transmission started
+ */
+bool ws2812bBusTransmit(ws2812b_bus_t *bus, const uint8_t *const *grb, const uint16_t *leds, 
+                        ws2812b_done_cb_t done_cb, void *arg);
+
+/**
+ * @brief Waits the end of the transmission of a bus.
+ * 
+ * @param bus Bus
+ * @param timeout_ms Max waiting time in ms (-1: wait forever)
+ * @return true if the transmission ended
+ */
+bool ws2812bBusWaitDone(ws2812b_bus_t *bus, int32_t timeout_ms);
+
+/**
+ * @brief Gamma correction of a color component.
+ * 
+ * @param component Linear color level
+ * @return uint8_t Level to send to the NeoPixel
+ */
+uint8_t ws2812bGammaCorrection(uint8_t component);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
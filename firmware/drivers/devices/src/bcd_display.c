@@ -0,0 +1,164 @@
+/**
+ * @file bcd_display.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "bcd_display.h"
+#include <stddef.h>
+#include "soc/gpio_reg.h"
+#include "esp_attr.h"
+/*==================[macros and definitions]=================================*/
+#define US_PER_SEC		1000000		/*!< Timer resolution is 1us */
+#define BCD_BLANK		0x0F		/*!< BCD code shown as blank by the decoders */
+#define BASE			10			/*!< Decimal base */
+/*==================[internal data declaration]==============================*/
+static uint8_t n_digits;						/*!< Number of digits in the display */
+static uint32_t pins_mask;						/*!< Mask with all the display lines */
+static uint32_t bcd_mask[BCD_DISPLAY_BITS];		/*!< Port mask of each BCD line */
+static uint32_t digit_mask[BCD_DISPLAY_MAX_DIGITS];	/*!< Port mask of each digit selection line */
+/**
+ * @brief Port masks to set in each scan slot. One frame is shown while the other is written.
+ */
+static volatile uint32_t slot_mask[2][BCD_DISPLAY_MAX_DIGITS];
+static volatile uint8_t front = 0;				/*!< Frame being scanned */
+static volatile bool back_ready = false;		/*!< A new frame is ready in the back buffer */
+static uint8_t scan_digit = 0;					/*!< Digit shown in the current slot */
+static uint32_t actual_value = 0;				/*!< Value shown in the display */
+static timer_mcu_t scan_timer;					/*!< Timer used to scan the display */
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/**
+ * @brief Timer callback. Shows one digit per call.
+ *
+ * @note Clears the lines that must be low (including the previous digit selection)
+ * and then sets the BCD code and selection line of the current digit.
+ */
+static void IRAM_ATTR BcdDisplayScan(void *param){
+	uint32_t set;
+	/* New frames are only taken at the start of a frame, so a digit never shows a mix of values */
+	if((scan_digit == 0) && back_ready){
+		front ^= 1;
+		back_ready = false;
+	}
+	set = slot_mask[front][scan_digit];
+	REG_WRITE(GPIO_OUT_W1TC_REG, pins_mask & ~set);
+	REG_WRITE(GPIO_OUT_W1TS_REG, set);
+	if(++scan_digit >= n_digits){
+		scan_digit = 0;
+	}
+}
+
+/**
+ * @brief Precompute the port masks of a frame in the back buffer and mark it as ready.
+ */
+static void BcdDisplayLoad(const uint8_t *bcd){
+	uint8_t back;
+	uint32_t set;
+	/* While back_ready is false the scan won't swap buffers, so the back buffer is free to write */
+	back_ready = false;
+	back = front ^ 1;
+	for(uint8_t i = 0; i < n_digits; i++){
+		set = digit_mask[i];
+		for(uint8_t b = 0; b < BCD_DISPLAY_BITS; b++){
+			if(bcd[i] & (1 << b)){
+				set |= bcd_mask[b];
+			}
+		}
+		slot_mask[back][i] = set;
+	}
+	back_ready = true;
+}
+/*==================[external functions definition]==========================*/
+bool BcdDisplayInit(bcd_display_config_t *config){
+	uint16_t refresh_hz;
+	if((config->digits == 0) || (config->digits > BCD_DISPLAY_MAX_DIGITS)){
+		return false;
+	}
+	n_digits = config->digits;
+	scan_timer = config->timer;
+	refresh_hz = (config->refresh_hz > 0) ? config->refresh_hz : BCD_DISPLAY_REFRESH_HZ;
+
+	pins_mask = 0;
+	for(uint8_t b = 0; b < BCD_DISPLAY_BITS; b++){
+		GPIOInit(config->bcd_map[b].pin, GPIO_OUTPUT);
+		bcd_mask[b] = 1UL << config->bcd_map[b].pin;
+		pins_mask |= bcd_mask[b];
+	}
+	for(uint8_t i = 0; i < n_digits; i++){
+		GPIOInit(config->digit_map[i].pin, GPIO_OUTPUT);
+		digit_mask[i] = 1UL << config->digit_map[i].pin;
+		pins_mask |= digit_mask[i];
+	}
+	/* Both buffers start blank */
+	for(uint8_t i = 0; i < n_digits; i++){
+		slot_mask[0][i] = digit_mask[i] | bcd_mask[0] | bcd_mask[1] | bcd_mask[2] | bcd_mask[3];
+		slot_mask[1][i] = slot_mask[0][i];
+	}
+	front = 0;
+	back_ready = false;
+	scan_digit = 0;
+	BcdDisplayWrite(0);
+
+	/* One time slot per digit */
+	timer_config_t timer_scan = {
+		.timer = scan_timer,
+		.period = US_PER_SEC / ((uint32_t)refresh_hz * n_digits),
+		.func_p = BcdDisplayScan,
+		.param_p = NULL
+	};
+	TimerInit(&timer_scan);
+	TimerStart(scan_timer);
+	return true;
+}
+
+bool BcdDisplayWrite(uint32_t value){
+	uint8_t bcd[BCD_DISPLAY_MAX_DIGITS];
+	uint32_t aux = value;
+	for(int8_t i = n_digits - 1; i >= 0; i--){
+		bcd[i] = aux % BASE;
+		aux /= BASE;
+	}
+	/* Value doesn't fit in the display */
+	if(aux != 0){
+		return false;
+	}
+	actual_value = value;
+	BcdDisplayLoad(bcd);
+	return true;
+}
+
+void BcdDisplayWriteDigits(const uint8_t *bcd){
+	BcdDisplayLoad(bcd);
+}
+
+uint32_t BcdDisplayRead(void){
+	return actual_value;
+}
+
+void BcdDisplayOff(void){
+	uint8_t bcd[BCD_DISPLAY_MAX_DIGITS];
+	for(uint8_t i = 0; i < n_digits; i++){
+		bcd[i] = BCD_BLANK;
+	}
+	BcdDisplayLoad(bcd);
+}
+
+bool BcdDisplayDeInit(void){
+	TimerDeInit(scan_timer);
+	REG_WRITE(GPIO_OUT_W1TC_REG, pins_mask);
+	return true;
+}
+
+/*==================[end of file]============================================*/
@@ -13,12 +13,53 @@
 #include "buzzer.h"
 #include "delay_mcu.h"
 #include "pwm_mcu.h"
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
 #define PWM_BUZZER      PWM_3
 #define PWM_DC          50
 #define OCTAVE_OFFSET   0
+#define OCTAVE_MIN      4           /*!< Octaves in the notes table */
+#define OCTAVE_MAX      7
+#define FREQ_MAX        NOTE_DS8    /*!< Highest note, PWM resolution is kept for lower notes */
+#define US_PER_MS       1000
+#define START_US        100         /*!< Delay to start playing a song */
+#define PLAYER_STACK    2048
+#define PLAYER_PRIORITY (configMAX_PRIORITIES - 2)  /*!< Above application tasks, so notes start on time */
 /*==================[internal data declaration]==============================*/
+/**
+ * @brief Song in the player
+ */
+typedef struct {
+    const buzzer_note_t *notes;     /*!< Song notes */
+    uint16_t length;                /*!< Number of notes */
+} buzzer_song_t;
+
+/**
+ * @brief RTTTL parser state
+ */
+typedef struct {
+    const char *p;                  /*!< Next note in the string */
+    uint8_t default_dur;
+    uint8_t default_oct;
+    long wholenote;                 /*!< Whole note duration (ms) */
+} rtttl_parser_t;
 
+static timer_mcu_t player_timer;
+static QueueHandle_t song_queue = NULL;                 /*!< Songs waiting to be played */
+static buzzer_song_t song = {NULL, 0};                  /*!< Song being played */
+static uint16_t song_idx = 0;                           /*!< Next note of the song */
+static buzzer_song_t alarm = {NULL, 0};                 /*!< Alarm (preempts songs) */
+static volatile bool alarm_pending = false;             /*!< New alarm to start */
+static volatile bool alarm_active = false;              /*!< Alarm being played */
+static volatile bool alarm_repeat = false;              /*!< Alarm repeats until stopped */
+static volatile bool playing = false;                   /*!< Player timer running */
+static volatile uint16_t tone_freq = 0;                 /*!< Note to play (0: silence), set by the timer callback */
+static TaskHandle_t player_task_handle = NULL;
+static portMUX_TYPE player_spinlock = portMUX_INITIALIZER_UNLOCKED;
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
@@ -32,48 +73,21 @@ uint16_t notes[] = {
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
-bool isDigit(char c){
+static bool isDigit(char c){
     if((c >= '0') && (c <= '9')){
         return true;
     }else{
         return false;
     }
 }
-/*==================[external functions definition]==========================*/
-void BuzzerInit(gpio_t pin){
-    PWMInit(PWM_BUZZER, pin, NOTE_C4);
-    PWMSetDutyCycle(PWM_BUZZER, PWM_DC);
-    PWMOff(PWM_BUZZER);
-}
-
-void BuzzerOn(void){
-    PWMOn(PWM_BUZZER);
-}
-
-void BuzzerOff(void){
-    PWMOff(PWM_BUZZER);
-}
-
-void BuzzerSetFrec(uint16_t freq){
-    PWMSetFreq(PWM_BUZZER, freq);
-}
-
-void BuzzerPlayTone(uint16_t freq, uint16_t duration){
-	PWMSetFreq(PWM_BUZZER, freq);
-	PWMOn(PWM_BUZZER);
-	DelayMs(duration);
-	PWMOff(PWM_BUZZER);
-}
-
-void BuzzerPlayRtttl(const char * rtttl_melody){
-    uint8_t default_dur = 4;
-    uint8_t default_oct = 6;
+/**
+ * @brief Reads the RTTTL header (name, default duration, octave and BPM)
+ */
+static void RtttlBegin(rtttl_parser_t *parser, const char * rtttl_melody){
     int bpm = 63;
     int num;
-    long wholenote;
-    long duration;
-    uint8_t note;
-    uint8_t scale;
+    parser->default_dur = 4;
+    parser->default_oct = 6;
 
     /* find the start (skip name, etc) */
     while(*rtttl_melody != ':') rtttl_melody++; // ignore name
@@ -87,7 +101,7 @@ void BuzzerPlayRtttl(const char * rtttl_melody){
         while(isDigit(*rtttl_melody)){
         num = (num * 10) + (*rtttl_melody++ - '0');
         }
-        if(num > 0) default_dur = num;
+        if(num > 0) parser->default_dur = num;
         rtttl_melody++;     // skip comma
     }
 
@@ -96,7 +110,7 @@ void BuzzerPlayRtttl(const char * rtttl_melody){
         rtttl_melody++; 
         rtttl_melody++;     // skip "o="
         num = *rtttl_melody++ - '0';
-        if(num >= 3 && num <=7) default_oct = num;
+        if(num >= 3 && num <=7) parser->default_oct = num;
         rtttl_melody++;     // skip comma
     }
 
@@ -113,81 +127,315 @@ void BuzzerPlayRtttl(const char * rtttl_melody){
     }
 
     /* BPM usually expresses the number of quarter notes per minute */
-    wholenote = (60 * 1000L / bpm) * 4;  // this is the time for whole note (in milliseconds)
+    parser->wholenote = (60 * 1000L / bpm) * 4;  // this is the time for whole note (in milliseconds)
+    parser->p = rtttl_melody;
+}
 
-    /* now begin note loop */
-    while(*rtttl_melody){
-        /* first, get note duration, if available */
-        num = 0;
-        while(isDigit(*rtttl_melody)){
-            num = (num * 10) + (*rtttl_melody++ - '0');
-        }
-        if(num){
-            duration = wholenote / num;
-        }else{
-            duration = wholenote / default_dur;  // we will need to check if we are a dotted note after
-        } 
-        /* now get the note */
+/**
+ * @brief Reads the next RTTTL note. Returns false at the end of the melody.
+ */
+static bool RtttlNext(rtttl_parser_t *parser, buzzer_note_t *out){
+    const char *rtttl_melody = parser->p;
+    int num;
+    long duration;
+    uint8_t note;
+    uint8_t scale;
+    uint16_t index;
+
+    if(*rtttl_melody == 0){
+        return false;
+    }
+    /* first, get note duration, if available */
+    num = 0;
+    while(isDigit(*rtttl_melody)){
+        num = (num * 10) + (*rtttl_melody++ - '0');
+    }
+    if(num){
+        duration = parser->wholenote / num;
+    }else{
+        duration = parser->wholenote / parser->default_dur;  // we will need to check if we are a dotted note after
+    } 
+    /* now get the note */
+    note = 0;
+    switch(*rtttl_melody){
+    case 'c':
+        note = 1;
+        break;
+    case 'd':
+        note = 3;
+        break;
+    case 'e':
+        note = 5;
+        break;
+    case 'f':
+        note = 6;
+        break;
+    case 'g':
+        note = 8;
+        break;
+    case 'a':
+        note = 10;
+        break;
+    case 'b':
+        note = 12;
+        break;
+    case 'p':
+    default:
         note = 0;
-        switch(*rtttl_melody){
-        case 'c':
-            note = 1;
-            break;
-        case 'd':
-            note = 3;
-            break;
-        case 'e':
-            note = 5;
-            break;
-        case 'f':
-            note = 6;
-            break;
-        case 'g':
-            note = 8;
-            break;
-        case 'a':
-            note = 10;
-            break;
-        case 'b':
-            note = 12;
-            break;
-        case 'p':
-        default:
-            note = 0;
-        }
+    }
+    rtttl_melody++;
+    /* now, get optional '#' sharp */
+    if(*rtttl_melody == '#'){
+        note++;
         rtttl_melody++;
-        /* now, get optional '#' sharp */
-        if(*rtttl_melody == '#'){
-            note++;
-            rtttl_melody++;
-        }
-        /* now, get optional '.' dotted note */
-        if(*rtttl_melody == '.'){
-            duration += duration/2;
-            rtttl_melody++;
-        }
-        /* now, get scale */
-        if(isDigit(*rtttl_melody)){
-            scale = *rtttl_melody - '0';
-            rtttl_melody++;
-        }else{
-            scale = default_oct;
+    }
+    /* now, get optional '.' dotted note */
+    if(*rtttl_melody == '.'){
+        duration += duration/2;
+        rtttl_melody++;
+    }
+    /* now, get scale */
+    if(isDigit(*rtttl_melody)){
+        scale = *rtttl_melody - '0';
+        rtttl_melody++;
+    }else{
+        scale = parser->default_oct;
+    }
+    scale += OCTAVE_OFFSET;
+    /* Octaves out of the notes table are played in the nearest one */
+    if(scale < OCTAVE_MIN){
+        scale = OCTAVE_MIN;
+    } else if(scale > OCTAVE_MAX){
+        scale = OCTAVE_MAX;
+    }
+
+    if(*rtttl_melody == ','){
+        rtttl_melody++; // skip comma for next note (or we may be at the end)
+    }
+    parser->p = rtttl_melody;
+
+    /* B# of the highest octave is out of the table too */
+    index = (scale - OCTAVE_MIN) * 12 + note;
+    if(index >= sizeof(notes) / sizeof(notes[0])){
+        index = sizeof(notes) / sizeof(notes[0]) - 1;
+    }
+    out->freq = note ? notes[index] : 0;
+    out->duration = duration;
+    return true;
+}
+
+/**
+ * @brief Timer callback. Selects the next note, and programs the timer to be called 
+ * again at the end of the note. The PWM frequency isn't changed here (ledc_set_freq()
+ * isn't ISR safe): the player task does it.
+ */
+static void IRAM_ATTR BuzzerPlayerNext(void *param){
+    buzzer_note_t note;
+    BaseType_t woken = pdFALSE;
+    portENTER_CRITICAL_ISR(&player_spinlock);
+    if(alarm_pending){
+        /* Alarm preempts the song being played */
+        alarm_pending = false;
+        alarm_active = true;
+        song = alarm;
+        song_idx = 0;
+    }
+    if(song_idx >= song.length){
+        if(alarm_active && alarm_repeat){
+            song_idx = 0;
+        } else{
+            alarm_active = false;
+            if(xQueueReceiveFromISR(song_queue, &song, &woken) == pdTRUE){
+                song_idx = 0;
+            } else{
+                /* Nothing else to play */
+                song.length = 0;
+                song_idx = 0;
+                playing = false;
+                tone_freq = 0;
+                TimerStop(player_timer);
+                portEXIT_CRITICAL_ISR(&player_spinlock);
+                vTaskNotifyGiveFromISR(player_task_handle, &woken);
+                portYIELD_FROM_ISR(woken);
+                return;
+            }
         }
-        scale += OCTAVE_OFFSET;
+    }
+    note = song.notes[song_idx++];
+    tone_freq = note.freq;
+    portEXIT_CRITICAL_ISR(&player_spinlock);
+    TimerUpdatePeriod(player_timer, (note.duration > 0 ? note.duration : 1) * US_PER_MS);
+    vTaskNotifyGiveFromISR(player_task_handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
 
-        if(*rtttl_melody == ','){
-            rtttl_melody++; // skip comma for next note (or we may be at the end)
+/**
+ * @brief Player task. Plays the note selected by the timer callback.
+ */
+static void BuzzerPlayerTask(void *param){
+    uint16_t freq;
+    while(true){
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        portENTER_CRITICAL(&player_spinlock);
+        freq = tone_freq;
+        portEXIT_CRITICAL(&player_spinlock);
+        if(freq){
+            PWMSetFreq(PWM_BUZZER, freq);
+            PWMOn(PWM_BUZZER);
+        } else{
+            PWMOff(PWM_BUZZER);
         }
+    }
+}
+
+/**
+ * @brief Starts the player timer, if it is not running
+ */
+static void BuzzerPlayerStart(void){
+    portENTER_CRITICAL(&player_spinlock);
+    if(!playing){
+        playing = true;
+        TimerReset(player_timer);
+        TimerUpdatePeriod(player_timer, START_US);
+        TimerStart(player_timer);
+    }
+    portEXIT_CRITICAL(&player_spinlock);
+}
+/*==================[external functions definition]==========================*/
+void BuzzerInit(gpio_t pin){
+    /* Initialized at the highest note, so changing the note doesn't change PWM resolution */
+    PWMInit(PWM_BUZZER, pin, FREQ_MAX);
+    PWMSetDutyCycle(PWM_BUZZER, PWM_DC);
+    PWMOff(PWM_BUZZER);
+}
+
+void BuzzerOn(void){
+    PWMOn(PWM_BUZZER);
+}
+
+void BuzzerOff(void){
+    PWMOff(PWM_BUZZER);
+}
+
+void BuzzerSetFrec(uint16_t freq){
+    PWMSetFreq(PWM_BUZZER, freq);
+}
+
+void BuzzerPlayTone(uint16_t freq, uint16_t duration){
+	PWMSetFreq(PWM_BUZZER, freq);
+	PWMOn(PWM_BUZZER);
+	DelayMs(duration);
+	PWMOff(PWM_BUZZER);
+}
+
+void BuzzerPlayRtttl(const char * rtttl_melody){
+    rtttl_parser_t parser;
+    buzzer_note_t note;
+
+    RtttlBegin(&parser, rtttl_melody);
+    while(RtttlNext(&parser, &note)){
         /* now play the note */
-        if(note){
-            BuzzerPlayTone(notes[(scale - 4) * 12 + note], duration);
+        if(note.freq){
+            BuzzerPlayTone(note.freq, note.duration);
         }
         else{
-            DelayMs(duration);
+            DelayMs(note.duration);
         }
     }
 }
 
+uint16_t BuzzerParseRtttl(const char * rtttl_melody, buzzer_note_t *notes, uint16_t max_notes){
+    rtttl_parser_t parser;
+    uint16_t n = 0;
+
+    RtttlBegin(&parser, rtttl_melody);
+    while((n < max_notes) && RtttlNext(&parser, &notes[n])){
+        n++;
+    }
+    return n;
+}
+
+void BuzzerPlayerInit(timer_mcu_t timer){
+    player_timer = timer;
+    if(song_queue == NULL){
+        song_queue = xQueueCreate(BUZZER_QUEUE_LEN, sizeof(buzzer_song_t));
+    }
+    if(player_task_handle == NULL){
+        xTaskCreate(&BuzzerPlayerTask, "BUZZER_PLAYER", PLAYER_STACK, NULL, PLAYER_PRIORITY, &player_task_handle);
+    }
+    timer_config_t timer_player = {
+        .timer = timer,
+        .period = START_US,
+        .func_p = BuzzerPlayerNext,
+        .param_p = NULL
+    };
+    TimerInit(&timer_player);
+}
+
+bool BuzzerPlay(const buzzer_note_t *notes, uint16_t length){
+    buzzer_song_t new_song = {notes, length};
+    if((song_queue == NULL) || (length == 0)){
+        return false;
+    }
+    if(xQueueSend(song_queue, &new_song, 0) != pdTRUE){
+        return false;
+    }
+    BuzzerPlayerStart();
+    return true;
+}
+
+void BuzzerAlarm(const buzzer_note_t *notes, uint16_t length, bool repeat){
+    if((song_queue == NULL) || (length == 0)){
+        return;
+    }
+    portENTER_CRITICAL(&player_spinlock);
+    alarm.notes = notes;
+    alarm.length = length;
+    alarm_repeat = repeat;
+    alarm_pending = true;
+    if(playing){
+        /* Interrupt the actual note */
+        TimerReset(player_timer);
+        TimerUpdatePeriod(player_timer, START_US);
+    }
+    portEXIT_CRITICAL(&player_spinlock);
+    BuzzerPlayerStart();
+}
+
+void BuzzerStopAlarm(void){
+    portENTER_CRITICAL(&player_spinlock);
+    alarm_pending = false;
+    if(alarm_active){
+        /* Alarm ends at the end of the actual note */
+        alarm_repeat = false;
+        song_idx = song.length;
+    }
+    portEXIT_CRITICAL(&player_spinlock);
+}
+
+void BuzzerStop(void){
+    if(song_queue == NULL){
+        return;
+    }
+    portENTER_CRITICAL(&player_spinlock);
+    xQueueReset(song_queue);
+    alarm_pending = false;
+    alarm_active = false;
+    song.length = 0;
+    song_idx = 0;
+    tone_freq = 0;
+    if(playing){
+        playing = false;
+        TimerStop(player_timer);
+    }
+    portEXIT_CRITICAL(&player_spinlock);
+    PWMOff(PWM_BUZZER);
+}
+
+bool BuzzerIsPlaying(void){
+    return playing;
+}
+
 void BuzzerDeinit(void){
     
 }
@@ -0,0 +1,259 @@
+/**
+ * @file buzzer_audio.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief 
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include "buzzer_audio.h"
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "driver/sdm.h"
+/*==================[macros and definitions]=================================*/
+#define SDM_SAMPLE_RATE		(10 * 1000 * 1000)	/*!< SDM modulation rate, far above audio frequencies */
+#define US_PER_SEC			1000000
+#define VOLUME_MAX			100
+#define DECODE_STACK		2048
+#define DECODE_PRIORITY		(configMAX_PRIORITIES - 2)	/*!< Above application tasks, so buffers are ready in time */
+#define STEP_INDEX_MAX		88
+/*==================[internal data declaration]==============================*/
+/**
+ * @brief IMA-ADPCM decoder state
+ */
+typedef struct {
+	const uint8_t *data;		/*!< Next byte */
+	uint32_t remaining;			/*!< Samples to decode */
+	int32_t predictor;
+	int8_t step_index;
+	bool high_nibble;			/*!< Next sample is in the high nibble */
+} adpcm_state_t;
+
+static sdm_channel_handle_t sdm_chan = NULL;
+static timer_mcu_t audio_timer;
+static TaskHandle_t decode_task_handle = NULL;
+static adpcm_state_t decoder;
+static int8_t buffer[2][BUZZER_AUDIO_BUF_LEN];		/*!< Samples (SDM pulse density). One buffer is played while the other is decoded */
+static volatile uint16_t buffer_len[2];				/*!< Samples in each buffer (0: empty) */
+static volatile uint8_t front = 0;					/*!< Buffer being played */
+static volatile uint16_t sample_idx = 0;			/*!< Next sample of the front buffer */
+static volatile bool playing = false;
+static uint16_t volume_q8 = 1 << 8;					/*!< Volume, 1.0 = 256 */
+/* The timer counts us: sample periods alternate between period_us and period_us + 1 */
+static uint32_t sample_rate;
+static uint32_t period_us;							/*!< Sample period, rounded down */
+static uint32_t period_frac;						/*!< Remainder of US_PER_SEC / sample_rate */
+static uint32_t period_err;							/*!< Accumulated remainder (us * sample_rate) */
+static bool period_long;							/*!< Timer period is period_us + 1 */
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const int8_t index_table[16] = {
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const uint16_t step_table[STEP_INDEX_MAX + 1] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+	253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+	1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+	3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+	12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/**
+ * @brief Decodes one IMA-ADPCM sample
+ */
+static int16_t AdpcmDecode(adpcm_state_t *s){
+	uint8_t nibble;
+	int32_t step, diff;
+	if(s->high_nibble){
+		nibble = *s->data++ >> 4;
+	} else{
+		nibble = *s->data & 0x0F;
+	}
+	s->high_nibble = !s->high_nibble;
+
+	step = step_table[s->step_index];
+	diff = step >> 3;
+	if(nibble & 4) diff += step;
+	if(nibble & 2) diff += step >> 1;
+	if(nibble & 1) diff += step >> 2;
+	s->predictor += (nibble & 8) ? -diff : diff;
+	if(s->predictor > INT16_MAX){
+		s->predictor = INT16_MAX;
+	} else if(s->predictor < INT16_MIN){
+		s->predictor = INT16_MIN;
+	}
+	s->step_index += index_table[nibble];
+	if(s->step_index < 0){
+		s->step_index = 0;
+	} else if(s->step_index > STEP_INDEX_MAX){
+		s->step_index = STEP_INDEX_MAX;
+	}
+	return (int16_t)s->predictor;
+}
+
+/**
+ * @brief Decodes samples into a buffer, converted to SDM pulse density
+ */
+static uint16_t BuzzerAudioFill(int8_t *buf){
+	uint16_t n = 0;
+	int32_t sample;
+	while((n < BUZZER_AUDIO_BUF_LEN) && (decoder.remaining > 0)){
+		sample = ((int32_t)AdpcmDecode(&decoder) * volume_q8) >> 16;
+		buf[n++] = (int8_t)sample;
+		decoder.remaining--;
+	}
+	return n;
+}
+
+/**
+ * @brief Timer callback. Outputs one sample, and swaps buffers when the front one is finished.
+ */
+static void IRAM_ATTR BuzzerAudioSample(void *param){
+	BaseType_t woken = pdFALSE;
+	bool long_period;
+	if(!playing){
+		return;
+	}
+	/* Next period: one us longer each time the truncated fractions add up to 1 us */
+	period_err += period_frac;
+	long_period = (period_err >= sample_rate);
+	if(long_period){
+		period_err -= sample_rate;
+	}
+	if(long_period != period_long){
+		period_long = long_period;
+		TimerUpdatePeriod(audio_timer, period_us + long_period);
+	}
+	if(sample_idx >= buffer_len[front]){
+		buffer_len[front] = 0;
+		if(buffer_len[front ^ 1] == 0){
+			/* Nothing decoded: end of the sound (or decoder late) */
+			if(decoder.remaining == 0){
+				playing = false;
+				sdm_channel_set_pulse_density(sdm_chan, 0);
+				TimerStop(audio_timer);
+			}
+			return;
+		}
+		front ^= 1;
+		sample_idx = 0;
+		/* Decode the next samples in the buffer just played */
+		vTaskNotifyGiveFromISR(decode_task_handle, &woken);
+	}
+	sdm_channel_set_pulse_density(sdm_chan, buffer[front][sample_idx++]);
+	portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief Decoder task. Fills the back buffer each time the ISR swaps buffers.
+ */
+static void BuzzerAudioDecodeTask(void *pvParameter){
+	uint8_t back;
+	while(true){
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		back = front ^ 1;
+		if(playing && (buffer_len[back] == 0)){
+			buffer_len[back] = BuzzerAudioFill(buffer[back]);
+		}
+	}
+}
+/*==================[external functions definition]==========================*/
+bool BuzzerAudioInit(gpio_t pin, timer_mcu_t timer){
+	sdm_config_t sdm_config = {
+		.gpio_num = pin,
+		.clk_src = SDM_CLK_SRC_DEFAULT,
+		.sample_rate_hz = SDM_SAMPLE_RATE,
+	};
+	if(sdm_new_channel(&sdm_config, &sdm_chan) != ESP_OK){
+		return false;
+	}
+	sdm_channel_enable(sdm_chan);
+	sdm_channel_set_pulse_density(sdm_chan, 0);
+
+	audio_timer = timer;
+	timer_config_t timer_audio = {
+		.timer = timer,
+		.period = US_PER_SEC / BUZZER_AUDIO_RATE_MIN,
+		.func_p = BuzzerAudioSample,
+		.param_p = NULL
+	};
+	TimerInit(&timer_audio);
+	if(decode_task_handle == NULL){
+		xTaskCreate(&BuzzerAudioDecodeTask, "BUZZER_AUDIO", DECODE_STACK, NULL, DECODE_PRIORITY, &decode_task_handle);
+	}
+	return true;
+}
+
+bool BuzzerAudioPlay(const buzzer_audio_t *sound){
+	if((sdm_chan == NULL) || (sound->sample_rate < BUZZER_AUDIO_RATE_MIN) || 
+		(sound->sample_rate > BUZZER_AUDIO_RATE_MAX)){
+		return false;
+	}
+	BuzzerAudioStop();
+	decoder.data = sound->data;
+	decoder.remaining = sound->samples;
+	decoder.predictor = sound->predictor;
+	decoder.step_index = (sound->step_index > STEP_INDEX_MAX) ? STEP_INDEX_MAX : sound->step_index;
+	decoder.high_nibble = false;
+	/* Both buffers are decoded before starting */
+	buffer_len[0] = BuzzerAudioFill(buffer[0]);
+	buffer_len[1] = BuzzerAudioFill(buffer[1]);
+	front = 0;
+	sample_idx = 0;
+	sample_rate = sound->sample_rate;
+	period_us = US_PER_SEC / sample_rate;
+	period_frac = US_PER_SEC % sample_rate;
+	period_err = 0;
+	period_long = false;
+	playing = true;
+	TimerUpdatePeriod(audio_timer, period_us);
+	TimerReset(audio_timer);
+	TimerStart(audio_timer);
+	return true;
+}
+
+void BuzzerAudioStop(void){
+	if(playing){
+		playing = false;
+		TimerStop(audio_timer);
+	}
+	if(sdm_chan != NULL){
+		sdm_channel_set_pulse_density(sdm_chan, 0);
+	}
+	buffer_len[0] = 0;
+	buffer_len[1] = 0;
+}
+
+bool BuzzerAudioIsPlaying(void){
+	return playing;
+}
+
+void BuzzerAudioSetVolume(uint8_t volume){
+	if(volume > VOLUME_MAX){
+		volume = VOLUME_MAX;
+	}
+	volume_q8 = ((uint16_t)volume << 8) / VOLUME_MAX;
+}
+
+void BuzzerAudioDeinit(void){
+	BuzzerAudioStop();
+	if(sdm_chan != NULL){
+		sdm_channel_disable(sdm_chan);
+		sdm_del_channel(sdm_chan);
+		sdm_chan = NULL;
+	}
+}
+
+/*==================[end of file]============================================*/
@@ -15,14 +15,28 @@
 #include "spi_mcu.h"
 #include "gpio_mcu.h"
 #include "delay_mcu.h"
+#include "soc/gpio_reg.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
 #define NULL 0
 
 #define SPI_BR 20000000				/*!< Frequency of sck for SPI communication */
+#define SPI_READ_BR 6000000			/*!< Frequency of sck for memory reads (read cycle of 150 ns, 6.6 MHz max) */
 #define MAX_PIXEL 320*240*2			/*!< Maximum number of bytes to write on LCD */
 #define MSK_BIT16 0x8000			/*!< 16th bit mask */
 #define MSK_BIT8 0x80				/*!< 8th bit mask */
-#define MAX_VALUE_SIZE 256			/*!< Maximum length of a data array to prevent excessive use of memory */
+#define CHUNK_SIZE 4096				/*!< Bytes of each DMA buffer (pixels are sent in chunks, while the next one is filled) */
+#define DC_CMD ((void *)0)			/*!< SPI transaction user value: DC low (command) */
+#define DC_DATA ((void *)1)			/*!< SPI transaction user value: DC high (parameters or data) */
+#define FIRST_CHAR ' '				/*!< First character in the fonts */
+#define LAST_CHAR '~'				/*!< Last character in the fonts */
+#define CHAR_SPACE 1				/*!< Pixels between characters in a string */
+#define AA_LEVELS_MAX 16			/*!< Coverage levels of anti-aliased fonts (4 bpp) */
+#define READ_CHUNK_PIXELS ((CHUNK_SIZE - 1) / 3)	/*!< Pixels read in each transaction (dummy byte + 3 bytes/pixel) */
+#define LINE_MAX_CHARS 64			/*!< Max characters drawn in one address window */
+#define GLYPH_CACHE_SLOTS 24		/*!< Max glyphs in the cache */
+#define GLYPH_CACHE_BYTES 16384		/*!< Max memory used by the cached glyphs */
+#define GLYPH_MAX_BYTES 2048		/*!< Bigger glyphs are not cached (fonts up to 30 pixels height) */
 #define LEFT -1						/*!< Horizontal grow direction */
 #define RIGHT 1						/*!< Horizontal grow direction */
 #define DOWN 1						/*!< Vertical grow direction */
@@ -40,8 +54,12 @@
 #define COLUMN_ADDR_SET		0x2A 	/*!< Define columns of frame memory where MCU can access */
 #define PAGE_ADDR_SET		0x2B 	/*!< Define rows of frame memory where MCU can access */
 #define MEM_WRITE			0x2C 	/*!< Transfer data from MCU to frame memory */
+#define MEM_READ			0x2E 	/*!< Transfer data from frame memory to MCU */
+#define VERT_SCROLL_DEF		0x33 	/*!< Defines the vertical scrolling area of the display */
 #define MEM_ACC_CTRL		0x36 	/*!< Defines read/write scanning direction of frame memory */
+#define VERT_SCROLL_START	0x37 	/*!< Line of frame memory shown at the top of the vertical scrolling area */
 #define PIXEL_FORMAT_SET	0x3A 	/*!< Sets the pixel format for the RGB image data used by the interface */
+#define MEM_READ_CONT		0x3E 	/*!< Continue the transfer from frame memory where the previous read stopped */
 #define WRITE_DISP_BRIGHT	0x51 	/*!< Adjust the brightness value of the display */
 #define WRITE_CTRL_DISP		0x53 	/*!< Control display brightness */
 #define RGB_INTERFACE		0xB0 	/*!< Sets the operation status of the display interface */
@@ -82,6 +100,41 @@ typedef struct {
     uint32_t databytes; 	/*!< Number of bytes of data to transmit */
     uint8_t *data;			/*!< Pointer to data or parameters array */
 } lcd_cmd_t;
+
+/**
+ * @brief Glyph expanded to RGB565 (wire byte order) for a foreground/background pair
+ */
+typedef struct {
+	const Font_t *font;		/*!< Font (NULL: free slot) */
+	char c;					/*!< Character */
+	uint16_t foreground;	/*!< Foreground color */
+	uint16_t background;	/*!< Background color */
+	uint8_t *pixels;		/*!< Pixels, row by row */
+	uint16_t size;			/*!< Bytes */
+	uint32_t last_use;		/*!< Line counter of the last use (LRU) */
+} glyph_t;
+
+/**
+ * @brief Decoder of an anti-aliased character (see aa_font_t)
+ */
+typedef struct {
+	const uint8_t *data;	/*!< Next byte */
+	uint8_t bits;			/*!< Levels not read of the current byte (packed), level of the run (RLE) */
+	uint16_t left;			/*!< Pixels left in the current byte (packed) or run (RLE) */
+} aa_decoder_t;
+
+/**
+ * @brief Decoder of an image row by row (see ili9341_image_t)
+ */
+typedef struct {
+	const ili9341_image_t *image;
+	const uint8_t *src;		/*!< Next byte */
+	const uint8_t *end;		/*!< End of the image data */
+	uint8_t count;			/*!< Pixels left of the current RLE packet */
+	bool run;				/*!< Current RLE packet is a run */
+	uint16_t color;			/*!< Color of the current run */
+	uint8_t shift;			/*!< Bits not read of the current byte (palette) */
+} image_decoder_t;
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
@@ -103,6 +156,61 @@ void WriteLCD(lcd_cmd_t * data);
  */
 void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
+/**
+ * @brief  		Start a stream of pixels to the area defined with SetCursorPosition()
+ * @retval 		None
+ */
+void PixelStreamBegin(void);
+
+/**
+ * @brief  		Add a pixel to the stream. Full chunks are queued to be sent by DMA.
+ * @param[in]	color: color
+ * @retval 		None
+ */
+static inline void PixelStreamPut(uint16_t color);
+
+/**
+ * @brief  		Add pixels (already in wire byte order) to the stream
+ * @param[in]	src: pixels
+ * @param[in]	n: bytes
+ * @retval 		None
+ */
+void PixelStreamWrite(const uint8_t *src, uint32_t n);
+
+/**
+ * @brief  		Queue the remaining pixels of the stream
+ * @retval 		None
+ */
+void PixelStreamEnd(void);
+
+/**
+ * @brief  		Draw a line of characters in a single address window
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	str: Characters
+ * @param[in] 	len: Number of characters
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	spacing: Background columns between characters
+ * @param[in]  	foreground: Color for chars (RGB565)
+ * @param[in]  	background: Color for background (RGB565)
+ * @note		Rows below the bottom of the LCD aren't drawn.
+ * @retval 		false if the line doesn't fit in the width of the LCD (nothing is drawn)
+ */
+bool DrawTextLine(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint8_t spacing, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Draw a line of characters of an anti-aliased font in a single address window
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	str: Characters
+ * @param[in] 	len: Number of characters
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	foreground: Color for chars (RGB565)
+ * @param[in]  	background: Color for background (RGB565)
+ * @retval 		X position after the last character drawn
+ */
+uint16_t DrawAATextLine(uint16_t x, uint16_t y, const char *str, uint16_t len, const aa_font_t *font, uint16_t foreground, uint16_t background);
+
 /**
  * @brief  		Fill an srea of LCD with a determined color
  * @param[in]  	x1: Start column
@@ -114,6 +222,30 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
  */
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
+/**
+ * @brief  		Fill a rectangle clipped to the LCD (coordinates in any order, may be out of the LCD)
+ * @param[in]  	x0: Start column
+ * @param[in]  	y0: Start row
+ * @param[in]  	x1: End column
+ * @param[in]  	y1: End row
+ * @param[in]	color: color
+ * @retval 		None
+ */
+void FillClipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+/**
+ * @brief  		Draw the runs of pixels of a circle with the same row (and its 8 symmetric runs)
+ * @param[in]  	x0: X coordinate of center
+ * @param[in]  	y0: Y coordinate of center
+ * @param[in]  	xa: First x of the run (relative to center)
+ * @param[in]  	xb: Last x of the run (relative to center)
+ * @param[in]  	y: Row of the run (relative to center)
+ * @param[in]  	filled: true: filled circle, false: only the border
+ * @param[in]	color: color
+ * @retval 		None
+ */
+void CircleRun(int16_t x0, int16_t y0, int16_t xa, int16_t xb, int16_t y, bool filled, uint16_t color);
+
 /*==================[internal data definition]===============================*/
 /**
  * @brief Initial LCD configuration parameters
@@ -180,10 +312,20 @@ spi_mcu_config_t spi_conf = {
 	.bitrate = SPI_BR, 
 	.transfer_mode = SPI_POLLING, 
 	.func_p = NULL,
-	.param_p = NULL };
+	.param_p = NULL,
+	.pre_func_p = NULL,
+	.post_func_p = NULL };
 
 static spi_dev_t ili9341_spi;				/*!< uC SPI port */
 static gpio_t ili9341_dc, ili9341_rst;		/*!< uC GPIO ports to use as CS, DC and RST */
+static uint32_t dc_mask;					/*!< Port mask of the DC line */
+static uint8_t *dma_buf[2] = {NULL, NULL};	/*!< Chunks of pixels: one is filled while the other is sent */
+static uint8_t dma_idx = 0;					/*!< Buffer used by the last queued chunk */
+static uint8_t *stream_buf;					/*!< Chunk being filled */
+static uint32_t stream_len;					/*!< Bytes in the chunk being filled */
+static glyph_t glyph_cache[GLYPH_CACHE_SLOTS];	/*!< Cache of expanded glyphs */
+static uint32_t glyph_cache_bytes = 0;		/*!< Memory used by the cached glyphs */
+static uint32_t glyph_clock = 0;			/*!< Lines drawn (LRU time) */
 
 static orientation_properties_t lcd_orientation = {
 		ILI9341_WIDTH,
@@ -193,19 +335,81 @@ static orientation_properties_t lcd_orientation = {
 
 /*==================[internal functions definition]==========================*/
 
+/**
+ * @brief SPI pre-transaction callback (ISR): sets DC line according to the transaction
+ */
+static void IRAM_ATTR SpiPreTransfer(void *user){
+	if(user == DC_DATA){
+		REG_WRITE(GPIO_OUT_W1TS_REG, dc_mask);
+	} else{
+		REG_WRITE(GPIO_OUT_W1TC_REG, dc_mask);
+	}
+}
+
+/**
+ * @brief Next DMA buffer to fill. Chunks alternate buffers, so only the last
+ * queued chunk (that uses the other buffer) can be in flight.
+ */
+static uint8_t *NextDmaBuffer(void){
+	dma_idx ^= 1;
+	SpiQueueWait(ili9341_spi, 1);
+	return dma_buf[dma_idx];
+}
+
 void WriteLCD(lcd_cmd_t * data){
-	SpiInit(&spi_conf);
 	/* If command is NULL don't send command */
 	if (data->cmd != NULL){
 		/* Send command */
-		GPIOOff(ili9341_dc);
-		SpiWrite(ili9341_spi, &data->cmd, 1);
+		SpiPollingWrite(ili9341_spi, &data->cmd, 1, DC_CMD);
 	}
 	/* If there are parameters or data to send */
 	if (data->databytes != NULL){
 		/* Send parameters or data */
-		GPIOOn(ili9341_dc);
-		SpiWrite(ili9341_spi, data->data, data->databytes);
+		SpiPollingWrite(ili9341_spi, data->data, data->databytes, DC_DATA);
+	}
+}
+
+void PixelStreamBegin(void){
+	/* Start writing LCD memory */
+	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
+	WriteLCD(&lcd_write);
+	stream_buf = NextDmaBuffer();
+	stream_len = 0;
+}
+
+static inline void PixelStreamPut(uint16_t color){
+	if (stream_len == CHUNK_SIZE){
+		SpiQueueWrite(ili9341_spi, stream_buf, stream_len, DC_DATA);
+		stream_buf = NextDmaBuffer();
+		stream_len = 0;
+	}
+	stream_buf[stream_len++] = HighByte(color);
+	stream_buf[stream_len++] = LowByte(color);
+}
+
+void PixelStreamWrite(const uint8_t *src, uint32_t n){
+	uint32_t space;
+	while (n > 0){
+		if (stream_len == CHUNK_SIZE){
+			SpiQueueWrite(ili9341_spi, stream_buf, stream_len, DC_DATA);
+			stream_buf = NextDmaBuffer();
+			stream_len = 0;
+		}
+		space = CHUNK_SIZE - stream_len;
+		if (space > n){
+			space = n;
+		}
+		n -= space;
+		while (space--){
+			stream_buf[stream_len++] = *src++;
+		}
+	}
+}
+
+void PixelStreamEnd(void){
+	/* Returns without waiting, the chunk is sent in background */
+	if (stream_len > 0){
+		SpiQueueWrite(ili9341_spi, stream_buf, stream_len, DC_DATA);
 	}
 }
 
@@ -231,11 +435,288 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1){
 	WriteLCD(&lcd_rows);
 }
 
+/**
+ * @brief Expands a 1 bit per pixel glyph to RGB565 (wire byte order)
+ */
+static void GlyphExpand(uint8_t *dst, const Font_t *font, char c, uint16_t foreground, uint16_t background){
+	const char_info_t *info = &font->info[c - FIRST_CHAR];
+	const uint8_t *row;
+	for (uint16_t i = 0; i < font->font_height; i++){
+		row = &font->data[info->offset + i * ((info->width + 7) / 8)];
+		for (uint16_t j = 0; j < info->width; j++){
+			if (row[j / 8] & (MSK_BIT8 >> (j % 8))){
+				*dst++ = HighByte(foreground);
+				*dst++ = LowByte(foreground);
+			} else{
+				*dst++ = HighByte(background);
+				*dst++ = LowByte(background);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Expanded glyph from the cache (expanded and stored if it isn't there)
+ * @note Glyphs used in the current line (glyph_clock) are never evicted.
+ * @retval Pixels, NULL if the glyph can't be cached
+ */
+static const uint8_t *GlyphGet(Font_t *font, char c, uint16_t foreground, uint16_t background){
+	uint16_t size = font->font_height * font->info[c - FIRST_CHAR].width * 2;
+	uint8_t slot = GLYPH_CACHE_SLOTS, lru;
+	glyph_t *g;
+	if ((size == 0) || (size > GLYPH_MAX_BYTES)){
+		return NULL;
+	}
+	for (uint8_t i = 0; i < GLYPH_CACHE_SLOTS; i++){
+		g = &glyph_cache[i];
+		if ((g->font == font) && (g->c == c) && (g->foreground == foreground) && (g->background == background)){
+			g->last_use = glyph_clock;
+			return g->pixels;
+		}
+		if ((g->font == NULL) && (slot == GLYPH_CACHE_SLOTS)){
+			slot = i;
+		}
+	}
+	/* Evict least recently used glyphs until there is a slot and memory for the new one */
+	while ((slot == GLYPH_CACHE_SLOTS) || (glyph_cache_bytes + size > GLYPH_CACHE_BYTES)){
+		lru = GLYPH_CACHE_SLOTS;
+		for (uint8_t i = 0; i < GLYPH_CACHE_SLOTS; i++){
+			g = &glyph_cache[i];
+			if ((g->font != NULL) && (g->last_use != glyph_clock) &&
+				((lru == GLYPH_CACHE_SLOTS) || (g->last_use < glyph_cache[lru].last_use))){
+				lru = i;
+			}
+		}
+		if (lru == GLYPH_CACHE_SLOTS){
+			return NULL;
+		}
+		SpiDmaFree(glyph_cache[lru].pixels);
+		glyph_cache_bytes -= glyph_cache[lru].size;
+		glyph_cache[lru].font = NULL;
+		slot = lru;
+	}
+	g = &glyph_cache[slot];
+	g->pixels = SpiDmaMalloc(size);
+	if (g->pixels == NULL){
+		return NULL;
+	}
+	GlyphExpand(g->pixels, font, c, foreground, background);
+	g->font = font;
+	g->c = c;
+	g->foreground = foreground;
+	g->background = background;
+	g->size = size;
+	g->last_use = glyph_clock;
+	glyph_cache_bytes += size;
+	return g->pixels;
+}
+
+/**
+ * @brief Draw up to LINE_MAX_CHARS characters in one address window, only the rows above the
+ * bottom of the LCD. lead: background columns before the first character (spacing after the
+ * previous window). Returns the width drawn (0 if there are no characters of the font).
+ */
+static uint16_t DrawTextWindow(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint8_t spacing, uint8_t lead, uint16_t foreground, uint16_t background){
+	static const uint8_t *glyph[LINE_MAX_CHARS];
+	static const char_info_t *info[LINE_MAX_CHARS];
+	uint16_t i, j, k, n, width, rows;
+	const uint8_t *row;
+
+	/* Characters out of the font are skipped */
+	n = 0;
+	width = lead;
+	for (k = 0; k < len; k++){
+		if ((str[k] >= FIRST_CHAR) && (str[k] <= LAST_CHAR)){
+			info[n] = &font->info[str[k] - FIRST_CHAR];
+			width += info[n]->width + ((n > 0) ? spacing : 0);
+			n++;
+		}
+	}
+	if (n == 0){
+		return 0;
+	}
+	glyph_clock++;
+	for (k = 0, n = 0; k < len; k++){
+		if ((str[k] >= FIRST_CHAR) && (str[k] <= LAST_CHAR)){
+			glyph[n++] = GlyphGet(font, str[k], foreground, background);
+		}
+	}
+	rows = ((uint32_t)y + font->font_height > lcd_orientation.height) ? lcd_orientation.height - y : font->font_height;
+
+	SetCursorPosition(x, y, x + width - 1, y + rows - 1);
+	PixelStreamBegin();
+	/* The whole line is sent row by row: each row has a slice of every character */
+	for (i = 0; i < rows; i++){
+		for (j = 0; j < lead; j++){
+			PixelStreamPut(background);
+		}
+		for (k = 0; k < n; k++){
+			if ((k > 0) && (spacing > 0)){
+				for (j = 0; j < spacing; j++){
+					PixelStreamPut(background);
+				}
+			}
+			if (glyph[k] != NULL){
+				PixelStreamWrite(&glyph[k][i * info[k]->width * 2], info[k]->width * 2);
+			} else{
+				/* Not cached: expanded on the fly */
+				row = &font->data[info[k]->offset + i * ((info[k]->width + 7) / 8)];
+				for (j = 0; j < info[k]->width; j++){
+					PixelStreamPut((row[j / 8] & (MSK_BIT8 >> (j % 8))) ? foreground : background);
+				}
+			}
+		}
+	}
+	PixelStreamEnd();
+	return width;
+}
+
+bool DrawTextLine(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint8_t spacing, uint16_t foreground, uint16_t background){
+	uint16_t k, n = 0, width = 0, chunk, drawn;
+	uint8_t lead = 0;
+
+	/* Width of the whole line: nothing is drawn if it doesn't fit */
+	for (k = 0; k < len; k++){
+		if ((str[k] >= FIRST_CHAR) && (str[k] <= LAST_CHAR)){
+			width += font->info[str[k] - FIRST_CHAR].width + ((n > 0) ? spacing : 0);
+			n++;
+		}
+	}
+	/* Rows below the LCD are clipped (as the controller does with a window out of the LCD) */
+	if ((n == 0) || (y >= lcd_orientation.height)){
+		return true;
+	}
+	if (x + width > lcd_orientation.width){
+		return false;
+	}
+	/* Long lines are drawn in several windows: each one starts with the spacing after the previous one */
+	while (len > 0){
+		chunk = (len > LINE_MAX_CHARS) ? LINE_MAX_CHARS : len;
+		drawn = DrawTextWindow(x, y, str, chunk, font, spacing, lead, foreground, background);
+		if (drawn > 0){
+			x += drawn;
+			lead = spacing;
+		}
+		str += chunk;
+		len -= chunk;
+	}
+	return true;
+}
+
+/**
+ * @brief Character info of an anti-aliased font (NULL if the character isn't included)
+ */
+static inline const aa_char_info_t *AACharInfo(const aa_font_t *font, char c){
+	if ((c < font->first) || (c > font->last) || (font->map[c - font->first] == AA_FONT_NO_CHAR)){
+		return NULL;
+	}
+	return &font->info[font->map[c - font->first]];
+}
+
+/**
+ * @brief Next coverage level of an anti-aliased character
+ */
+static inline uint8_t AADecode(aa_decoder_t *d, uint8_t bpp, bool rle){
+	uint8_t level, mask;
+	if (d->left == 0){
+		if (rle){
+			mask = (1 << (8 - bpp)) - 1;
+			d->bits = *d->data >> (8 - bpp);
+			d->left = (*d->data & mask) + 1;
+			if ((*d->data & mask) == mask){
+				/* Long run: length continues in the next byte */
+				d->data++;
+				d->left += *d->data;
+			}
+		} else{
+			d->bits = *d->data;
+			d->left = 8 / bpp;
+		}
+		d->data++;
+	}
+	d->left--;
+	if (rle){
+		return d->bits;
+	}
+	level = d->bits >> (8 - bpp);
+	d->bits <<= bpp;
+	return level;
+}
+
+/**
+ * @brief Draw up to LINE_MAX_CHARS anti-aliased characters in one address window
+ */
+static uint16_t DrawAAWindow(uint16_t x, uint16_t y, const char *str, uint16_t len, const aa_font_t *font, uint16_t foreground, uint16_t background){
+	aa_decoder_t decoder[LINE_MAX_CHARS];
+	uint8_t width[LINE_MAX_CHARS];
+	uint16_t palette[AA_LEVELS_MAX];
+	uint16_t i, j, k, n, line_width;
+	const aa_char_info_t *info;
+	uint8_t levels = 1 << font->bpp;
+	int32_t r, g, b;
+
+	if (y + font->font_height > lcd_orientation.height){
+		return x;
+	}
+	/* Characters out of the font are skipped, the ones out of the LCD are clipped */
+	n = 0;
+	line_width = 0;
+	for (k = 0; k < len; k++){
+		info = AACharInfo(font, str[k]);
+		if (info == NULL){
+			continue;
+		}
+		if (x + line_width + info->width > lcd_orientation.width){
+			break;
+		}
+		decoder[n].data = &font->data[info->offset];
+		decoder[n].left = 0;
+		width[n] = info->width;
+		line_width += info->width;
+		n++;
+	}
+	if (line_width == 0){
+		return x;
+	}
+	/* Each level blended from background to foreground (RGB565 components) */
+	for (i = 0; i < levels; i++){
+		r = (background >> 11) + ((int32_t)(foreground >> 11) - (background >> 11)) * i / (levels - 1);
+		g = ((background >> 5) & 0x3F) + ((int32_t)((foreground >> 5) & 0x3F) - ((background >> 5) & 0x3F)) * i / (levels - 1);
+		b = (background & 0x1F) + ((int32_t)(foreground & 0x1F) - (background & 0x1F)) * i / (levels - 1);
+		palette[i] = (r << 11) | (g << 5) | b;
+	}
+
+	SetCursorPosition(x, y, x + line_width - 1, y + font->font_height - 1);
+	PixelStreamBegin();
+	/* The whole line is sent row by row, each character decoded where it was left in the previous row */
+	for (i = 0; i < font->font_height; i++){
+		for (k = 0; k < n; k++){
+			for (j = 0; j < width[k]; j++){
+				PixelStreamPut(palette[AADecode(&decoder[k], font->bpp, font->rle)]);
+			}
+		}
+	}
+	PixelStreamEnd();
+	return x + line_width;
+}
+
+uint16_t DrawAATextLine(uint16_t x, uint16_t y, const char *str, uint16_t len, const aa_font_t *font, uint16_t foreground, uint16_t background){
+	uint16_t chunk;
+
+	/* Long lines are drawn in several windows */
+	while (len > 0){
+		chunk = (len > LINE_MAX_CHARS) ? LINE_MAX_CHARS : len;
+		x = DrawAAWindow(x, y, str, chunk, font, foreground, background);
+		str += chunk;
+		len -= chunk;
+	}
+	return x;
+}
+
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
-	static uint16_t i;
+	static uint32_t i, chunk;
 	static int32_t bytes_count;
 	static int16_t x_dist, y_dist;
-	static uint8_t pixel[MAX_VALUE_SIZE];
 
 	x_dist = x1 - x0;
 	y_dist = y1 - y0;
@@ -250,21 +731,117 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
 	/* Define area to fill */
 	SetCursorPosition(x0, y0, x1, y1);
 
-	for (i = 0; i < MAX_VALUE_SIZE; i += 2){
-		pixel[i] = HighByte(color);
-		pixel[i + 1] = LowByte(color);
-	}
-	/* Start writing LCD memory */
+	/* Start writing LCD memory (waits the end of the queued chunks, so both buffers are free) */
 	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
 	WriteLCD(&lcd_write);
 
-	while(bytes_count - MAX_VALUE_SIZE > 0){
-		lcd_cmd_t lcd_pixel = {NULL, MAX_VALUE_SIZE, pixel};
-		WriteLCD(&lcd_pixel);
-		bytes_count -= MAX_VALUE_SIZE;
+	/* Both buffers are filled with the color (only the bytes needed) and sent alternately */
+	chunk = (bytes_count < CHUNK_SIZE) ? bytes_count : CHUNK_SIZE;
+	for (i = 0; i < chunk; i += 2){
+		dma_buf[0][i] = dma_buf[1][i] = HighByte(color);
+		dma_buf[0][i + 1] = dma_buf[1][i + 1] = LowByte(color);
+	}
+	while(bytes_count > 0){
+		chunk = (bytes_count < CHUNK_SIZE) ? bytes_count : CHUNK_SIZE;
+		dma_idx ^= 1;
+		SpiQueueWrite(ili9341_spi, dma_buf[dma_idx], chunk, DC_DATA);
+		bytes_count -= chunk;
+	}
+}
+
+void FillClipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+	int16_t aux;
+	if (x0 > x1){
+		aux = x0;
+		x0 = x1;
+		x1 = aux;
+	}
+	if (y0 > y1){
+		aux = y0;
+		y0 = y1;
+		y1 = aux;
+	}
+	if ((x1 < 0) || (y1 < 0) || (x0 >= lcd_orientation.width) || (y0 >= lcd_orientation.height)){
+		return;
+	}
+	if (x0 < 0){
+		x0 = 0;
+	}
+	if (y0 < 0){
+		y0 = 0;
+	}
+	if (x1 >= lcd_orientation.width){
+		x1 = lcd_orientation.width - 1;
+	}
+	if (y1 >= lcd_orientation.height){
+		y1 = lcd_orientation.height - 1;
+	}
+	Fill(x0, y0, x1, y1, color);
+}
+
+void CircleRun(int16_t x0, int16_t y0, int16_t xa, int16_t xb, int16_t y, bool filled, uint16_t color){
+	if (filled){
+		/* Rows y0 +- y: one span from side to side */
+		FillClipped(x0 - xb, y0 + y, x0 + xb, y0 + y, color);
+		FillClipped(x0 - xb, y0 - y, x0 + xb, y0 - y, color);
+		/* Rows y0 +- xa..xb have the same width: one rectangle */
+		if (xa == 0){
+			FillClipped(x0 - y, y0 - xb, x0 + y, y0 + xb, color);
+		} else{
+			FillClipped(x0 - y, y0 + xa, x0 + y, y0 + xb, color);
+			FillClipped(x0 - y, y0 - xb, x0 + y, y0 - xa, color);
+		}
+	} else{
+		/* Top and bottom octants: horizontal runs */
+		if (xa == 0){
+			FillClipped(x0 - xb, y0 + y, x0 + xb, y0 + y, color);
+			FillClipped(x0 - xb, y0 - y, x0 + xb, y0 - y, color);
+			FillClipped(x0 + y, y0 - xb, x0 + y, y0 + xb, color);
+			FillClipped(x0 - y, y0 - xb, x0 - y, y0 + xb, color);
+		} else{
+			FillClipped(x0 + xa, y0 + y, x0 + xb, y0 + y, color);
+			FillClipped(x0 - xb, y0 + y, x0 - xa, y0 + y, color);
+			FillClipped(x0 + xa, y0 - y, x0 + xb, y0 - y, color);
+			FillClipped(x0 - xb, y0 - y, x0 - xa, y0 - y, color);
+			/* Left and right octants: vertical runs */
+			FillClipped(x0 + y, y0 + xa, x0 + y, y0 + xb, color);
+			FillClipped(x0 + y, y0 - xb, x0 + y, y0 - xa, color);
+			FillClipped(x0 - y, y0 + xa, x0 - y, y0 + xb, color);
+			FillClipped(x0 - y, y0 - xb, x0 - y, y0 - xa, color);
+		}
+	}
+}
+
+/**
+ * @brief Midpoint circle: consecutive points with the same row are drawn as one run
+ */
+static void DrawCircleRuns(int16_t x0, int16_t y0, int16_t r, bool filled, uint16_t color){
+	int16_t f, ddF_x, ddF_y, x, y, run_x;
+
+	if (r < 0){
+		return;
 	}
-	lcd_cmd_t lcd_pixel = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixel);
+	f = 1 - r;
+	ddF_x = 1;
+	ddF_y = -2 * r;
+	x = 0;
+	y = r;
+	run_x = 0;
+
+	while (x < y){
+		if (f >= 0){
+			/* Row changes: draw the run */
+			CircleRun(x0, y0, run_x, x, y, filled, color);
+			run_x = x + 1;
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+	}
+	CircleRun(x0, y0, run_x, x, y, filled, color);
 }
 
 /*==================[external functions definition]==========================*/
@@ -276,8 +853,23 @@ uint8_t ILI9341Init(spi_dev_t spi_dev, uint8_t gpio_dc, uint8_t gpio_rst){
 	/* GPIOs configuration and initialization */
 	ili9341_dc = gpio_dc;
 	ili9341_rst = gpio_rst;
+	dc_mask = 1UL << ili9341_dc;
 	GPIOInit(ili9341_dc, GPIO_OUTPUT);
 	GPIOInit(ili9341_rst, GPIO_OUTPUT);
+	/* SPI device is added once, DC line is driven by the SPI driver before each transaction */
+	spi_conf.pre_func_p = SpiPreTransfer;
+	SpiInit(&spi_conf);
+	if (dma_buf[0] == NULL){
+		dma_buf[0] = SpiDmaMalloc(CHUNK_SIZE);
+		dma_buf[1] = SpiDmaMalloc(CHUNK_SIZE);
+		if ((dma_buf[0] == NULL) || (dma_buf[1] == NULL)){
+			SpiDmaFree(dma_buf[0]);
+			SpiDmaFree(dma_buf[1]);
+			dma_buf[0] = NULL;
+			dma_buf[1] = NULL;
+			return false;
+		}
+	}
 
 	/* RST must be held low for minimum 10µsec after VCC have been applied */
 	DelayUs(10);
@@ -350,11 +942,7 @@ void ILI9341Rotate(ili9341_orientation_t orientation){
 }
 
 void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t foreground, uint16_t background){
-	static uint32_t i, j, k;
-	static uint32_t char_row;
 	static uint16_t lcd_x, lcd_y;
-	static int32_t bytes_count, bytes_row;
-	static uint8_t pixel[MAX_VALUE_SIZE];
 
 	/* Set coordinates */
 	lcd_x = x;
@@ -366,57 +954,13 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t f
 		lcd_x = 0;
 	}
 
-	SetCursorPosition(lcd_x, lcd_y, lcd_x + font->info[data - ' '].width - 1, lcd_y + font->font_height - 1);
-
-	/* Number of bytes to write. We have to write 2 bytes/pixel */
-	bytes_count = font->font_height * font->info[data - ' '].width * 2;
-
-	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
-	WriteLCD(&lcd_write);
-
-	/* Draw font data */
-	/* go through character rows */
-	k = 0;
-	for (i = 0; i < font->font_height; i++)	{
-		/* */
-		char_row = font->info[data - ' '].offset + i * ((font->info[data - ' '].width + 7) / 8);
-		/* go through character columns */
-		bytes_row = -1;
-		for (j = 0; j < font->info[data - ' '].width; j++){
-			if(j % 8 == 0){
-				bytes_row++;
-			}
-			/* If exceed buffer size, send buffer */
-			if ((2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE){
-				lcd_cmd_t lcd_pixels = {NULL, MAX_VALUE_SIZE, pixel};
-				WriteLCD(&lcd_pixels);
-				bytes_count -= MAX_VALUE_SIZE;
-				k++;
-			}
-			/* The n=FontWidth first bits of the 16bits row data draws the corresponding part of a character */
-			if (font->data[char_row + bytes_row] & (MSK_BIT8 >> (j % 8))){
-				/* if bit = 1, draw put foreground color */
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE] = HighByte(foreground);
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(foreground);
-			}
-			else{
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE] = HighByte(background);
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(background);
-			}
-		}
-	}
-	/* Send the rest of the buffer */
-	lcd_cmd_t lcd_pixels = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixels);
+	DrawTextLine(lcd_x, lcd_y, &data, 1, font, 0, foreground, background);
 }
 
 void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font, uint16_t foreground, uint16_t background){
-	static uint32_t i, j, k;
+	static uint32_t i, j;
 	static uint32_t char_row;
 	static uint16_t lcd_x, lcd_y;
-	static int32_t bytes_count, bytes_row;
-	static uint8_t pixel[MAX_VALUE_SIZE];
 
 	/* Set coordinates */
 	lcd_x = x;
@@ -430,57 +974,52 @@ void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font
 
 	SetCursorPosition(lcd_x, lcd_y, lcd_x + icon_font->width - 1, lcd_y + icon_font->height - 1);
 
-	/* Number of bytes to write. We have to write 2 bytes/pixel */
-	bytes_count = icon_font->height * icon_font->width * 2;
-
-	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
-	WriteLCD(&lcd_write);
+	PixelStreamBegin();
 
 	/* Draw font data */
 	/* go through character rows */
-	k = 0;
 	for (i = 0; i < icon_font->height; i++)	{
 		/*  */
 		char_row = icon * icon_font->offset + i * ((icon_font->width + 7) / 8);
 		/* go through character columns */
-		bytes_row = -1;
 		for (j = 0; j < icon_font->width; j++){
-			if(j % 8 == 0){
-				bytes_row++;
-			}
-			/* If exceed buffer size, send buffer */
-			if ((2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE){
-				lcd_cmd_t lcd_pixels = {NULL, MAX_VALUE_SIZE, pixel};
-				WriteLCD(&lcd_pixels);
-				bytes_count -= MAX_VALUE_SIZE;
-				k++;
-			}
 			/* The n=FontWidth first bits of the 16bits row data draws the corresponding part of a character */
-			if (icon_font->data[char_row + bytes_row] & (MSK_BIT8 >> (j % 8))){
+			if (icon_font->data[char_row + j / 8] & (MSK_BIT8 >> (j % 8))){
 				/* if bit = 1, draw put foreground color */
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE] = HighByte(foreground);
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(foreground);
+				PixelStreamPut(foreground);
 			}
 			else{
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE] = HighByte(background);
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(background);
+				PixelStreamPut(background);
 			}
 		}
 	}
-	/* Send the rest of the buffer */
-	lcd_cmd_t lcd_pixels = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixels);
+	PixelStreamEnd();
 }
 
 void ILI9341DrawInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t* font, uint16_t foreground, uint16_t background){
 	static uint16_t i;
 	static uint16_t lcd_x, lcd_y;
+	char digits[LINE_MAX_CHARS];
 
 	/* Set coordinates */
 	lcd_x = x;
 	lcd_y = y;
 
+	if (dig == 0){
+		return;
+	}
+	if (dig <= LINE_MAX_CHARS){
+		/* A copy is consumed, the fallback below needs num */
+		uint32_t aux = num;
+		for (i = 0; i < dig; i++){
+			digits[dig - 1 - i] = aux%10 + '0';
+			aux = aux/10;
+		}
+		/* All the digits in one window, side by side (each one after the previous, with its own width) */
+		if (DrawTextLine(lcd_x + 1, lcd_y, digits, dig, font, 0, foreground, background)){
+			return;
+		}
+	}
 	for (i=0; i<dig; i++){
 		lcd_x = x + font->info[num%10 + '0' - ' '].width * (dig-1-i) + 1;
 		ILI9341DrawChar(lcd_x, lcd_y, num%10 + '0', font, foreground, background);
@@ -489,7 +1028,7 @@ void ILI9341DrawInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t* f
 }
 
 void ILI9341DrawString(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t foreground, uint16_t background){
-	static uint16_t lcd_x, lcd_y;
+	static uint16_t lcd_x, lcd_y, len;
 
 	/* Set coordinates */
 	lcd_x = x;
@@ -508,16 +1047,30 @@ void ILI9341DrawString(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t
 				lcd_x = x;
 			}
 			str++;
+			continue;
 		}
 		else if (*str == '\r'){
+			str++;
+			continue;
+		}
+		/* Characters until the end of the line are drawn together */
+		len = 0;
+		while ((str[len] != '\0') && (str[len] != '\n') && (str[len] != '\r')){
+			len++;
+		}
+		if (!DrawTextLine(lcd_x, lcd_y, str, len, font, CHAR_SPACE, foreground, background)){
+			/* Line doesn't fit: characters are drawn one by one (wrapping at the end of the display) */
+			while (len--){
+				ILI9341DrawChar(lcd_x, lcd_y, *str, font, foreground, background);
+				lcd_x += font->info[*str - ' '].width + 1;
 				str++;
 			}
-
-		/* Put character to LCD */
-		ILI9341DrawChar(lcd_x, lcd_y, *str, font, foreground, background);
-		lcd_x += font->info[*str - ' '].width + 1;
-		/* Next character */
-		str++;
+			continue;
+		}
+		while (len--){
+			lcd_x += font->info[*str - ' '].width + 1;
+			str++;
+		}
 	}
 }
 
@@ -534,8 +1087,50 @@ void ILI9341GetStringSize(char* str, Font_t* font, uint16_t* width, uint16_t* he
 	*width = w;
 }
 
+void ILI9341DrawAAString(uint16_t x, uint16_t y, const char *str, const aa_font_t *font, uint16_t foreground, uint16_t background){
+	uint16_t len;
+
+	while (*str != '\0'){
+		len = 0;
+		while ((str[len] != '\0') && (str[len] != '\n')){
+			len++;
+		}
+		DrawAATextLine(x, y, str, len, font, foreground, background);
+		str += len;
+		if (*str == '\n'){
+			y += font->font_height + 1;
+			str++;
+		}
+	}
+}
+
+void ILI9341GetAAStringSize(const char *str, const aa_font_t *font, uint16_t *width, uint16_t *height){
+	const aa_char_info_t *info;
+	uint16_t w;
+
+	*width = 0;
+	*height = font->font_height;
+	w = 0;
+	while (*str != '\0'){
+		if (*str == '\n'){
+			*height += font->font_height + 1;
+			w = 0;
+		} else{
+			info = AACharInfo(font, *str);
+			if (info != NULL){
+				w += info->width;
+			}
+		}
+		if (w > *width){
+			*width = w;
+		}
+		str++;
+	}
+}
+
 void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
-	static int16_t x_dist, y_dist, x_grow, y_grow, error, error_2;
+	static int16_t x_dist, y_dist, x_grow, y_grow, error, error_2, run_x, run_y;
+	static bool step_x, step_y;
 
 	/* Check for overflow */
 	if (x0 >= lcd_orientation.width){
@@ -571,27 +1166,38 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
 
 	/* Vertical or horizontal line */
 	if (x_dist == 0 || y_dist == 0){
-		Fill(x0, y0, x1, y1, color);
+		FillClipped(x0, y0, x1, y1, color);
 	}
 	/* Diagonal line */
 	else{
 		error = x_dist - y_dist;
+		/* Consecutive pixels in the same row (x major octants) or column (y major octants)
+		are drawn as one run */
+		run_x = x0;
+		run_y = y0;
 
 		while (1){
-			/* Draw start point */
-			ILI9341DrawPixel(x0, y0, color);
 			/* Loop ends when start point reaches end point */
 			if (x0 == x1 && y0 == y1){
+				FillClipped(run_x, run_y, x0, y0, color);
 				break;
 			}
 			error_2 = 2 * error;
+			step_x = (error_2 > -y_dist);
+			step_y = (error_2 < x_dist);
+			/* Run ends when the line leaves its row (or column) */
+			if ((x_dist >= y_dist) ? step_y : step_x){
+				FillClipped(run_x, run_y, x0, y0, color);
+				run_x = x0 + (step_x ? x_grow : 0);
+				run_y = y0 + (step_y ? y_grow : 0);
+			}
 			/* Determine if line must grow in x direction */
-			if (error_2 > -y_dist){
+			if (step_x){
 				error -= y_dist;
 				x0 += x_grow;	/* Move start point */
 			}
 			/* Determine if line must grow in y direction */
-			if (error_2 < x_dist){
+			if (step_y){
 				error += x_dist;
 				y0 += y_grow;	/* Move start point */
 			}
@@ -611,72 +1217,11 @@ void ILI9341DrawFilledRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t
 }
 
 void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
-	static int16_t f, ddF_x, ddF_y, x, y;
-
-	f = 1 - r;
-	ddF_x = 1;
-	ddF_y = -2 * r;
-	x = 0;
-	y = r;
-
-	ILI9341DrawPixel(x0, y0 + r, color);
-	ILI9341DrawPixel(x0, y0 - r, color);
-	ILI9341DrawPixel(x0 + r, y0, color);
-	ILI9341DrawPixel(x0 - r, y0, color);
-
-    while (x < y){
-        if (f >= 0){
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        ILI9341DrawPixel(x0 + x, y0 + y, color);
-        ILI9341DrawPixel(x0 - x, y0 + y, color);
-        ILI9341DrawPixel(x0 + x, y0 - y, color);
-        ILI9341DrawPixel(x0 - x, y0 - y, color);
-
-        ILI9341DrawPixel(x0 + y, y0 + x, color);
-        ILI9341DrawPixel(x0 - y, y0 + x, color);
-        ILI9341DrawPixel(x0 + y, y0 - x, color);
-        ILI9341DrawPixel(x0 - y, y0 - x, color);
-    }
+	DrawCircleRuns(x0, y0, r, false, color);
 }
 
 void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
-	static int16_t f, ddF_x, ddF_y, x, y;
-
-	f = 1 - r;
-	ddF_x = 1;
-	ddF_y = -2 * r;
-	x = 0;
-	y = r;
-
-    ILI9341DrawPixel(x0, y0 + r, color);
-    ILI9341DrawPixel(x0, y0 - r, color);
-    ILI9341DrawPixel(x0 + r, y0, color);
-    ILI9341DrawPixel(x0 - r, y0, color);
-    ILI9341DrawLine(x0 - r, y0, x0 + r, y0, color);
-
-    while (x < y){
-        if (f >= 0){
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        ILI9341DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        ILI9341DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
-
-        ILI9341DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        ILI9341DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
-    }
+	DrawCircleRuns(x0, y0, r, true, color);
 }
 
 void ILI9341DrawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color){
@@ -686,123 +1231,49 @@ void ILI9341DrawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t
 }
 
 void ILI9341DrawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color){
-	static int16_t x_0 = 0;
-	static int16_t y_0 = 0;
-	static int16_t x_1 = 0;
-	static int16_t y_1 = 0;
-	static int16_t x_2 = 0;
-	static int16_t y_2 = 0;
-	static int16_t x_aux = 0;
-	static int16_t y_aux = 0;
-	static int16_t scanline_y = 0;
-	float invslope1, invslope2, curx1, curx2;
-	if((y0 <= y1) && (y0 <= y2)){
-		x_0 = x0;
-		y_0 = y0;
-		if(y1 <= y2){
-			x_1 = x1;
-			y_1 = y1;
-			x_2 = x2;
-			y_2 = y2;
-		} else{
-			x_1 = x2;
-			y_1 = y2;
-			x_2 = x1;
-			y_2 = y1;
-		}
-	}else if((y1 <= y2) && (y1 <= y0)){
-		x_0 = x1;
-		y_0 = y1;
-		if(y0 <= y2){
-			x_1 = x0;
-			y_1 = y0;
-			x_2 = x2;
-			y_2 = y2;
-		} else{
-			x_1 = x2;
-			y_1 = y2;
-			x_2 = x0;
-			y_2 = y0;
-		}
-	}else if((y2 <= y1) && (y2 <= y0)){
-		x_0 = x2;
-		y_0 = y2;
-		if(y0 <= y1){
-			x_1 = x0;
-			y_1 = y0;
-			x_2 = x1;
-			y_2 = y1;
+	static int16_t aux, y, xa, xb;
+
+	/* Sort vertices by row (y0 <= y1 <= y2) */
+	if (y0 > y1){
+		aux = y0; y0 = y1; y1 = aux;
+		aux = x0; x0 = x1; x1 = aux;
+	}
+	if (y1 > y2){
+		aux = y1; y1 = y2; y2 = aux;
+		aux = x1; x1 = x2; x2 = aux;
+	}
+	if (y0 > y1){
+		aux = y0; y0 = y1; y1 = aux;
+		aux = x0; x0 = x1; x1 = aux;
+	}
+	/* Degenerate triangle: all vertices in the same row */
+	if (y0 == y2){
+		xa = xb = x0;
+		if (x1 < xa) xa = x1;
+		if (x1 > xb) xb = x1;
+		if (x2 < xa) xa = x2;
+		if (x2 > xb) xb = x2;
+		FillClipped(xa, y0, xb, y0, color);
+		return;
+	}
+	/* One span per row, between the long edge (0-2) and the short ones (0-1, 1-2) */
+	for (y = y0; y <= y2; y++){
+		xa = x0 + (int32_t)(x2 - x0) * (y - y0) / (y2 - y0);
+		if (y < y1){
+			xb = x0 + (int32_t)(x1 - x0) * (y - y0) / (y1 - y0);
+		} else if (y2 == y1){
+			xb = x1;
 		} else{
-			x_1 = x1;
-			y_1 = y1;
-			x_2 = x0;
-			y_2 = y0;
-		}
-	}
-	if(y_1 == y_2){
-		// Bottom flat triangle
-		invslope1 = (float)(x_1 - x_0) / (float)(y_1 - y_0);
-		invslope2 = (float)(x_2 - x_0) / (float)(y_2 - y_0);
-		curx1 = x_0;
-		curx2 = x_0;
-		scanline_y = y_0;
-		while(scanline_y < y_1){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 += invslope1;
-			curx2 += invslope2;
-			scanline_y++;
-		}
-  	}
-  	else if (y_0 == y_1){
-		// Top flat triangle
-		invslope1 = (float)(x_2 - x_0) / (float)(y_2 - y_0);
-		invslope2 = (float)(x_2 - x_1) / (float)(y_2 - y_1);
-		curx1 = x_2;
-		curx2 = x_2;
-		scanline_y = y_2;
-		while(scanline_y > y_0){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 -= invslope1;
-			curx2 -= invslope2;
-			scanline_y--;
-		}
-  	}
-  	else{
-		// Split in a flat top triangle and a bottom flat triangle
-		x_aux = (int)(x_0 + (float)(y_1 - y_0) / (float)(y_2 - y_0) * (x_2 - x_0));
-		y_aux = y_1;
-		// Bottom flat triangle
-		invslope1 = (float)(x_1 - x_0) / (float)(y_1 - y_0);
-		invslope2 = (float)(x_aux - x_0) / (float)(y_aux - y_0);
-		curx1 = x_0;
-		curx2 = x_0;
-		scanline_y = y_0;
-		while(scanline_y < y_1){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 += invslope1;
-			curx2 += invslope2;
-			scanline_y++;
-		}
-		// Top flat triangle
-		invslope1 = (float)(x_2 - x_1) / (float)(y_2 - y_1);
-		invslope2 = (float)(x_2 - x_aux) / (float)(y_2 - y_aux);
-		curx1 = x_2;
-		curx2 = x_2;
-		scanline_y = y_2;
-		while(scanline_y > y_1){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 -= invslope1;
-			curx2 -= invslope2;
-			scanline_y--;
-		}
-		ILI9341DrawLine(x_1, y_1, x_aux, y_aux, color);
-  	}
+			xb = x1 + (int32_t)(x2 - x1) * (y - y1) / (y2 - y1);
+		}
+		FillClipped(xa, y, xb, y, color);
+	}
 }
 
 void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pic){
-	static uint16_t i, j;
+	static uint32_t chunk;
 	static int32_t bytes_count;
-	static uint8_t pixel[MAX_VALUE_SIZE];
+	uint8_t *buf;
 
 	SetCursorPosition(x, y, x + width - 1, y + height - 1);
 
@@ -813,24 +1284,337 @@ void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
 	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
 	WriteLCD(&lcd_write);
 
-	j = 0;
-	while(bytes_count - MAX_VALUE_SIZE > 0){
-		for (i = 0; i < MAX_VALUE_SIZE; i++){
-			pixel[i] = pic[j * MAX_VALUE_SIZE + i];
+	/* Picture can be in flash (not DMA capable): each chunk is copied while the previous one is sent */
+	while(bytes_count > 0){
+		chunk = (bytes_count < CHUNK_SIZE) ? bytes_count : CHUNK_SIZE;
+		buf = NextDmaBuffer();
+		for (uint32_t i = 0; i < chunk; i++){
+			buf[i] = *pic++;
 		}
-		lcd_cmd_t lcd_pixel = {NULL, MAX_VALUE_SIZE, pixel};
-		WriteLCD(&lcd_pixel);
-		bytes_count -= MAX_VALUE_SIZE;
-		j++;
+		SpiQueueWrite(ili9341_spi, buf, chunk, DC_DATA);
+		bytes_count -= chunk;
+	}
+}
+
+/**
+ * @brief Format, palette and bits per pixel of an image are supported
+ */
+static inline bool ImageValid(const ili9341_image_t *image){
+	return (image->format <= ILI9341_IMAGE_PALETTE_RLE) &&
+		((image->format < ILI9341_IMAGE_PALETTE) || (image->palette != NULL)) &&
+		((image->format != ILI9341_IMAGE_PALETTE) || (image->bpp == 1) || (image->bpp == 2) || (image->bpp == 4) || (image->bpp == 8));
+}
+
+/**
+ * @brief Next pixel value of an RLE image (RGB565 or palette index)
+ */
+static inline uint16_t ImageRleValue(image_decoder_t *d){
+	uint16_t color;
+	if (d->image->format == ILI9341_IMAGE_RLE){
+		color = (d->src + 1 < d->end) ? ((d->src[0] << 8) | d->src[1]) : 0;
+		d->src += 2;
+	} else{
+		color = (d->src < d->end) ? d->image->palette[*d->src] : 0;
+		d->src++;
 	}
-	for (i = 0; i < bytes_count; i++){
-		pixel[i] = pic[j * MAX_VALUE_SIZE + i];
+	return color;
+}
+
+/**
+ * @brief Decode the next row of an image (missing data is decoded as black)
+ */
+static void ImageDecodeRow(image_decoder_t *d, uint16_t *row){
+	const ili9341_image_t *image = d->image;
+	uint8_t mask = (1 << image->bpp) - 1;
+	uint16_t i;
+
+	for (i = 0; i < image->width; i++){
+		switch (image->format){
+		case ILI9341_IMAGE_RAW:
+			row[i] = (d->src + 1 < d->end) ? ((d->src[0] << 8) | d->src[1]) : 0;
+			d->src += 2;
+			break;
+		case ILI9341_IMAGE_RLE:
+		case ILI9341_IMAGE_PALETTE_RLE:
+			if (d->count == 0){
+				if (d->src >= d->end){
+					row[i] = 0;
+					break;
+				}
+				d->run = *d->src & MSK_BIT8;
+				d->count = (*d->src++ & ~MSK_BIT8) + 1;
+				if (d->run){
+					d->color = ImageRleValue(d);
+				}
+			}
+			row[i] = d->run ? d->color : ImageRleValue(d);
+			d->count--;
+			break;
+		case ILI9341_IMAGE_PALETTE:
+			if (d->shift == 0){
+				d->src++;
+				d->shift = 8;
+			}
+			d->shift -= image->bpp;
+			row[i] = (d->src < d->end) ? image->palette[(*d->src >> d->shift) & mask] : 0;
+			break;
+		}
 	}
-	lcd_cmd_t lcd_pixel = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixel);
+}
+
+bool ILI9341DrawImage(uint16_t x, uint16_t y, const ili9341_image_t *image){
+	uint32_t pixels, count;
+	uint16_t color;
+	uint8_t header, bits, mask, shift;
+	const uint8_t *src = image->data;
+	const uint8_t *end = image->data + image->size;
+
+	if ((image->width == 0) || (image->height == 0)){
+		return true;
+	}
+	if (!ImageValid(image)){
+		return false;
+	}
+	pixels = (uint32_t)image->width * image->height;
+	SetCursorPosition(x, y, x + image->width - 1, y + image->height - 1);
+	PixelStreamBegin();
+
+	switch (image->format){
+	case ILI9341_IMAGE_RAW:
+		/* Same byte order as the LCD: copied to the DMA buffers */
+		PixelStreamWrite(src, (src + pixels * 2 <= end) ? pixels * 2 : image->size);
+		break;
+	case ILI9341_IMAGE_RLE:
+	case ILI9341_IMAGE_PALETTE_RLE:
+		/* Truncated data: drawing stops at the end of the image data */
+		while ((pixels > 0) && (src < end)){
+			header = *src++;
+			count = (header & ~MSK_BIT8) + 1;
+			if (count > pixels){
+				count = pixels;
+			}
+			pixels -= count;
+			if (header & MSK_BIT8){
+				/* Run of the same pixel */
+				if (image->format == ILI9341_IMAGE_RLE){
+					if (src + 1 >= end){
+						break;
+					}
+					color = (src[0] << 8) | src[1];
+					src += 2;
+				} else{
+					if (src >= end){
+						break;
+					}
+					color = image->palette[*src++];
+				}
+				while (count--){
+					PixelStreamPut(color);
+				}
+			} else if (image->format == ILI9341_IMAGE_RLE){
+				/* Literal pixels, already in LCD byte order */
+				if (count * 2 > (uint32_t)(end - src)){
+					count = (end - src) / 2;
+				}
+				PixelStreamWrite(src, count * 2);
+				src += count * 2;
+			} else{
+				while ((count > 0) && (src < end)){
+					PixelStreamPut(image->palette[*src++]);
+					count--;
+				}
+			}
+		}
+		break;
+	case ILI9341_IMAGE_PALETTE:
+		bits = image->bpp;
+		mask = (1 << bits) - 1;
+		shift = 8;
+		while ((pixels > 0) && (src < end)){
+			if (shift == 0){
+				src++;
+				shift = 8;
+				continue;
+			}
+			shift -= bits;
+			PixelStreamPut(image->palette[(*src >> shift) & mask]);
+			pixels--;
+		}
+		break;
+	}
+	PixelStreamEnd();
+	return true;
+}
+
+void ILI9341WriteArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pixels){
+	static uint32_t chunk;
+	static int32_t bytes_count;
+
+	SetCursorPosition(x, y, x + width - 1, y + height - 1);
+	bytes_count = width * height * 2;
+
+	/* Start writing LCD memory (waits the end of the previous transfers) */
+	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
+	WriteLCD(&lcd_write);
+
+	/* Buffer is already DMA capable, it's sent in place */
+	while(bytes_count > 0){
+		chunk = (bytes_count < SPI_MAX_TRANSFER_SIZE) ? bytes_count : SPI_MAX_TRANSFER_SIZE;
+		SpiQueueWrite(ili9341_spi, pixels, chunk, DC_DATA);
+		pixels += chunk;
+		bytes_count -= chunk;
+	}
+}
+
+void ILI9341ReadArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t* pixels){
+	static uint32_t pixels_count, chunk, i;
+	static uint16_t color;
+	static uint8_t command;
+	uint8_t *buf;
+
+	SetCursorPosition(x, y, x + width - 1, y + height - 1);
+	pixels_count = (uint32_t)width * height;
+	command = MEM_READ;
+	/* The LCD can't answer at the write clock */
+	SpiSetBitrate(ili9341_spi, SPI_READ_BR);
+	while (pixels_count > 0){
+		chunk = (pixels_count < READ_CHUNK_PIXELS) ? pixels_count : READ_CHUNK_PIXELS;
+		buf = NextDmaBuffer();
+		SpiPollingRead(ili9341_spi, &command, 1, DC_CMD, buf, 1 + chunk * 3, DC_DATA);
+		/* A dummy byte, then 3 bytes per pixel (R, G and B of 6 bits, left aligned) */
+		for (i = 0; i < chunk; i++){
+			color = ((buf[1 + i * 3] & 0xF8) << 8) | ((buf[2 + i * 3] & 0xFC) << 3) | (buf[3 + i * 3] >> 3);
+			*pixels++ = HighByte(color);
+			*pixels++ = LowByte(color);
+		}
+		pixels_count -= chunk;
+		command = MEM_READ_CONT;
+	}
+	SpiSetBitrate(ili9341_spi, SPI_BR);
+}
+
+void ILI9341WriteSubArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pixels, uint16_t stride){
+	static uint16_t i;
+
+	if ((width == 0) || (height == 0)){
+		return;
+	}
+	SetCursorPosition(x, y, x + width - 1, y + height - 1);
+	PixelStreamBegin();
+	for (i = 0; i < height; i++){
+		PixelStreamWrite(&pixels[(uint32_t)i * stride * 2], width * 2);
+	}
+	PixelStreamEnd();
+}
+
+bool ILI9341SpriteArea(int16_t x, int16_t y, const ili9341_image_t *image, const ili9341_area_t *clip, ili9341_area_t *area){
+	area->x0 = (x > 0) ? x : 0;
+	area->y0 = (y > 0) ? y : 0;
+	area->x1 = (x + image->width - 1 < lcd_orientation.width - 1) ? (x + image->width - 1) : (lcd_orientation.width - 1);
+	area->y1 = (y + image->height - 1 < lcd_orientation.height - 1) ? (y + image->height - 1) : (lcd_orientation.height - 1);
+	if (clip != NULL){
+		area->x0 = (clip->x0 > area->x0) ? clip->x0 : area->x0;
+		area->y0 = (clip->y0 > area->y0) ? clip->y0 : area->y0;
+		area->x1 = (clip->x1 < area->x1) ? clip->x1 : area->x1;
+		area->y1 = (clip->y1 < area->y1) ? clip->y1 : area->y1;
+	}
+	return (area->x0 <= area->x1) && (area->y0 <= area->y1);
+}
+
+bool ILI9341DrawSprite(int16_t x, int16_t y, const ili9341_image_t *image, uint32_t key, const ili9341_area_t *clip, const uint8_t *background){
+	uint16_t row[ILI9341_SPRITE_MAX_WIDTH];
+	image_decoder_t decoder;
+	ili9341_area_t area;
+	int16_t i, j, k;
+	uint32_t b;
+
+	if (!ImageValid(image) || (image->width > ILI9341_SPRITE_MAX_WIDTH)){
+		return false;
+	}
+	if (!ILI9341SpriteArea(x, y, image, clip, &area)){
+		return true;
+	}
+	decoder = (image_decoder_t){image, image->data, image->data + image->size, 0, false, 0, 8};
+	/* Rows above the visible area are decoded and discarded */
+	for (j = y; j < area.y0; j++){
+		ImageDecodeRow(&decoder, row);
+	}
+
+	if ((key == ILI9341_NO_KEY) || (background != NULL)){
+		/* The visible area in a single window */
+		SetCursorPosition(area.x0, area.y0, area.x1, area.y1);
+		PixelStreamBegin();
+		b = 0;
+		for (j = area.y0; j <= area.y1; j++){
+			ImageDecodeRow(&decoder, row);
+			for (i = area.x0; i <= area.x1; i++, b += 2){
+				if (row[i - x] == key){
+					PixelStreamPut((background[b] << 8) | background[b + 1]);
+				} else{
+					PixelStreamPut(row[i - x]);
+				}
+			}
+		}
+		PixelStreamEnd();
+		return true;
+	}
+	/* Transparent pixels aren't written: each run of visible pixels in its own window */
+	for (j = area.y0; j <= area.y1; j++){
+		ImageDecodeRow(&decoder, row);
+		for (i = area.x0; i <= area.x1; i++){
+			if (row[i - x] == key){
+				continue;
+			}
+			k = i;
+			while ((i < area.x1) && (row[i + 1 - x] != key)){
+				i++;
+			}
+			SetCursorPosition(k, j, i, j);
+			PixelStreamBegin();
+			for (; k <= i; k++){
+				PixelStreamPut(row[k - x]);
+			}
+			PixelStreamEnd();
+		}
+	}
+	return true;
+}
+
+uint16_t ILI9341GetWidth(void){
+	return lcd_orientation.width;
+}
+
+uint16_t ILI9341GetHeight(void){
+	return lcd_orientation.height;
+}
+
+ili9341_orientation_t ILI9341GetOrientation(void){
+	return lcd_orientation.orientation;
+}
+
+void ILI9341SetScrollArea(uint16_t top_fixed, uint16_t lines){
+	uint16_t bottom_fixed;
+	if (top_fixed > ILI9341_HEIGHT){
+		top_fixed = ILI9341_HEIGHT;
+	}
+	if (lines > ILI9341_HEIGHT - top_fixed){
+		lines = ILI9341_HEIGHT - top_fixed;
+	}
+	bottom_fixed = ILI9341_HEIGHT - top_fixed - lines;
+	uint8_t scroll_def[] = {HighByte(top_fixed), LowByte(top_fixed), HighByte(lines), LowByte(lines),
+		HighByte(bottom_fixed), LowByte(bottom_fixed)};
+	lcd_cmd_t lcd_scroll_def = {VERT_SCROLL_DEF, sizeof(scroll_def), scroll_def};
+	WriteLCD(&lcd_scroll_def);
+}
+
+void ILI9341Scroll(uint16_t line){
+	uint8_t scroll_start[] = {HighByte(line), LowByte(line)};
+	lcd_cmd_t lcd_scroll_start = {VERT_SCROLL_START, sizeof(scroll_start), scroll_start};
+	WriteLCD(&lcd_scroll_start);
 }
 
 uint8_t ILI9341DeInit(void){
+	SpiQueueWait(ili9341_spi, 0);
 	return 0;
 }
 
@@ -0,0 +1,311 @@
+/**
+ * @file ili9341_assets.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ili9341_assets.h"
+#include <stddef.h>
+#include <string.h>
+#include "esp_partition.h"
+/*==================[macros and definitions]=================================*/
+#define ASSETS_MAGIC		0x53414C49	/*!< "ILAS" */
+#define ASSETS_VERSION		1
+#define HEADER_SIZE			12
+#define ENTRY_SIZE			32
+#define FIRST_CHAR			' '			/*!< First character in the fonts */
+#define LAST_CHAR			'~'			/*!< Last character in the fonts */
+/* Headers of the assets (the arrays follow them) */
+#define IMAGE_HEADER		12			/*!< Width, height (16 bits), format, bpp (8 bits), colors (16 bits), data size (32 bits) */
+#define FONT_HEADER			8			/*!< Height (8 bits), reserved, characters (16 bits), data size (32 bits) */
+#define AA_FONT_HEADER		12			/*!< Height, bpp, rle, first, last, reserved (8 bits), characters (16 bits), data size (32 bits) */
+#define ICONS_HEADER		12			/*!< Height, width (8 bits), icon size, icons, reserved (16 bits), data size (32 bits) */
+
+/* The info arrays are used in place: the layout must be the one written by assets2ili9341.py */
+_Static_assert((sizeof(char_info_t) == 4) && (offsetof(char_info_t, offset) == 2), "char_info_t layout");
+_Static_assert((sizeof(aa_char_info_t) == 8) && (offsetof(aa_char_info_t, offset) == 4), "aa_char_info_t layout");
+/*==================[internal data declaration]==============================*/
+/**
+ * @brief Index entry (see ili9341_assets.h)
+ */
+typedef struct {
+	char name[ILI9341_ASSETS_NAME_LEN];
+	uint8_t type;
+	uint8_t reserved[3];
+	uint32_t offset;
+	uint32_t size;
+} asset_entry_t;
+
+_Static_assert(sizeof(asset_entry_t) == ENTRY_SIZE, "asset_entry_t layout");
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const uint8_t *assets = NULL;			/*!< Mapped partition */
+static uint32_t assets_size = 0;				/*!< Mapped bytes */
+static uint16_t assets_count = 0;
+static const asset_entry_t *assets_index;
+static esp_partition_mmap_handle_t assets_handle;
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static inline uint16_t Read16(const uint8_t *p){
+	return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t Read32(const uint8_t *p){
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Index entry of an asset (binary search, the index is sorted by name)
+ */
+static const asset_entry_t *AssetEntry(const char *name){
+	int32_t first = 0, last = (int32_t)assets_count - 1, middle;
+	int cmp;
+
+	while (first <= last){
+		middle = (first + last) / 2;
+		cmp = strncmp(name, assets_index[middle].name, ILI9341_ASSETS_NAME_LEN);
+		if (cmp == 0){
+			return &assets_index[middle];
+		}
+		if (cmp < 0){
+			last = middle - 1;
+		} else{
+			first = middle + 1;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Asset of a type, NULL if it isn't in the partition or is shorter than header bytes
+ */
+static const uint8_t *AssetGet(const char *name, ili9341_asset_type_t type, uint32_t header, uint32_t *size){
+	const asset_entry_t *entry = AssetEntry(name);
+
+	if ((entry == NULL) || (entry->type != type) || (entry->size < header)){
+		return NULL;
+	}
+	*size = entry->size;
+	return &assets[entry->offset];
+}
+
+/**
+ * @brief Bytes of an anti-aliased glyph (as read by AADecode() in ili9341.c), more than avail if
+ * its runs don't end in the avail bytes
+ */
+static uint32_t AAGlyphSize(const uint8_t *data, uint32_t avail, uint8_t width, uint8_t height, uint8_t bpp, bool rle){
+	uint32_t pixels = (uint32_t)width * height, run, i = 0;
+	uint8_t mask = (1 << (8 - bpp)) - 1;
+
+	if (!rle){
+		return (pixels * bpp + 7) / 8;
+	}
+	while (pixels > 0){
+		if (i >= avail){
+			return avail + 1;
+		}
+		run = (data[i] & mask) + 1;
+		if ((data[i] & mask) == mask){
+			/* Long run: length continues in the next byte */
+			if (++i >= avail){
+				return avail + 1;
+			}
+			run += data[i];
+		}
+		i++;
+		pixels -= (run < pixels) ? run : pixels;
+	}
+	return i;
+}
+/*==================[external functions definition]==========================*/
+bool ILI9341AssetsInit(const char *label){
+	const esp_partition_t *partition;
+	uint8_t header[HEADER_SIZE];
+	uint32_t used;
+	const void *map;
+
+	ILI9341AssetsDeinit();
+	partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ILI9341_ASSETS_SUBTYPE, label);
+	if ((partition == NULL) || (esp_partition_read(partition, 0, header, HEADER_SIZE) != ESP_OK)){
+		return false;
+	}
+	used = Read32(&header[8]);
+	if ((Read32(&header[0]) != ASSETS_MAGIC) || (Read16(&header[4]) != ASSETS_VERSION) ||
+		(used > partition->size) || (used < HEADER_SIZE + (uint32_t)Read16(&header[6]) * ENTRY_SIZE)){
+		return false;
+	}
+	/* Only the used bytes are mapped (the partition can be bigger) */
+	if (esp_partition_mmap(partition, 0, used, ESP_PARTITION_MMAP_DATA, &map, &assets_handle) != ESP_OK){
+		return false;
+	}
+	assets = map;
+	assets_size = used;
+	assets_index = (const asset_entry_t *)&assets[HEADER_SIZE];
+	assets_count = Read16(&header[6]);
+	/* Assets out of the partition are never returned */
+	for (uint16_t i = 0; i < assets_count; i++){
+		if ((assets_index[i].offset > assets_size) || (assets_index[i].size > assets_size - assets_index[i].offset) ||
+			(assets_index[i].offset % 4 != 0)){
+			ILI9341AssetsDeinit();
+			return false;
+		}
+	}
+	return true;
+}
+
+uint16_t ILI9341AssetsCount(void){
+	return assets_count;
+}
+
+bool ILI9341AssetsFind(const char *name, ili9341_asset_type_t *type, uint32_t *size){
+	const asset_entry_t *entry = AssetEntry(name);
+
+	if (entry == NULL){
+		return false;
+	}
+	if (type != NULL){
+		*type = entry->type;
+	}
+	if (size != NULL){
+		*size = entry->size;
+	}
+	return true;
+}
+
+bool ILI9341AssetsImage(const char *name, ili9341_image_t *image){
+	uint32_t size, colors, data_size;
+	const uint8_t *asset = AssetGet(name, ILI9341_ASSET_IMAGE, IMAGE_HEADER, &size);
+
+	if (asset == NULL){
+		return false;
+	}
+	colors = Read16(&asset[6]);
+	data_size = Read32(&asset[8]);
+	/* Sizes are compared with what is left, so a corrupted data_size can't overflow the sum */
+	if ((colors * 2 > size - IMAGE_HEADER) || (data_size > size - IMAGE_HEADER - colors * 2)){
+		return false;
+	}
+	/* Indexes aren't checked while drawing: the palette must have a color for every index value */
+	if (((asset[4] == ILI9341_IMAGE_PALETTE) && ((asset[5] > 8) || (colors < (1U << asset[5])))) ||
+		((asset[4] == ILI9341_IMAGE_PALETTE_RLE) && (colors < 256))){
+		return false;
+	}
+	image->width = Read16(&asset[0]);
+	image->height = Read16(&asset[2]);
+	image->format = asset[4];
+	image->bpp = asset[5];
+	image->palette = (colors > 0) ? (const uint16_t *)&asset[IMAGE_HEADER] : NULL;
+	image->data = &asset[IMAGE_HEADER + colors * 2];
+	image->size = data_size;
+	return true;
+}
+
+bool ILI9341AssetsFont(const char *name, Font_t *font){
+	uint32_t size;
+	const uint8_t *asset = AssetGet(name, ILI9341_ASSET_FONT, FONT_HEADER, &size);
+	const char_info_t *info;
+	uint32_t chars, data_size;
+
+	if (asset == NULL){
+		return false;
+	}
+	chars = Read16(&asset[2]);
+	data_size = Read32(&asset[4]);
+	if ((chars != LAST_CHAR - FIRST_CHAR + 1) || (chars * sizeof(char_info_t) > size - FONT_HEADER) ||
+		(data_size > size - FONT_HEADER - chars * sizeof(char_info_t))){
+		return false;
+	}
+	/* Glyphs must be inside the font array (rows of whole bytes) */
+	info = (const char_info_t *)&asset[FONT_HEADER];
+	for (uint32_t i = 0; i < chars; i++){
+		if ((info[i].offset > data_size) || ((uint32_t)asset[0] * ((info[i].width + 7) / 8) > data_size - info[i].offset)){
+			return false;
+		}
+	}
+	font->font_height = asset[0];
+	/* Font_t isn't const, but the drawing functions only read the info array */
+	font->info = (char_info_t *)&asset[FONT_HEADER];
+	font->data = &asset[FONT_HEADER + chars * sizeof(char_info_t)];
+	return true;
+}
+
+bool ILI9341AssetsAAFont(const char *name, aa_font_t *font){
+	uint32_t size;
+	const uint8_t *asset = AssetGet(name, ILI9341_ASSET_AA_FONT, AA_FONT_HEADER, &size);
+	const aa_char_info_t *info;
+	uint32_t map_size, info_offset, chars, data_size;
+
+	if ((asset == NULL) || (asset[4] < asset[3]) || ((asset[1] != 2) && (asset[1] != 4))){
+		return false;
+	}
+	map_size = asset[4] - asset[3] + 1;
+	info_offset = (AA_FONT_HEADER + map_size + 3) & ~3;
+	chars = Read16(&asset[6]);
+	data_size = Read32(&asset[8]);
+	if ((info_offset > size) || (chars * sizeof(aa_char_info_t) > size - info_offset) ||
+		(data_size > size - info_offset - chars * sizeof(aa_char_info_t))){
+		return false;
+	}
+	/* Map entries must point to the info array */
+	for (uint32_t i = 0; i < map_size; i++){
+		if ((asset[AA_FONT_HEADER + i] != AA_FONT_NO_CHAR) && (asset[AA_FONT_HEADER + i] >= chars)){
+			return false;
+		}
+	}
+	/* Glyphs must be inside the font array */
+	info = (const aa_char_info_t *)&asset[info_offset];
+	for (uint32_t i = 0; i < chars; i++){
+		if ((info[i].offset > data_size) ||
+			(AAGlyphSize(&asset[info_offset + chars * sizeof(aa_char_info_t) + info[i].offset], data_size - info[i].offset,
+				info[i].width, asset[0], asset[1], asset[2] != 0) > data_size - info[i].offset)){
+			return false;
+		}
+	}
+	font->font_height = asset[0];
+	font->bpp = asset[1];
+	font->rle = (asset[2] != 0);
+	font->first = asset[3];
+	font->last = asset[4];
+	font->map = &asset[AA_FONT_HEADER];
+	font->info = (const aa_char_info_t *)&asset[info_offset];
+	font->data = &asset[info_offset + chars * sizeof(aa_char_info_t)];
+	return true;
+}
+
+bool ILI9341AssetsIcons(const char *name, icon_font_t *icons){
+	uint32_t size;
+	const uint8_t *asset = AssetGet(name, ILI9341_ASSET_ICONS, ICONS_HEADER, &size);
+	uint32_t data_size;
+
+	if (asset == NULL){
+		return false;
+	}
+	data_size = Read32(&asset[8]);
+	if ((data_size > size - ICONS_HEADER) || ((uint32_t)Read16(&asset[2]) * Read16(&asset[4]) > data_size)){
+		return false;
+	}
+	icons->height = asset[0];
+	icons->width = asset[1];
+	icons->offset = Read16(&asset[2]);
+	icons->data = &asset[ICONS_HEADER];
+	return true;
+}
+
+void ILI9341AssetsDeinit(void){
+	if (assets != NULL){
+		esp_partition_munmap(assets_handle);
+	}
+	assets = NULL;
+	assets_size = 0;
+	assets_count = 0;
+}
+
+/*==================[end of file]============================================*/
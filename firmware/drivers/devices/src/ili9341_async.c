@@ -0,0 +1,457 @@
+/**
+ * @file ili9341_async.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ili9341_async.h"
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+/*==================[macros and definitions]=================================*/
+#define ASYNC_STACK		3072
+#define ASYNC_PRIORITY	4
+#define FIRST_CHAR		' '		/*!< First character in the fonts */
+#define LAST_CHAR		'~'		/*!< Last character in the fonts */
+#define CHAR_SPACE		1		/*!< Pixels between characters in a string */
+/**
+ * @brief Command types
+ */
+typedef enum {
+	CMD_NONE,				/*!< Dropped command */
+	CMD_FILL,
+	CMD_PIXEL,
+	CMD_LINE,
+	CMD_RECTANGLE,
+	CMD_FILLED_RECTANGLE,
+	CMD_CIRCLE,
+	CMD_FILLED_CIRCLE,
+	CMD_TRIANGLE,
+	CMD_FILLED_TRIANGLE,
+	CMD_STRING,
+	CMD_INT,
+	CMD_ICON,
+	CMD_PICTURE,
+	CMD_IMAGE,
+	CMD_SYNC,				/*!< Wakes up ILI9341AsyncWait() */
+} async_cmd_type_t;
+
+/**
+ * @brief Drawing command
+ */
+typedef struct {
+	uint8_t type;			/*!< async_cmd_type_t */
+	uint8_t arg;			/*!< Digits (CMD_INT), icon (CMD_ICON) */
+	uint16_t color;			/*!< Color or foreground */
+	uint16_t background;
+	int16_t x[3];			/*!< Coordinates, radius (circles), width and height (pictures) */
+	int16_t y[3];
+	const void *data;		/*!< Font, icon font, picture or image */
+	union {
+		uint32_t num;		/*!< Number (CMD_INT), sync number (CMD_SYNC) */
+		char text[ILI9341_ASYNC_TEXT_LEN];
+	};
+} async_cmd_t;
+
+/**
+ * @brief Area of the LCD (inclusive)
+ */
+typedef struct {
+	int16_t x0, y0, x1, y1;
+} async_area_t;
+/*==================[internal data declaration]==============================*/
+static QueueHandle_t cmd_queue = NULL;
+static TaskHandle_t async_task_handle = NULL;
+/* A semaphore (not a task notification, so the waiting task can use its own notifications) */
+static SemaphoreHandle_t sync_sem = NULL;			/*!< Given by the service task at each CMD_SYNC */
+static SemaphoreHandle_t wait_mutex = NULL;			/*!< One ILI9341AsyncWait() at a time */
+static volatile uint32_t sync_done = 0;				/*!< Number of the last CMD_SYNC drawn */
+static uint32_t sync_count = 0;						/*!< Number of the last CMD_SYNC queued */
+static async_cmd_t batch[ILI9341_ASYNC_BATCH];		/*!< Commands being drawn */
+static async_area_t area[ILI9341_ASYNC_BATCH];		/*!< Area changed by each command */
+static bool opaque[ILI9341_ASYNC_BATCH];			/*!< The command paints every pixel of its area */
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/**
+ * @brief Width of a line of text (characters out of the font are skipped), 0 if there are no characters
+ */
+static int16_t AsyncTextWidth(const char *str, uint8_t len, Font_t *font, uint8_t spacing){
+	int16_t width = 0;
+	uint8_t n = 0;
+	for (uint8_t i = 0; i < len; i++){
+		if ((str[i] >= FIRST_CHAR) && (str[i] <= LAST_CHAR)){
+			width += font->info[str[i] - FIRST_CHAR].width + ((n > 0) ? spacing : 0);
+			n++;
+		}
+	}
+	return width;
+}
+
+/**
+ * @brief Area changed by a command and if it paints all of its pixels
+ *
+ * Commands whose area can't be known (strings in several lines or wrapped at the
+ * end of the LCD) take the entire LCD and aren't opaque.
+ */
+static bool AsyncArea(const async_cmd_t *cmd, async_area_t *a){
+	int16_t width = ILI9341GetWidth(), height = ILI9341GetHeight();
+	int16_t w;
+	uint8_t len;
+	bool solid = false;
+
+	a->x0 = 0;
+	a->y0 = 0;
+	a->x1 = width - 1;
+	a->y1 = height - 1;
+	switch(cmd->type){
+	case CMD_FILL:
+		solid = true;
+		break;
+	case CMD_PIXEL:
+	case CMD_LINE:
+	case CMD_RECTANGLE:
+	case CMD_FILLED_RECTANGLE:
+	case CMD_TRIANGLE:
+	case CMD_FILLED_TRIANGLE:
+		a->x0 = a->x1 = cmd->x[0];
+		a->y0 = a->y1 = cmd->y[0];
+		for (uint8_t i = 1; i < ((cmd->type >= CMD_TRIANGLE) ? 3 : (cmd->type == CMD_PIXEL) ? 1 : 2); i++){
+			a->x0 = (cmd->x[i] < a->x0) ? cmd->x[i] : a->x0;
+			a->x1 = (cmd->x[i] > a->x1) ? cmd->x[i] : a->x1;
+			a->y0 = (cmd->y[i] < a->y0) ? cmd->y[i] : a->y0;
+			a->y1 = (cmd->y[i] > a->y1) ? cmd->y[i] : a->y1;
+		}
+		/* Only rectangles given in order and inside the LCD are sure to be filled as they are */
+		solid = (cmd->type == CMD_FILLED_RECTANGLE) && (cmd->x[0] <= cmd->x[1]) && (cmd->y[0] <= cmd->y[1]) &&
+				(cmd->x[1] < width) && (cmd->y[1] < height);
+		break;
+	case CMD_CIRCLE:
+	case CMD_FILLED_CIRCLE:
+		a->x0 = cmd->x[0] - cmd->x[1];
+		a->x1 = cmd->x[0] + cmd->x[1];
+		a->y0 = cmd->y[0] - cmd->x[1];
+		a->y1 = cmd->y[0] + cmd->x[1];
+		break;
+	case CMD_STRING:
+	case CMD_INT:
+		if (cmd->type == CMD_INT){
+			/* Digits side by side, one pixel to the right (as ILI9341DrawInt()) */
+			w = 0;
+			for (uint32_t num = cmd->num, i = 0; i < cmd->arg; i++, num /= 10){
+				w += ((Font_t *)cmd->data)->info[num % 10 + '0' - FIRST_CHAR].width;
+			}
+			a->x0 = cmd->x[0] + 1;
+		} else{
+			for (len = 0; cmd->text[len] != '\0'; len++){
+				if ((cmd->text[len] == '\n') || (cmd->text[len] == '\r')){
+					return false;
+				}
+			}
+			w = AsyncTextWidth(cmd->text, len, (Font_t *)cmd->data, CHAR_SPACE);
+			a->x0 = cmd->x[0];
+		}
+		a->y0 = cmd->y[0];
+		if ((a->x0 + w > width) || (a->y0 + ((Font_t *)cmd->data)->font_height > height)){
+			/* Drawn char by char, wrapping at the end of the LCD */
+			a->x0 = 0;
+			a->y0 = 0;
+			return false;
+		}
+		a->x1 = a->x0 + w - 1;
+		a->y1 = a->y0 + ((Font_t *)cmd->data)->font_height - 1;
+		solid = (w > 0);
+		break;
+	case CMD_ICON:
+		a->x0 = cmd->x[0];
+		a->y0 = cmd->y[0];
+		if (a->x0 + ((icon_font_t *)cmd->data)->width > width){
+			a->x0 = 0;
+			a->y0 += ((icon_font_t *)cmd->data)->height;
+		}
+		a->x1 = a->x0 + ((icon_font_t *)cmd->data)->width - 1;
+		a->y1 = a->y0 + ((icon_font_t *)cmd->data)->height - 1;
+		break;
+	case CMD_PICTURE:
+	case CMD_IMAGE:
+		a->x0 = cmd->x[0];
+		a->y0 = cmd->y[0];
+		a->x1 = cmd->x[0] + cmd->x[1] - 1;
+		a->y1 = cmd->y[0] + cmd->y[1] - 1;
+		solid = (a->x1 < width) && (a->y1 < height);
+		if (cmd->type == CMD_IMAGE){
+			/* Only raw images with every pixel are known to cover their area */
+			const ili9341_image_t *image = (const ili9341_image_t *)cmd->data;
+			solid = solid && (image->format == ILI9341_IMAGE_RAW) && (image->data != NULL) &&
+				(image->size >= (uint32_t)image->width * image->height * 2);
+		}
+		break;
+	default:
+		break;
+	}
+	return solid;
+}
+
+/**
+ * @brief Area b covers area a
+ */
+static inline bool AsyncCovers(const async_area_t *b, const async_area_t *a){
+	return (b->x0 <= a->x0) && (b->y0 <= a->y0) && (b->x1 >= a->x1) && (b->y1 >= a->y1);
+}
+
+/**
+ * @brief Drops the commands hidden by later commands and merges adjacent filled rectangles
+ */
+static void AsyncOptimize(uint8_t n){
+	uint8_t i, j, last = ILI9341_ASYNC_BATCH;
+	async_cmd_t *a, *b;
+
+	for (i = 0; i < n; i++){
+		opaque[i] = AsyncArea(&batch[i], &area[i]);
+	}
+	/* Commands completely painted over by a later opaque command aren't drawn */
+	for (i = 0; i < n; i++){
+		if (batch[i].type == CMD_SYNC){
+			continue;
+		}
+		for (j = i + 1; j < n; j++){
+			if (opaque[j] && AsyncCovers(&area[j], &area[i])){
+				batch[i].type = CMD_NONE;
+				break;
+			}
+		}
+	}
+	/* Consecutive filled rectangles of the same color forming a rectangle are filled together */
+	for (i = 0; i < n; i++){
+		if (batch[i].type == CMD_NONE){
+			continue;
+		}
+		if ((batch[i].type == CMD_FILLED_RECTANGLE) && opaque[i] && (last < ILI9341_ASYNC_BATCH)){
+			a = &batch[last];
+			b = &batch[i];
+			if ((a->color == b->color) &&
+				(((a->y[0] == b->y[0]) && (a->y[1] == b->y[1]) && (b->x[0] <= a->x[1] + 1) && (a->x[0] <= b->x[1] + 1)) ||
+				 ((a->x[0] == b->x[0]) && (a->x[1] == b->x[1]) && (b->y[0] <= a->y[1] + 1) && (a->y[0] <= b->y[1] + 1)))){
+				a->x[0] = (b->x[0] < a->x[0]) ? b->x[0] : a->x[0];
+				a->y[0] = (b->y[0] < a->y[0]) ? b->y[0] : a->y[0];
+				a->x[1] = (b->x[1] > a->x[1]) ? b->x[1] : a->x[1];
+				a->y[1] = (b->y[1] > a->y[1]) ? b->y[1] : a->y[1];
+				b->type = CMD_NONE;
+				continue;
+			}
+		}
+		last = ((batch[i].type == CMD_FILLED_RECTANGLE) && opaque[i]) ? i : ILI9341_ASYNC_BATCH;
+	}
+}
+
+/**
+ * @brief Draws a command
+ */
+static void AsyncDraw(async_cmd_t *cmd){
+	switch(cmd->type){
+	case CMD_FILL:
+		ILI9341Fill(cmd->color);
+		break;
+	case CMD_PIXEL:
+		ILI9341DrawPixel(cmd->x[0], cmd->y[0], cmd->color);
+		break;
+	case CMD_LINE:
+		ILI9341DrawLine(cmd->x[0], cmd->y[0], cmd->x[1], cmd->y[1], cmd->color);
+		break;
+	case CMD_RECTANGLE:
+		ILI9341DrawRectangle(cmd->x[0], cmd->y[0], cmd->x[1], cmd->y[1], cmd->color);
+		break;
+	case CMD_FILLED_RECTANGLE:
+		ILI9341DrawFilledRectangle(cmd->x[0], cmd->y[0], cmd->x[1], cmd->y[1], cmd->color);
+		break;
+	case CMD_CIRCLE:
+		ILI9341DrawCircle(cmd->x[0], cmd->y[0], cmd->x[1], cmd->color);
+		break;
+	case CMD_FILLED_CIRCLE:
+		ILI9341DrawFilledCircle(cmd->x[0], cmd->y[0], cmd->x[1], cmd->color);
+		break;
+	case CMD_TRIANGLE:
+		ILI9341DrawTriangle(cmd->x[0], cmd->y[0], cmd->x[1], cmd->y[1], cmd->x[2], cmd->y[2], cmd->color);
+		break;
+	case CMD_FILLED_TRIANGLE:
+		ILI9341DrawFilledTriangle(cmd->x[0], cmd->y[0], cmd->x[1], cmd->y[1], cmd->x[2], cmd->y[2], cmd->color);
+		break;
+	case CMD_STRING:
+		ILI9341DrawString(cmd->x[0], cmd->y[0], cmd->text, (Font_t *)cmd->data, cmd->color, cmd->background);
+		break;
+	case CMD_INT:
+		ILI9341DrawInt(cmd->x[0], cmd->y[0], cmd->num, cmd->arg, (Font_t *)cmd->data, cmd->color, cmd->background);
+		break;
+	case CMD_ICON:
+		ILI9341DrawIcon(cmd->x[0], cmd->y[0], cmd->arg, (icon_font_t *)cmd->data, cmd->color, cmd->background);
+		break;
+	case CMD_PICTURE:
+		ILI9341DrawPicture(cmd->x[0], cmd->y[0], cmd->x[1], cmd->y[1], cmd->data);
+		break;
+	case CMD_IMAGE:
+		ILI9341DrawImage(cmd->x[0], cmd->y[0], cmd->data);
+		break;
+	case CMD_SYNC:
+		sync_done = cmd->num;
+		xSemaphoreGive(sync_sem);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Service task. Takes the queued commands in batches and draws them.
+ */
+static void ILI9341AsyncTask(void *pvParameter){
+	uint8_t n;
+	while(true){
+		xQueueReceive(cmd_queue, &batch[0], portMAX_DELAY);
+		n = 1;
+		/* Commands already waiting are drawn together (a sync ends the batch) */
+		while ((n < ILI9341_ASYNC_BATCH) && (batch[n - 1].type != CMD_SYNC) &&
+			   (xQueueReceive(cmd_queue, &batch[n], 0) == pdTRUE)){
+			n++;
+		}
+		AsyncOptimize(n);
+		for (uint8_t i = 0; i < n; i++){
+			AsyncDraw(&batch[i]);
+		}
+	}
+}
+
+/**
+ * @brief Queue a command without waiting
+ */
+static bool AsyncSend(const async_cmd_t *cmd){
+	if (cmd_queue == NULL){
+		return false;
+	}
+	return xQueueSend(cmd_queue, cmd, 0) == pdTRUE;
+}
+/*==================[external functions definition]==========================*/
+bool ILI9341AsyncInit(void){
+	if (async_task_handle != NULL){
+		return true;
+	}
+	cmd_queue = xQueueCreate(ILI9341_ASYNC_QUEUE_LEN, sizeof(async_cmd_t));
+	if (sync_sem == NULL){
+		sync_sem = xSemaphoreCreateBinary();
+	}
+	if (wait_mutex == NULL){
+		wait_mutex = xSemaphoreCreateMutex();
+	}
+	if ((cmd_queue == NULL) || (sync_sem == NULL) || (wait_mutex == NULL) ||
+		(xTaskCreate(&ILI9341AsyncTask, "ILI9341_ASYNC", ASYNC_STACK, NULL, ASYNC_PRIORITY, &async_task_handle) != pdPASS)){
+		if (cmd_queue != NULL){
+			vQueueDelete(cmd_queue);
+			cmd_queue = NULL;
+		}
+		async_task_handle = NULL;
+		return false;
+	}
+	return true;
+}
+
+bool ILI9341AsyncFill(uint16_t color){
+	async_cmd_t cmd = {.type = CMD_FILL, .color = color};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncPixel(uint16_t x, uint16_t y, uint16_t color){
+	async_cmd_t cmd = {.type = CMD_PIXEL, .color = color, .x = {x}, .y = {y}};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
+	async_cmd_t cmd = {.type = CMD_LINE, .color = color, .x = {x0, x1}, .y = {y0, y1}};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color, bool filled){
+	async_cmd_t cmd = {.type = filled ? CMD_FILLED_RECTANGLE : CMD_RECTANGLE, .color = color, .x = {x0, x1}, .y = {y0, y1}};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncCircle(int16_t x, int16_t y, int16_t r, uint16_t color, bool filled){
+	async_cmd_t cmd = {.type = filled ? CMD_FILLED_CIRCLE : CMD_CIRCLE, .color = color, .x = {x, r}, .y = {y}};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color, bool filled){
+	async_cmd_t cmd = {.type = filled ? CMD_FILLED_TRIANGLE : CMD_TRIANGLE, .color = color, .x = {x0, x1, x2}, .y = {y0, y1, y2}};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncString(uint16_t x, uint16_t y, const char *str, Font_t *font, uint16_t foreground, uint16_t background){
+	async_cmd_t cmd = {.type = CMD_STRING, .color = foreground, .background = background, .x = {x}, .y = {y}, .data = font};
+	uint8_t i;
+	for (i = 0; (i < ILI9341_ASYNC_TEXT_LEN - 1) && (str[i] != '\0'); i++){
+		cmd.text[i] = str[i];
+	}
+	cmd.text[i] = '\0';
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t *font, uint16_t foreground, uint16_t background){
+	async_cmd_t cmd = {.type = CMD_INT, .arg = dig, .color = foreground, .background = background, .x = {x}, .y = {y}, .data = font, .num = num};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t *icon_font, uint16_t foreground, uint16_t background){
+	async_cmd_t cmd = {.type = CMD_ICON, .arg = icon, .color = foreground, .background = background, .x = {x}, .y = {y}, .data = icon_font};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *pic){
+	async_cmd_t cmd = {.type = CMD_PICTURE, .x = {x, width}, .y = {y, height}, .data = pic};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncImage(uint16_t x, uint16_t y, const ili9341_image_t *image){
+	async_cmd_t cmd = {.type = CMD_IMAGE, .x = {x, image->width}, .y = {y, image->height}, .data = image};
+	return AsyncSend(&cmd);
+}
+
+bool ILI9341AsyncWait(uint32_t timeout_ms){
+	TickType_t start = xTaskGetTickCount(), timeout = pdMS_TO_TICKS(timeout_ms), elapsed;
+	async_cmd_t cmd = {.type = CMD_SYNC};
+	bool done = false;
+
+	if (cmd_queue == NULL){
+		return false;
+	}
+	if (xSemaphoreTake(wait_mutex, timeout) != pdTRUE){
+		return false;
+	}
+	cmd.num = ++sync_count;
+	elapsed = xTaskGetTickCount() - start;
+	if (elapsed > timeout){
+		elapsed = timeout;
+	}
+	if (xQueueSend(cmd_queue, &cmd, timeout - elapsed) == pdTRUE){
+		/* Syncs of previous waits that expired give the semaphore too: they are skipped */
+		while (!(done = ((int32_t)(sync_done - cmd.num) >= 0))){
+			elapsed = xTaskGetTickCount() - start;
+			if ((elapsed >= timeout) || (xSemaphoreTake(sync_sem, timeout - elapsed) != pdTRUE)){
+				break;
+			}
+		}
+	}
+	xSemaphoreGive(wait_mutex);
+	return done;
+}
+
+/*==================[end of file]============================================*/
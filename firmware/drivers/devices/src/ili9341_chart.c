@@ -0,0 +1,225 @@
+/**
+ * @file ili9341_chart.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ili9341_chart.h"
+#include <stddef.h>
+#include "spi_mcu.h"
+/*==================[macros and definitions]=================================*/
+#define CHART_ACROSS	ILI9341_WIDTH	/*!< Pixels of each line of the chart */
+#define CHART_LINES		ILI9341_HEIGHT	/*!< Frame memory lines (scroll axis) */
+
+#define Swap16(x) ((uint16_t)(((x) << 8) | ((x) >> 8)))	/*!< RGB565 color to wire byte order */
+/*==================[internal data declaration]==============================*/
+static ili9341_chart_config_t chart;		/*!< Configuration */
+static bool landscape;						/*!< Scroll axis is horizontal */
+static bool reversed;						/*!< Frame memory lines go against the screen coordinates */
+static uint16_t head;						/*!< Next line to write (screen coordinate along the scroll axis) */
+static uint16_t last_value;					/*!< Trace position of the previous sample */
+static bool has_last = false;				/*!< There is a previous sample */
+static uint32_t sample_count;				/*!< Samples pushed (for the time grid) */
+static uint16_t *line_buf = NULL;			/*!< Lines being written (DMA capable) */
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/**
+ * @brief Trace position (pixels from the bottom, or left, of the chart) of a sample
+ */
+static uint16_t ChartValue(uint16_t sample){
+	if (sample <= chart.min){
+		return 0;
+	}
+	if (sample >= chart.max){
+		return CHART_ACROSS - 1;
+	}
+	return (uint32_t)(sample - chart.min) * (CHART_ACROSS - 1) / (chart.max - chart.min);
+}
+
+/**
+ * @brief Renders one line of the chart: background, grid and the trace from the previous sample
+ * @param[in] line: index of the line in the batch
+ * @param[in] lines: lines in the batch
+ * @param[in] value: trace position of the sample
+ */
+static void ChartRenderLine(uint16_t line, uint16_t lines, uint16_t value){
+	uint16_t bg = Swap16(chart.background);
+	uint16_t grid = Swap16(chart.grid_color);
+	uint16_t trace = Swap16(chart.color);
+	uint16_t from, to, v;
+	uint32_t pos, step;
+	bool time_grid = (chart.grid_step != 0) && ((sample_count % chart.grid_step) == 0);
+
+	/* Pixel v of the line in the window: lines are columns in landscape (values from the bottom) */
+	if (landscape){
+		pos = (uint32_t)(CHART_ACROSS - 1) * lines + line;
+		step = lines;
+	} else{
+		pos = (uint32_t)line * CHART_ACROSS;
+		step = 1;
+	}
+	from = has_last ? last_value : value;
+	to = value;
+	if (from > to){
+		v = from;
+		from = to;
+		to = v;
+	}
+	for (v = 0; v < CHART_ACROSS; v++){
+		if ((v >= from) && (v <= to)){
+			line_buf[pos] = trace;
+		} else if (time_grid || ((chart.grid_step != 0) && ((v % chart.grid_step) == 0))){
+			line_buf[pos] = grid;
+		} else{
+			line_buf[pos] = bg;
+		}
+		if (landscape){
+			pos -= step;
+		} else{
+			pos += step;
+		}
+	}
+	last_value = value;
+	has_last = true;
+	sample_count++;
+}
+
+/**
+ * @brief Frame memory line shown at the start of the scrolling area after writing the line "written"
+ */
+static uint16_t ChartScrollLine(uint16_t written){
+	/* Newest line goes at the end of the chart: the next one (the oldest) is shown first */
+	if (reversed){
+		/* Frame memory lines go against the screen: the end of the chart is the start of the area */
+		return CHART_LINES - 1 - written;
+	}
+	written++;
+	if (written == chart.start + chart.length){
+		written = chart.start;
+	}
+	return written;
+}
+
+/*==================[external functions definition]==========================*/
+bool ILI9341ChartInit(const ili9341_chart_config_t *config){
+	if ((config->length == 0) || (config->start + config->length > CHART_LINES) || (config->max <= config->min)){
+		return false;
+	}
+	if (line_buf == NULL){
+		line_buf = SpiDmaMalloc(ILI9341_CHART_BATCH * CHART_ACROSS * sizeof(uint16_t));
+		if (line_buf == NULL){
+			return false;
+		}
+	}
+	chart = *config;
+	switch (ILI9341GetOrientation()){
+	case ILI9341_Portrait_1:
+		landscape = false;
+		reversed = false;
+		break;
+	case ILI9341_Portrait_2:
+		landscape = false;
+		reversed = true;
+		break;
+	case ILI9341_Landscape_1:
+		landscape = true;
+		reversed = false;
+		break;
+	case ILI9341_Landscape_2:
+		landscape = true;
+		reversed = true;
+		break;
+	}
+	if (reversed){
+		ILI9341SetScrollArea(CHART_LINES - chart.start - chart.length, chart.length);
+	} else{
+		ILI9341SetScrollArea(chart.start, chart.length);
+	}
+	ILI9341ChartClear();
+	return true;
+}
+
+void ILI9341ChartPush(const uint16_t *samples, uint16_t n){
+	uint16_t batch, i;
+
+	/* Not initialized */
+	if (line_buf == NULL){
+		return;
+	}
+	while (n > 0){
+		/* Lines of a batch are consecutive (they don't wrap at the end of the chart) */
+		batch = chart.start + chart.length - head;
+		if (batch > n){
+			batch = n;
+		}
+		if (batch > ILI9341_CHART_BATCH){
+			batch = ILI9341_CHART_BATCH;
+		}
+		for (i = 0; i < batch; i++){
+			ChartRenderLine(i, batch, ChartValue(samples[i]));
+		}
+		if (landscape){
+			ILI9341WriteArea(head, 0, batch, CHART_ACROSS, (uint8_t *)line_buf);
+		} else{
+			ILI9341WriteArea(0, head, CHART_ACROSS, batch, (uint8_t *)line_buf);
+		}
+		/* Scroll command waits the end of the area write, so the buffer can be used again */
+		ILI9341Scroll(ChartScrollLine(head + batch - 1));
+		head += batch;
+		if (head == chart.start + chart.length){
+			head = chart.start;
+		}
+		samples += batch;
+		n -= batch;
+	}
+}
+
+void ILI9341ChartClear(void){
+	uint16_t i;
+
+	/* Not initialized */
+	if (line_buf == NULL){
+		return;
+	}
+	head = chart.start;
+	has_last = false;
+	sample_count = 0;
+	ILI9341Scroll(reversed ? (CHART_LINES - chart.start - chart.length) : chart.start);
+	/* Background and horizontal grid lines */
+	if (landscape){
+		ILI9341DrawFilledRectangle(chart.start, 0, chart.start + chart.length - 1, CHART_ACROSS - 1, chart.background);
+	} else{
+		ILI9341DrawFilledRectangle(0, chart.start, CHART_ACROSS - 1, chart.start + chart.length - 1, chart.background);
+	}
+	if (chart.grid_step == 0){
+		return;
+	}
+	for (i = 0; i < CHART_ACROSS; i += chart.grid_step){
+		if (landscape){
+			ILI9341DrawLine(chart.start, CHART_ACROSS - 1 - i, chart.start + chart.length - 1, CHART_ACROSS - 1 - i, chart.grid_color);
+		} else{
+			ILI9341DrawLine(i, chart.start, i, chart.start + chart.length - 1, chart.grid_color);
+		}
+	}
+}
+
+void ILI9341ChartDeinit(void){
+	/* Whole LCD scrolling area without offset: same as no scrolling */
+	ILI9341SetScrollArea(0, CHART_LINES);
+	ILI9341Scroll(0);
+	SpiDmaFree(line_buf);
+	line_buf = NULL;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,575 @@
+/**
+ * @file ili9341_scene.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ili9341_scene.h"
+#include <stddef.h>
+#include <string.h>
+#include "spi_mcu.h"
+/*==================[macros and definitions]=================================*/
+#define FIRST_CHAR		' '		/*!< First character in the fonts */
+#define LAST_CHAR		'~'		/*!< Last character in the fonts */
+#define MSK_BIT8		0x80	/*!< 8th bit mask */
+#define CHAR_SPACE		1		/*!< Pixels between characters */
+
+#define Swap16(x) ((uint16_t)(((x) << 8) | ((x) >> 8)))	/*!< RGB565 color to wire byte order */
+/*==================[internal data declaration]==============================*/
+/**
+ * @brief Area of the screen (inclusive limits)
+ */
+typedef struct {
+	int16_t x0;
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+} rect_t;
+
+/**
+ * @brief Item types
+ */
+typedef enum {
+	ITEM_FREE = 0,
+	ITEM_RECT,
+	ITEM_FILLED_RECT,
+	ITEM_LINE,
+	ITEM_CIRCLE,
+	ITEM_FILLED_CIRCLE,
+	ITEM_TEXT,
+	ITEM_PICTURE
+} item_type_t;
+
+/**
+ * @brief Scene item
+ */
+typedef struct {
+	item_type_t type;
+	bool visible;
+	uint16_t color;
+	int16_t x0;				/*!< Top left corner, start point or center */
+	int16_t y0;
+	int16_t x1;				/*!< End point (lines) */
+	int16_t y1;
+	uint16_t width;			/*!< Rectangle and picture size, circle radius */
+	uint16_t height;
+	const void *data;		/*!< String or picture */
+	Font_t *font;
+	rect_t bbox;			/*!< Area covered by the item */
+} item_t;
+
+static item_t items[ILI9341_SCENE_MAX_ITEMS];		/*!< Display list (in drawing order) */
+static rect_t dirty[ILI9341_SCENE_MAX_DIRTY];		/*!< Areas to redraw */
+static uint8_t n_dirty = 0;
+static uint16_t bg_color;							/*!< Background (wire byte order) */
+static uint16_t *strip_buf[2] = {NULL, NULL};		/*!< Render strips: one is rendered while the other is sent */
+static uint8_t strip_idx = 0;
+static uint32_t strip_pixels;						/*!< Size of each strip */
+/* Strip being rendered */
+static uint16_t *buf;								/*!< Pixels */
+static rect_t clip;									/*!< Area of the screen */
+static uint16_t stride;								/*!< Pixels per row */
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static inline int32_t RectArea(const rect_t *r){
+	return (int32_t)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+}
+
+static inline rect_t RectUnion(const rect_t *a, const rect_t *b){
+	rect_t u = {
+		(a->x0 < b->x0) ? a->x0 : b->x0,
+		(a->y0 < b->y0) ? a->y0 : b->y0,
+		(a->x1 > b->x1) ? a->x1 : b->x1,
+		(a->y1 > b->y1) ? a->y1 : b->y1
+	};
+	return u;
+}
+
+static inline bool RectIntersect(const rect_t *a, const rect_t *b){
+	return (a->x0 <= b->x1) && (b->x0 <= a->x1) && (a->y0 <= b->y1) && (b->y0 <= a->y1);
+}
+
+/**
+ * @brief Adds an area to the dirty list. Areas that are cheaper to redraw
+ * together than separately are merged.
+ */
+static void SceneDirty(rect_t r){
+	uint8_t best = 0;
+	int32_t growth, best_growth = INT32_MAX;
+	bool merged;
+	/* Clip to screen */
+	if (r.x0 < 0) r.x0 = 0;
+	if (r.y0 < 0) r.y0 = 0;
+	if (r.x1 >= ILI9341GetWidth()) r.x1 = ILI9341GetWidth() - 1;
+	if (r.y1 >= ILI9341GetHeight()) r.y1 = ILI9341GetHeight() - 1;
+	if ((r.x0 > r.x1) || (r.y0 > r.y1)){
+		return;
+	}
+	do{
+		merged = false;
+		for (uint8_t i = 0; i < n_dirty; i++){
+			rect_t u = RectUnion(&r, &dirty[i]);
+			if (RectArea(&u) <= RectArea(&r) + RectArea(&dirty[i])){
+				/* Merge and check again against the other areas */
+				r = u;
+				dirty[i] = dirty[--n_dirty];
+				merged = true;
+				break;
+			}
+		}
+	} while(merged);
+	if (n_dirty < ILI9341_SCENE_MAX_DIRTY){
+		dirty[n_dirty++] = r;
+		return;
+	}
+	/* List full: merge with the area that grows less */
+	for (uint8_t i = 0; i < n_dirty; i++){
+		rect_t u = RectUnion(&r, &dirty[i]);
+		growth = RectArea(&u) - RectArea(&dirty[i]);
+		if (growth < best_growth){
+			best_growth = growth;
+			best = i;
+		}
+	}
+	dirty[best] = RectUnion(&r, &dirty[best]);
+}
+
+/**
+ * @brief Width of a single line text in pixels
+ */
+static uint16_t TextWidth(const char *str, Font_t *font){
+	uint16_t w = 0;
+	while (*str != '\0'){
+		if ((*str >= FIRST_CHAR) && (*str <= LAST_CHAR)){
+			w += font->info[*str - FIRST_CHAR].width + CHAR_SPACE;
+		}
+		str++;
+	}
+	return (w > 0) ? (w - CHAR_SPACE) : 0;
+}
+
+/**
+ * @brief Computes the area covered by an item
+ */
+static void ItemBbox(item_t *item){
+	switch(item->type){
+	case ITEM_RECT:
+	case ITEM_FILLED_RECT:
+	case ITEM_PICTURE:
+		item->bbox = (rect_t){item->x0, item->y0, item->x0 + item->width - 1, item->y0 + item->height - 1};
+		break;
+	case ITEM_LINE:
+		item->bbox = (rect_t){item->x0, item->y0, item->x1, item->y1};
+		if (item->x0 > item->x1){
+			item->bbox.x0 = item->x1;
+			item->bbox.x1 = item->x0;
+		}
+		if (item->y0 > item->y1){
+			item->bbox.y0 = item->y1;
+			item->bbox.y1 = item->y0;
+		}
+		break;
+	case ITEM_CIRCLE:
+	case ITEM_FILLED_CIRCLE:
+		item->bbox = (rect_t){item->x0 - item->width, item->y0 - item->width, item->x0 + item->width, item->y0 + item->width};
+		break;
+	case ITEM_TEXT:
+		item->bbox = (rect_t){item->x0, item->y0, item->x0 + TextWidth(item->data, item->font) - 1, item->y0 + item->font->font_height - 1};
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Takes a free item from the display list
+ */
+static ili9341_item_t ItemNew(item_type_t type, int16_t x, int16_t y, uint16_t color){
+	for (ili9341_item_t i = 0; i < ILI9341_SCENE_MAX_ITEMS; i++){
+		if (items[i].type == ITEM_FREE){
+			memset(&items[i], 0, sizeof(item_t));
+			items[i].type = type;
+			items[i].visible = true;
+			items[i].x0 = x;
+			items[i].y0 = y;
+			items[i].color = color;
+			return i;
+		}
+	}
+	return ILI9341_SCENE_NO_ITEM;
+}
+
+/**
+ * @brief Marks the area of a new or changed item as dirty
+ */
+static ili9341_item_t ItemCommit(ili9341_item_t item){
+	if (item != ILI9341_SCENE_NO_ITEM){
+		ItemBbox(&items[item]);
+		SceneDirty(items[item].bbox);
+	}
+	return item;
+}
+
+static inline bool ItemValid(ili9341_item_t item){
+	return (item < ILI9341_SCENE_MAX_ITEMS) && (items[item].type != ITEM_FREE);
+}
+
+/**
+ * @brief Draws a horizontal run of pixels in the strip (clipped)
+ */
+static inline void StripSpan(int16_t xa, int16_t xb, int16_t y, uint16_t color){
+	uint16_t *p;
+	if ((y < clip.y0) || (y > clip.y1)){
+		return;
+	}
+	if (xa < clip.x0) xa = clip.x0;
+	if (xb > clip.x1) xb = clip.x1;
+	p = &buf[(y - clip.y0) * stride + (xa - clip.x0)];
+	for (int16_t x = xa; x <= xb; x++){
+		*p++ = color;
+	}
+}
+
+static inline void StripPixel(int16_t x, int16_t y, uint16_t color){
+	if ((x >= clip.x0) && (x <= clip.x1) && (y >= clip.y0) && (y <= clip.y1)){
+		buf[(y - clip.y0) * stride + (x - clip.x0)] = color;
+	}
+}
+
+static uint16_t ISqrt(uint32_t n){
+	uint32_t root = 0, bit = 1UL << 30;
+	while (bit > n){
+		bit >>= 2;
+	}
+	while (bit != 0){
+		if (n >= root + bit){
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		} else{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+/**
+ * @brief Draws the part of an item that falls in the strip
+ */
+static void ItemRender(const item_t *item){
+	uint16_t color = Swap16(item->color);
+	int16_t ya = (item->bbox.y0 > clip.y0) ? item->bbox.y0 : clip.y0;
+	int16_t yb = (item->bbox.y1 < clip.y1) ? item->bbox.y1 : clip.y1;
+
+	switch(item->type){
+	case ITEM_FILLED_RECT:
+		for (int16_t y = ya; y <= yb; y++){
+			StripSpan(item->bbox.x0, item->bbox.x1, y, color);
+		}
+		break;
+	case ITEM_RECT:
+		StripSpan(item->bbox.x0, item->bbox.x1, item->bbox.y0, color);
+		StripSpan(item->bbox.x0, item->bbox.x1, item->bbox.y1, color);
+		for (int16_t y = ya; y <= yb; y++){
+			StripPixel(item->bbox.x0, y, color);
+			StripPixel(item->bbox.x1, y, color);
+		}
+		break;
+	case ITEM_LINE:{
+		/* Bresenham */
+		int16_t x = item->x0, y = item->y0;
+		int16_t dx = (item->x1 > item->x0) ? (item->x1 - item->x0) : (item->x0 - item->x1);
+		int16_t dy = (item->y1 > item->y0) ? (item->y0 - item->y1) : (item->y1 - item->y0);
+		int16_t sx = (item->x1 > item->x0) ? 1 : -1;
+		int16_t sy = (item->y1 > item->y0) ? 1 : -1;
+		int32_t error = dx + dy, error_2;
+		while (1){
+			StripPixel(x, y, color);
+			if ((x == item->x1) && (y == item->y1)){
+				break;
+			}
+			error_2 = 2 * error;
+			if (error_2 >= dy){
+				error += dy;
+				x += sx;
+			}
+			if (error_2 <= dx){
+				error += dx;
+				y += sy;
+			}
+		}
+		break;
+	}
+	case ITEM_CIRCLE:{
+		/* Midpoint circle */
+		int16_t x = 0, y = item->width;
+		int16_t f = 1 - item->width, ddf_x = 1, ddf_y = -2 * item->width;
+		int16_t cx = item->x0, cy = item->y0;
+		StripPixel(cx, cy + y, color);
+		StripPixel(cx, cy - y, color);
+		StripPixel(cx + y, cy, color);
+		StripPixel(cx - y, cy, color);
+		while (x < y){
+			if (f >= 0){
+				y--;
+				ddf_y += 2;
+				f += ddf_y;
+			}
+			x++;
+			ddf_x += 2;
+			f += ddf_x;
+			StripPixel(cx + x, cy + y, color);
+			StripPixel(cx - x, cy + y, color);
+			StripPixel(cx + x, cy - y, color);
+			StripPixel(cx - x, cy - y, color);
+			StripPixel(cx + y, cy + x, color);
+			StripPixel(cx - y, cy + x, color);
+			StripPixel(cx + y, cy - x, color);
+			StripPixel(cx - y, cy - x, color);
+		}
+		break;
+	}
+	case ITEM_FILLED_CIRCLE:{
+		/* One span per row */
+		int32_t r2 = (int32_t)item->width * item->width;
+		for (int16_t y = ya; y <= yb; y++){
+			int32_t dy = y - item->y0;
+			int16_t dx = ISqrt(r2 - dy * dy);
+			StripSpan(item->x0 - dx, item->x0 + dx, y, color);
+		}
+		break;
+	}
+	case ITEM_TEXT:{
+		const char *str = item->data;
+		Font_t *font = item->font;
+		int16_t x = item->x0;
+		while (*str != '\0'){
+			if ((*str >= FIRST_CHAR) && (*str <= LAST_CHAR)){
+				const char_info_t *info = &font->info[*str - FIRST_CHAR];
+				uint16_t bytes_row = (info->width + 7) / 8;
+				/* Only the columns of the character that fall in the strip */
+				int16_t ja = (clip.x0 > x) ? (clip.x0 - x) : 0;
+				int16_t jb = (clip.x1 < x + info->width - 1) ? (clip.x1 - x) : (info->width - 1);
+				for (int16_t y = ya; (y <= yb) && (ja <= jb); y++){
+					const uint8_t *row = &font->data[info->offset + (y - item->y0) * bytes_row];
+					uint16_t *p = &buf[(y - clip.y0) * stride + (x + ja - clip.x0)];
+					for (int16_t j = ja; j <= jb; j++, p++){
+						if (row[j / 8] & (MSK_BIT8 >> (j % 8))){
+							*p = color;
+						}
+					}
+				}
+				x += info->width + CHAR_SPACE;
+			}
+			str++;
+		}
+		break;
+	}
+	case ITEM_PICTURE:{
+		/* Picture bytes are already in wire order */
+		int16_t xa = (item->bbox.x0 > clip.x0) ? item->bbox.x0 : clip.x0;
+		int16_t xb = (item->bbox.x1 < clip.x1) ? item->bbox.x1 : clip.x1;
+		const uint8_t *pic = item->data;
+		for (int16_t y = ya; y <= yb; y++){
+			memcpy(&buf[(y - clip.y0) * stride + (xa - clip.x0)],
+				&pic[((y - item->y0) * item->width + (xa - item->x0)) * 2], (xb - xa + 1) * 2);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Renders a dirty area by strips and sends it to the display
+ */
+static void SceneRenderArea(const rect_t *area){
+	uint16_t rows;
+	uint32_t n;
+	stride = area->x1 - area->x0 + 1;
+	/* Narrow areas are rendered in taller strips */
+	rows = strip_pixels / stride;
+	for (int16_t y = area->y0; y <= area->y1; y += rows){
+		clip.x0 = area->x0;
+		clip.x1 = area->x1;
+		clip.y0 = y;
+		clip.y1 = (y + rows - 1 < area->y1) ? (y + rows - 1) : area->y1;
+		/* The other strip may still be in transfer, this one is free */
+		strip_idx ^= 1;
+		buf = strip_buf[strip_idx];
+		n = (uint32_t)stride * (clip.y1 - clip.y0 + 1);
+		for (uint32_t i = 0; i < n; i++){
+			buf[i] = bg_color;
+		}
+		for (uint8_t i = 0; i < ILI9341_SCENE_MAX_ITEMS; i++){
+			if ((items[i].type != ITEM_FREE) && items[i].visible && RectIntersect(&items[i].bbox, &clip)){
+				ItemRender(&items[i]);
+			}
+		}
+		ILI9341WriteArea(clip.x0, clip.y0, stride, clip.y1 - clip.y0 + 1, (const uint8_t *)buf);
+	}
+}
+/*==================[external functions definition]==========================*/
+
+bool ILI9341SceneInit(uint16_t background, uint16_t strip_rows){
+	if (strip_rows == 0){
+		strip_rows = ILI9341_SCENE_STRIP_ROWS;
+	}
+	/* Strips must hold at least one row in any orientation */
+	strip_pixels = (uint32_t)ILI9341_HEIGHT * strip_rows;
+	if (strip_buf[0] == NULL){
+		strip_buf[0] = SpiDmaMalloc(strip_pixels * sizeof(uint16_t));
+		strip_buf[1] = SpiDmaMalloc(strip_pixels * sizeof(uint16_t));
+		if ((strip_buf[0] == NULL) || (strip_buf[1] == NULL)){
+			SpiDmaFree(strip_buf[0]);
+			SpiDmaFree(strip_buf[1]);
+			strip_buf[0] = NULL;
+			strip_buf[1] = NULL;
+			return false;
+		}
+	}
+	ILI9341SceneClear(background);
+	return true;
+}
+
+void ILI9341SceneClear(uint16_t background){
+	for (uint8_t i = 0; i < ILI9341_SCENE_MAX_ITEMS; i++){
+		items[i].type = ITEM_FREE;
+	}
+	bg_color = Swap16(background);
+	n_dirty = 0;
+	SceneDirty((rect_t){0, 0, ILI9341GetWidth() - 1, ILI9341GetHeight() - 1});
+}
+
+ili9341_item_t ILI9341SceneAddRect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint16_t color, bool filled){
+	ili9341_item_t item;
+	if ((width == 0) || (height == 0)){
+		return ILI9341_SCENE_NO_ITEM;
+	}
+	item = ItemNew(filled ? ITEM_FILLED_RECT : ITEM_RECT, x, y, color);
+	if (item != ILI9341_SCENE_NO_ITEM){
+		items[item].width = width;
+		items[item].height = height;
+	}
+	return ItemCommit(item);
+}
+
+ili9341_item_t ILI9341SceneAddLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+	ili9341_item_t item = ItemNew(ITEM_LINE, x0, y0, color);
+	if (item != ILI9341_SCENE_NO_ITEM){
+		items[item].x1 = x1;
+		items[item].y1 = y1;
+	}
+	return ItemCommit(item);
+}
+
+ili9341_item_t ILI9341SceneAddCircle(int16_t x, int16_t y, uint16_t r, uint16_t color, bool filled){
+	ili9341_item_t item = ItemNew(filled ? ITEM_FILLED_CIRCLE : ITEM_CIRCLE, x, y, color);
+	if (item != ILI9341_SCENE_NO_ITEM){
+		items[item].width = r;
+	}
+	return ItemCommit(item);
+}
+
+ili9341_item_t ILI9341SceneAddText(int16_t x, int16_t y, const char *str, Font_t *font, uint16_t color){
+	ili9341_item_t item = ItemNew(ITEM_TEXT, x, y, color);
+	if (item != ILI9341_SCENE_NO_ITEM){
+		items[item].data = str;
+		items[item].font = font;
+	}
+	return ItemCommit(item);
+}
+
+ili9341_item_t ILI9341SceneAddPicture(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *pic){
+	ili9341_item_t item;
+	if ((width == 0) || (height == 0)){
+		return ILI9341_SCENE_NO_ITEM;
+	}
+	item = ItemNew(ITEM_PICTURE, x, y, 0);
+	if (item != ILI9341_SCENE_NO_ITEM){
+		items[item].width = width;
+		items[item].height = height;
+		items[item].data = pic;
+	}
+	return ItemCommit(item);
+}
+
+void ILI9341SceneMove(ili9341_item_t item, int16_t dx, int16_t dy){
+	if (!ItemValid(item) || ((dx == 0) && (dy == 0))){
+		return;
+	}
+	/* Old and new positions must be redrawn */
+	SceneDirty(items[item].bbox);
+	items[item].x0 += dx;
+	items[item].y0 += dy;
+	items[item].x1 += dx;
+	items[item].y1 += dy;
+	ItemCommit(item);
+}
+
+void ILI9341SceneSetColor(ili9341_item_t item, uint16_t color){
+	if (!ItemValid(item) || (items[item].color == color)){
+		return;
+	}
+	items[item].color = color;
+	SceneDirty(items[item].bbox);
+}
+
+void ILI9341SceneSetText(ili9341_item_t item, const char *str){
+	if (!ItemValid(item) || (items[item].type != ITEM_TEXT)){
+		return;
+	}
+	SceneDirty(items[item].bbox);
+	items[item].data = str;
+	ItemCommit(item);
+}
+
+void ILI9341SceneSetVisible(ili9341_item_t item, bool visible){
+	if (!ItemValid(item) || (items[item].visible == visible)){
+		return;
+	}
+	items[item].visible = visible;
+	SceneDirty(items[item].bbox);
+}
+
+void ILI9341SceneRemove(ili9341_item_t item){
+	if (!ItemValid(item)){
+		return;
+	}
+	SceneDirty(items[item].bbox);
+	items[item].type = ITEM_FREE;
+}
+
+void ILI9341SceneInvalidate(int16_t x, int16_t y, uint16_t width, uint16_t height){
+	if ((width == 0) || (height == 0)){
+		return;
+	}
+	SceneDirty((rect_t){x, y, x + width - 1, y + height - 1});
+}
+
+uint32_t ILI9341SceneFlush(void){
+	uint32_t pixels = 0;
+	if (strip_buf[0] == NULL){
+		return 0;
+	}
+	for (uint8_t i = 0; i < n_dirty; i++){
+		SceneRenderArea(&dirty[i]);
+		pixels += RectArea(&dirty[i]);
+	}
+	n_dirty = 0;
+	return pixels;
+}
+
+/*==================[end of file]============================================*/
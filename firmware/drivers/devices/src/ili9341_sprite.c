@@ -0,0 +1,163 @@
+/**
+ * @file ili9341_sprite.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ili9341_sprite.h"
+#include <stdlib.h>
+#include <string.h>
+/*==================[macros and definitions]=================================*/
+#define BYTES_PER_PIXEL		2
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static inline const ili9341_area_t *SpriteViewport(const ili9341_sprite_t *sprite){
+	return sprite->use_viewport ? &sprite->viewport : NULL;
+}
+
+static inline int16_t AreaWidth(const ili9341_area_t *a){
+	return a->x1 - a->x0 + 1;
+}
+
+static inline int16_t AreaHeight(const ili9341_area_t *a){
+	return a->y1 - a->y0 + 1;
+}
+
+/**
+ * @brief Pixel (x, y) of a buffer with the pixels of an area
+ */
+static inline uint8_t *AreaPixel(uint8_t *buf, const ili9341_area_t *a, int16_t x, int16_t y){
+	return &buf[((int32_t)(y - a->y0) * AreaWidth(a) + (x - a->x0)) * BYTES_PER_PIXEL];
+}
+
+/**
+ * @brief Intersection of two areas, false if empty
+ */
+static bool AreaIntersect(const ili9341_area_t *a, const ili9341_area_t *b, ili9341_area_t *i){
+	i->x0 = (a->x0 > b->x0) ? a->x0 : b->x0;
+	i->y0 = (a->y0 > b->y0) ? a->y0 : b->y0;
+	i->x1 = (a->x1 < b->x1) ? a->x1 : b->x1;
+	i->y1 = (a->y1 < b->y1) ? a->y1 : b->y1;
+	return (i->x0 <= i->x1) && (i->y0 <= i->y1);
+}
+
+/**
+ * @brief Write back a part of the saved background
+ */
+static void SpriteRestorePart(const ili9341_sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1){
+	if ((x0 > x1) || (y0 > y1)){
+		return;
+	}
+	ILI9341WriteSubArea(x0, y0, x1 - x0 + 1, y1 - y0 + 1, AreaPixel(sprite->saved, &sprite->area, x0, y0), AreaWidth(&sprite->area));
+}
+
+/**
+ * @brief Write back the saved background, except the part covered by keep
+ */
+static void SpriteRestore(const ili9341_sprite_t *sprite, const ili9341_area_t *keep){
+	const ili9341_area_t *old = &sprite->area;
+	ili9341_area_t both;
+
+	if ((keep == NULL) || !AreaIntersect(old, keep, &both)){
+		SpriteRestorePart(sprite, old->x0, old->y0, old->x1, old->y1);
+		return;
+	}
+	/* Full rows above and below, then the sides in the rows of both areas */
+	SpriteRestorePart(sprite, old->x0, old->y0, old->x1, both.y0 - 1);
+	SpriteRestorePart(sprite, old->x0, both.y1 + 1, old->x1, old->y1);
+	SpriteRestorePart(sprite, old->x0, both.y0, both.x0 - 1, both.y1);
+	SpriteRestorePart(sprite, both.x1 + 1, both.y0, old->x1, both.y1);
+}
+/*==================[external functions definition]==========================*/
+bool ILI9341SpriteInit(ili9341_sprite_t *sprite, const ili9341_image_t *image, uint32_t key, const ili9341_area_t *viewport){
+	if (image->width > ILI9341_SPRITE_MAX_WIDTH){
+		return false;
+	}
+	sprite->image = image;
+	sprite->key = key;
+	sprite->use_viewport = (viewport != NULL);
+	if (viewport != NULL){
+		sprite->viewport = *viewport;
+	}
+	sprite->x = 0;
+	sprite->y = 0;
+	sprite->visible = false;
+	sprite->size = (uint32_t)image->width * image->height * BYTES_PER_PIXEL;
+	sprite->saved = malloc(sprite->size);
+	sprite->spare = malloc(sprite->size);
+	if ((sprite->saved == NULL) || (sprite->spare == NULL)){
+		ILI9341SpriteDeinit(sprite);
+		return false;
+	}
+	return true;
+}
+
+void ILI9341SpriteMove(ili9341_sprite_t *sprite, int16_t x, int16_t y){
+	ili9341_area_t next, both;
+	uint8_t *swap;
+
+	sprite->x = x;
+	sprite->y = y;
+	if (!ILI9341SpriteArea(x, y, sprite->image, SpriteViewport(sprite), &next)){
+		ILI9341SpriteHide(sprite);
+		return;
+	}
+	/* Background of the new area: the LCD, except under the old sprite (saved) */
+	ILI9341ReadArea(next.x0, next.y0, AreaWidth(&next), AreaHeight(&next), sprite->spare);
+	if (sprite->visible && AreaIntersect(&sprite->area, &next, &both)){
+		for (int16_t j = both.y0; j <= both.y1; j++){
+			memcpy(AreaPixel(sprite->spare, &next, both.x0, j), AreaPixel(sprite->saved, &sprite->area, both.x0, j),
+				   AreaWidth(&both) * BYTES_PER_PIXEL);
+		}
+	}
+	ILI9341DrawSprite(x, y, sprite->image, sprite->key, SpriteViewport(sprite), sprite->spare);
+	if (sprite->visible){
+		SpriteRestore(sprite, &next);
+	}
+	swap = sprite->saved;
+	sprite->saved = sprite->spare;
+	sprite->spare = swap;
+	sprite->area = next;
+	sprite->visible = true;
+}
+
+bool ILI9341SpriteSetImage(ili9341_sprite_t *sprite, const ili9341_image_t *image){
+	if ((image->width != sprite->image->width) || (image->height != sprite->image->height)){
+		return false;
+	}
+	sprite->image = image;
+	if (sprite->visible){
+		ILI9341DrawSprite(sprite->x, sprite->y, image, sprite->key, SpriteViewport(sprite), sprite->saved);
+	}
+	return true;
+}
+
+void ILI9341SpriteHide(ili9341_sprite_t *sprite){
+	if (sprite->visible){
+		SpriteRestore(sprite, NULL);
+		sprite->visible = false;
+	}
+}
+
+void ILI9341SpriteDeinit(ili9341_sprite_t *sprite){
+	free(sprite->saved);
+	free(sprite->spare);
+	sprite->saved = NULL;
+	sprite->spare = NULL;
+	sprite->visible = false;
+}
+
+/*==================[end of file]============================================*/
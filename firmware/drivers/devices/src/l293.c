@@ -11,12 +11,16 @@
 
 /*==================[inclusions]=============================================*/
 #include "l293.h"
-#include "gpio_mcu.h"
+#include <stddef.h>
 #include "pwm_mcu.h"
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "driver/pulse_cnt.h"
 /*==================[macros and definitions]=================================*/
 #define MAX_F_SPEED 	100		/*!< Max foward speed  */
 #define MAX_B_SPEED 	-100	/*!< Max backward speed */
-#define PWM_FREQ 		50		/*!< PWM frequency (Hz) */
+#define PWM_FREQ 		4000	/*!< PWM frequency (Hz), faster than the control loop */
 #define N_MOTORS		2		/*!< Number of motors */
 #define EN_1_2			GPIO_22
 #define A_1				GPIO_21
@@ -24,16 +28,134 @@
 #define EN_3_4			GPIO_19
 #define A_3				GPIO_18
 #define A_4				GPIO_9
+#define US_PER_SEC		1000000
+#define SEC_PER_MIN		60
+#define Q16_SHIFT		16
+#define Q32_ONE			((int64_t)L293_Q16_ONE << Q16_SHIFT)	/*!< 1.0 in Q32 */
+#define PCNT_LIMIT		30000	/*!< PCNT counter limit (accumulated by the driver on overflow) */
+#define PCNT_GLITCH_NS	1000	/*!< Encoder glitch filter */
+#define NS_PER_CYCLE_Q8	((1000 << 8) / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
 /*==================[typedef]================================================*/
-
+/**
+ * @brief  Motor state
+ */
+typedef struct
+{
+	pwm_out_t pwm;					/*!< Enable PWM output */
+	gpio_t in_f;					/*!< Input driven high to go foward */
+	gpio_t in_b;					/*!< Input driven high to go backward */
+	pcnt_unit_handle_t pcnt;		/*!< Encoder counter (NULL: no encoder) */
+	uint16_t counts_per_rev;		/*!< Encoder counts per revolution */
+	int count_hist[L293_SPEED_WINDOW];	/*!< Encoder count of the last control periods */
+	uint8_t hist_idx;				/*!< Oldest position in count_hist */
+	int32_t speed_q16;				/*!< Measured speed (RPM, Q16) */
+	int32_t target_q16;				/*!< Speed target (RPM, Q16) */
+	l293_pid_gains_t gains;			/*!< PID gains */
+	int64_t integ_q32;				/*!< PID integral term (duty, Q32: small ki * error / L293_CTRL_HZ steps aren't lost) */
+	volatile bool closed_loop;		/*!< Closed loop control enabled */
+} l293_state_t;
 /*==================[internal data declaration]==============================*/
-
+static l293_state_t motors[N_MOTORS] = {
+	{.pwm = PWM_0, .in_f = A_1, .in_b = A_2},
+	{.pwm = PWM_1, .in_f = A_3, .in_b = A_4},
+};
+static uint32_t loop_cycles = 0;		/*!< Last control loop execution time (CPU cycles) */
+static uint32_t loop_cycles_max = 0;	/*!< Max control loop execution time (CPU cycles) */
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/**
+ * @brief  Sets direction and duty cycle (Q16, -1.0 to 1.0) of a motor
+ */
+static void IRAM_ATTR L293Drive(l293_state_t *m, int32_t duty_q16){
+	if(duty_q16 > 0){
+		GPIOOn(m->in_f);
+		GPIOOff(m->in_b);
+		PWMSetDutyQ16(m->pwm, duty_q16);
+	} else if(duty_q16 < 0){
+		GPIOOff(m->in_f);
+		GPIOOn(m->in_b);
+		PWMSetDutyQ16(m->pwm, -duty_q16);
+	} else{
+		PWMSetDutyQ16(m->pwm, 0);
+		GPIOOff(m->in_f);
+		GPIOOff(m->in_b);
+	}
+}
 
+/**
+ * @brief  Updates the speed of a motor from its encoder count
+ */
+static void IRAM_ATTR L293MeasureSpeed(l293_state_t *m){
+	int count;
+	int32_t delta;
+	pcnt_unit_get_count(m->pcnt, &count);
+	/* Counts in the last L293_SPEED_WINDOW periods */
+	delta = count - m->count_hist[m->hist_idx];
+	m->count_hist[m->hist_idx] = count;
+	if(++m->hist_idx >= L293_SPEED_WINDOW){
+		m->hist_idx = 0;
+	}
+	m->speed_q16 = (((int64_t)delta * SEC_PER_MIN * L293_CTRL_HZ) << Q16_SHIFT) 
+		/ ((int32_t)m->counts_per_rev * L293_SPEED_WINDOW);
+}
+
+/**
+ * @brief  PID controller, returns duty cycle (Q16, -1.0 to 1.0)
+ * 
+ * The derivative term uses the speed instead of the error, so target changes
+ * don't produce output spikes. Anti-windup: the integral is not accumulated 
+ * while the output is saturated in the direction of the error, and it is clamped
+ * to the output range.
+ */
+static int32_t IRAM_ATTR L293Pid(l293_state_t *m, int32_t prev_speed_q16){
+	int32_t error = m->target_q16 - m->speed_q16;
+	int64_t p, d, out;
+	p = ((int64_t)m->gains.kp * error) >> Q16_SHIFT;
+	d = -(((int64_t)m->gains.kd * (m->speed_q16 - prev_speed_q16) * L293_CTRL_HZ) >> Q16_SHIFT);
+	out = p + (m->integ_q32 >> Q16_SHIFT) + d;
+	if(!((out >= L293_Q16_ONE) && (error > 0)) && !((out <= -L293_Q16_ONE) && (error < 0))){
+		/* ki (Q16) * error (Q16) is Q32: no bits are dropped before the division */
+		m->integ_q32 += ((int64_t)m->gains.ki * error) / L293_CTRL_HZ;
+		if(m->integ_q32 > Q32_ONE){
+			m->integ_q32 = Q32_ONE;
+		} else if(m->integ_q32 < -Q32_ONE){
+			m->integ_q32 = -Q32_ONE;
+		}
+	}
+	if(out > L293_Q16_ONE){
+		out = L293_Q16_ONE;
+	} else if(out < -L293_Q16_ONE){
+		out = -L293_Q16_ONE;
+	}
+	return (int32_t)out;
+}
+
+/**
+ * @brief  Control loop, timer callback
+ */
+static void IRAM_ATTR L293ControlLoop(void *param){
+	uint32_t start = esp_cpu_get_cycle_count();
+	int32_t prev_speed;
+	l293_state_t *m;
+	for(uint8_t i = 0; i < N_MOTORS; i++){
+		m = &motors[i];
+		if(m->pcnt == NULL){
+			continue;
+		}
+		prev_speed = m->speed_q16;
+		L293MeasureSpeed(m);
+		if(m->closed_loop){
+			L293Drive(m, L293Pid(m, prev_speed));
+		}
+	}
+	loop_cycles = esp_cpu_get_cycle_count() - start;
+	if(loop_cycles > loop_cycles_max){
+		loop_cycles_max = loop_cycles;
+	}
+}
 /*==================[external data definition]===============================*/
 
 /*==================[external functions definition]==========================*/
@@ -49,56 +171,120 @@ uint8_t L293Init(void){
 }
 
 uint8_t L293SetSpeed(l293_motor_t motor, int8_t speed){
-	uint8_t err = 0;
-
-	switch(motor){
-	case MOTOR_1:
-		if(speed == 0){
-			PWMSetDutyCycle(PWM_0, speed);
-			GPIOOff(A_1);
-			GPIOOff(A_2);
-		}
-		if(speed > 0){
-			if (speed > MAX_F_SPEED) speed = MAX_F_SPEED;
-			PWMSetDutyCycle(PWM_0, speed);
-			GPIOOn(A_1);
-			GPIOOff(A_2);
-		}
-		if(speed < 0){
-			if (speed < MAX_B_SPEED) speed = MAX_B_SPEED;
-			PWMSetDutyCycle(PWM_0, -speed);
-			GPIOOn(A_1);
-			GPIOOff(A_2);
-		}
-		break;
-	case MOTOR_2:
-		if(speed == 0){
-			PWMSetDutyCycle(PWM_1, speed);
-			GPIOOff(A_3);
-			GPIOOff(A_4);
-		}
-		if(speed > 0){
-			if (speed > MAX_F_SPEED) speed = MAX_F_SPEED;
-			PWMSetDutyCycle(PWM_1, speed);
-			GPIOOn(A_3);
-			GPIOOff(A_4);
-		}
-		if(speed < 0){
-			if (speed < MAX_B_SPEED) speed = MAX_B_SPEED;
-			PWMSetDutyCycle(PWM_1, -speed);
-			GPIOOn(A_3);
-			GPIOOff(A_4);
-		}
-		break;
-	default:
-		err = 1;
-		break;
+	if(motor >= N_MOTORS){
+		return 1;
+	}
+	if (speed > MAX_F_SPEED) speed = MAX_F_SPEED;
+	if (speed < MAX_B_SPEED) speed = MAX_B_SPEED;
+	motors[motor].closed_loop = false;
+	L293Drive(&motors[motor], ((int32_t)speed * L293_Q16_ONE) / MAX_F_SPEED);
+	return 0;
+}
+
+uint8_t L293EncoderInit(l293_motor_t motor, gpio_t enc_a, gpio_t enc_b, uint16_t counts_per_rev){
+	pcnt_unit_handle_t unit;
+	pcnt_channel_handle_t chan_a, chan_b;
+	if((motor >= N_MOTORS) || (counts_per_rev == 0)){
+		return 0;
+	}
+	pcnt_unit_config_t unit_config = {
+		.low_limit = -PCNT_LIMIT,
+		.high_limit = PCNT_LIMIT,
+		.flags.accum_count = 1,
+	};
+	if(pcnt_new_unit(&unit_config, &unit) != ESP_OK){
+		return 0;
+	}
+	pcnt_glitch_filter_config_t filter_config = {
+		.max_glitch_ns = PCNT_GLITCH_NS,
+	};
+	pcnt_unit_set_glitch_filter(unit, &filter_config);
+	/* x4 quadrature decoding: both edges of both channels */
+	pcnt_chan_config_t chan_a_config = {
+		.edge_gpio_num = enc_a,
+		.level_gpio_num = enc_b,
+	};
+	pcnt_new_channel(unit, &chan_a_config, &chan_a);
+	pcnt_chan_config_t chan_b_config = {
+		.edge_gpio_num = enc_b,
+		.level_gpio_num = enc_a,
+	};
+	pcnt_new_channel(unit, &chan_b_config, &chan_b);
+	pcnt_channel_set_edge_action(chan_a, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+	pcnt_channel_set_level_action(chan_a, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+	pcnt_channel_set_edge_action(chan_b, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+	pcnt_channel_set_level_action(chan_b, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+	/* Watch points at the limits, so the driver accumulates the count on overflow */
+	pcnt_unit_add_watch_point(unit, PCNT_LIMIT);
+	pcnt_unit_add_watch_point(unit, -PCNT_LIMIT);
+	pcnt_unit_enable(unit);
+	pcnt_unit_clear_count(unit);
+	pcnt_unit_start(unit);
+
+	motors[motor].counts_per_rev = counts_per_rev;
+	for(uint8_t i = 0; i < L293_SPEED_WINDOW; i++){
+		motors[motor].count_hist[i] = 0;
+	}
+	motors[motor].hist_idx = 0;
+	motors[motor].speed_q16 = 0;
+	motors[motor].pcnt = unit;
+	return 1;
+}
+
+uint8_t L293ControlInit(timer_mcu_t timer){
+	timer_config_t timer_ctrl = {
+		.timer = timer,
+		.period = US_PER_SEC / L293_CTRL_HZ,
+		.func_p = L293ControlLoop,
+		.param_p = NULL
+	};
+	TimerInit(&timer_ctrl);
+	TimerStart(timer);
+	return 1;
+}
+
+uint8_t L293SetGains(l293_motor_t motor, const l293_pid_gains_t *gains){
+	if(motor >= N_MOTORS){
+		return 0;
+	}
+	/* Loop is stopped while the gains change */
+	bool closed_loop = motors[motor].closed_loop;
+	motors[motor].closed_loop = false;
+	motors[motor].gains = *gains;
+	motors[motor].integ_q32 = 0;
+	motors[motor].closed_loop = closed_loop;
+	return 1;
+}
+
+uint8_t L293SetRpm(l293_motor_t motor, int16_t rpm){
+	if((motor >= N_MOTORS) || (motors[motor].pcnt == NULL)){
+		return 0;
+	}
+	motors[motor].target_q16 = (int32_t)rpm << Q16_SHIFT;
+	if(!motors[motor].closed_loop){
+		/* Bumpless start */
+		motors[motor].integ_q32 = 0;
+		motors[motor].closed_loop = true;
 	}
+	return 1;
+}
+
+int16_t L293GetRpm(l293_motor_t motor){
+	if(motor >= N_MOTORS){
+		return 0;
+	}
+	return motors[motor].speed_q16 >> Q16_SHIFT;
+}
 
-	return err;
+void L293GetLoopTime(uint32_t *last_ns, uint32_t *max_ns){
+	*last_ns = (loop_cycles * NS_PER_CYCLE_Q8) >> 8;
+	*max_ns = (loop_cycles_max * NS_PER_CYCLE_Q8) >> 8;
+	loop_cycles_max = 0;
 }
 
 uint8_t L293DeInit(void){
+	motors[MOTOR_1].closed_loop = false;
+	motors[MOTOR_2].closed_loop = false;
 	PWMOff(PWM_0);
 	PWMOff(PWM_1);
 	return 1;
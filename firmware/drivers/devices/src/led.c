@@ -11,20 +11,151 @@
 
 /*==================[inclusions]=============================================*/
 #include "led.h"
+#include <stddef.h>
 #include "gpio_mcu.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
 #define GPIO_LED1 GPIO_11
 #define GPIO_LED2 GPIO_10
 #define GPIO_LED3 GPIO_5
+#define N_LEDS		3		/*!< Number of LEDs in ESP-EDU */
+#define LEVEL_MAX	100		/*!< Max brightness level (in %) */
+#define US_PER_MS	1000	/*!< Timer period is in us */
 /*==================[internal data declaration]==============================*/
-
+/**
+ * @brief State of each LED (index is the bit position in led_t)
+ */
+typedef struct {
+	gpio_t gpio;			/*!< GPIO where LED is connected */
+	bool pwm_used;			/*!< LED is driven by a PWM output */
+	pwm_out_t pwm;			/*!< PWM output (if pwm_used) */
+	uint8_t level;			/*!< Actual brightness level (in %) */
+	volatile bool active;	/*!< Pattern running */
+	led_pattern_t pattern;	/*!< Actual pattern */
+	uint16_t on_ms;			/*!< Time on in each period */
+	uint16_t fade_ms;		/*!< Ramp time (limited to half the time on) */
+	uint16_t phase_ms;		/*!< Time elapsed in the actual period */
+	uint16_t cycles;		/*!< Periods completed */
+	bool stopping;			/*!< Fading out after LedStopPattern() */
+	uint8_t stop_level;		/*!< Level when the fade out started */
+} led_state_t;
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
-
+static led_state_t leds_state[N_LEDS] = {
+	{.gpio = GPIO_LED3},
+	{.gpio = GPIO_LED2},
+	{.gpio = GPIO_LED1},
+};
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/**
+ * @brief Get the index of a LED in leds_state (-1 if invalid LED number)
+ */
+static int8_t LedIndex(led_t led){
+	switch (led){
+	case LED_3:
+		return 0;
+	case LED_2:
+		return 1;
+	case LED_1:
+		return 2;
+	}
+	return -1;
+}
+
+/**
+ * @brief Set LED brightness. Only writes to hardware when level changes.
+ */
+static void IRAM_ATTR LedWrite(led_state_t *state, uint8_t level){
+	if(level == state->level){
+		return;
+	}
+	state->level = level;
+	if(state->pwm_used){
+		PWMSetDutyCycle(state->pwm, level);
+	} else{
+		GPIOState(state->gpio, level > 0);
+	}
+}
+
+/**
+ * @brief Brightness level of a pattern at a given time of the period.
+ */
+static uint8_t IRAM_ATTR LedPatternLevel(led_state_t *state){
+	uint32_t t = state->phase_ms;
+	uint32_t bright = state->pattern.brightness;
+	if(t >= state->on_ms){
+		return 0;
+	}
+	if(state->fade_ms == 0){
+		return bright;
+	}
+	/* Rising ramp */
+	if(t < state->fade_ms){
+		return (bright * t) / state->fade_ms;
+	}
+	/* Falling ramp */
+	if((state->pattern.period_ms > 0) && (t >= state->on_ms - state->fade_ms)){
+		return (bright * (state->on_ms - t)) / state->fade_ms;
+	}
+	return bright;
+}
+
+/**
+ * @brief Timer callback: advance all running patterns one tick.
+ */
+static void IRAM_ATTR LedsPatternTick(void *param){
+	led_state_t *state;
+	for(uint8_t i = 0; i < N_LEDS; i++){
+		state = &leds_state[i];
+		if(!state->active){
+			continue;
+		}
+		/* Fade out: ramp from the level the LED had when stopped to 0 */
+		if(state->stopping){
+			state->phase_ms += LED_TICK_MS;
+			if(state->phase_ms >= state->pattern.fade_ms){
+				state->active = false;
+				LedWrite(state, 0);
+			} else{
+				LedWrite(state, ((uint32_t)state->stop_level * (state->pattern.fade_ms - state->phase_ms)) / state->pattern.fade_ms);
+			}
+			continue;
+		}
+		LedWrite(state, LedPatternLevel(state));
+		/* Steady patterns only advance until the ramp ends, and stay on until stopped */
+		if(state->pattern.period_ms == 0){
+			if(state->phase_ms < state->fade_ms){
+				state->phase_ms += LED_TICK_MS;
+			}
+			continue;
+		}
+		state->phase_ms += LED_TICK_MS;
+		if(state->phase_ms >= state->pattern.period_ms){
+			state->phase_ms = 0;
+			state->cycles++;
+			if((state->pattern.count > 0) && (state->cycles >= state->pattern.count)){
+				state->active = false;
+				LedWrite(state, 0);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Cancel pattern and set LED level (used by the single LED functions).
+ */
+static uint8_t LedSet(led_t led, uint8_t level){
+	int8_t i = LedIndex(led);
+	if(i < 0){
+		return false;
+	}
+	leds_state[i].active = false;
+	LedWrite(&leds_state[i], level);
+	return true;
+}
 
 /*==================[external functions definition]==========================*/
 
@@ -44,77 +175,125 @@ uint8_t LedsInit(void){
 
 /** \brief Function to turn on a specific led */
 uint8_t LedOn(led_t led){
-	uint8_t result = false;
-	switch (led){
-	case LED_1:
-		GPIOOn(GPIO_LED1);
-		result = true;
-		break;
-	case LED_2:
-		GPIOOn(GPIO_LED2);
-		result = true;
-		break;
-	case LED_3:
-		GPIOOn(GPIO_LED3);
-		result = true;
-		break;
-	}
-	return result;
+	return LedSet(led, LEVEL_MAX);
 }
 
 uint8_t LedOff(led_t led){
-	uint8_t result = false;
-	switch (led){
-	case LED_1:
-		GPIOOff(GPIO_LED1);
-		result = true;
-		break;
-	case LED_2:
-		GPIOOff(GPIO_LED2);
-		result = true;
-		break;
-	case LED_3:
-		GPIOOff(GPIO_LED3);
-		result = true;
-		break;
-	}
-	return result;
+	return LedSet(led, 0);
 }
 
 uint8_t LedToggle(led_t led){
-	uint8_t result = false;
-
-	switch (led){
-	case LED_1:
-		GPIOToggle(GPIO_LED1);
-		result = true;
-		break;
-	case LED_2:
-		GPIOToggle(GPIO_LED2);
-		result = true;
-		break;
-	case LED_3:
-		GPIOToggle(GPIO_LED3);
-		result = true;
-		break;
+	int8_t i = LedIndex(led);
+	if(i < 0){
+		return false;
 	}
-
-	return result;
+	return LedSet(led, (leds_state[i].level > 0) ? 0 : LEVEL_MAX);
 }
 
 uint8_t LedsOffAll(void){
-	GPIOOff(GPIO_LED1);
-	GPIOOff(GPIO_LED2);
-	GPIOOff(GPIO_LED3);
+	LedSet(LED_1, 0);
+	LedSet(LED_2, 0);
+	LedSet(LED_3, 0);
 	
 	return true;
 }
 
 uint8_t LedsMask(uint8_t mask){
-	GPIOState(GPIO_LED1, (mask & LED_1) >> 2);
-	GPIOState(GPIO_LED2, (mask & LED_2) >> 1);
-	GPIOState(GPIO_LED3, (mask & LED_3));
+	LedSet(LED_1, (mask & LED_1) ? LEVEL_MAX : 0);
+	LedSet(LED_2, (mask & LED_2) ? LEVEL_MAX : 0);
+	LedSet(LED_3, (mask & LED_3) ? LEVEL_MAX : 0);
 	return true;
 }
 
+uint8_t LedsPatternInit(timer_mcu_t timer){
+	timer_config_t timer_leds = {
+		.timer = timer,
+		.period = LED_TICK_MS * US_PER_MS,
+		.func_p = LedsPatternTick,
+		.param_p = NULL
+	};
+	TimerInit(&timer_leds);
+	TimerStart(timer);
+	return true;
+}
+
+uint8_t LedAttachPwm(led_t led, pwm_out_t out){
+	int8_t i = LedIndex(led);
+	if(i < 0){
+		return false;
+	}
+	leds_state[i].active = false;
+	PWMInit(out, leds_state[i].gpio, LED_PWM_FREQ);
+	leds_state[i].pwm = out;
+	leds_state[i].pwm_used = true;
+	/* PWM output starts with duty cycle 0% */
+	leds_state[i].level = 0;
+	return true;
+}
+
+uint8_t LedSetPattern(uint8_t leds, const led_pattern_t *pattern){
+	led_state_t *state;
+	for(uint8_t i = 0; i < N_LEDS; i++){
+		if(!(leds & (1 << i))){
+			continue;
+		}
+		state = &leds_state[i];
+		/* Tick skips the LED while its pattern is being changed */
+		state->active = false;
+		state->pattern = *pattern;
+		if(state->pattern.duty > LEVEL_MAX){
+			state->pattern.duty = LEVEL_MAX;
+		}
+		if((state->pattern.brightness == 0) || (state->pattern.brightness > LEVEL_MAX)){
+			state->pattern.brightness = LEVEL_MAX;
+		}
+		if(state->pattern.period_ms == 0){
+			state->on_ms = UINT16_MAX;
+		} else{
+			state->on_ms = ((uint32_t)state->pattern.period_ms * state->pattern.duty) / LEVEL_MAX;
+		}
+		state->fade_ms = state->pattern.fade_ms;
+		if((state->pattern.period_ms > 0) && (state->fade_ms > state->on_ms / 2)){
+			state->fade_ms = state->on_ms / 2;
+		}
+		state->phase_ms = 0;
+		state->cycles = 0;
+		state->stopping = false;
+		state->active = true;
+	}
+	return true;
+}
+
+uint8_t LedStopPattern(uint8_t leds){
+	led_state_t *state;
+	bool running;
+	for(uint8_t i = 0; i < N_LEDS; i++){
+		if(!(leds & (1 << i))){
+			continue;
+		}
+		state = &leds_state[i];
+		running = state->active;
+		state->active = false;
+		/* Only a running pattern fades out, LEDs set with LedOn() turn off at once */
+		if(running && state->pwm_used && (state->pattern.fade_ms > 0) && (state->level > 0)){
+			/* The tick turns the LED off at the end of the ramp */
+			state->stop_level = state->level;
+			state->phase_ms = 0;
+			state->stopping = true;
+			state->active = true;
+		} else{
+			LedWrite(state, 0);
+		}
+	}
+	return true;
+}
+
+bool LedPatternRunning(led_t led){
+	int8_t i = LedIndex(led);
+	if(i < 0){
+		return false;
+	}
+	return leds_state[i].active;
+}
+
 /*==================[end of file]============================================*/
@@ -0,0 +1,217 @@
+/**
+ * @file neopixel_anim.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief 
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include "neopixel_anim.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+/*==================[macros and definitions]=================================*/
+#define ANIM_STACK		2048
+#define ANIM_PRIORITY	5
+#define US_PER_SEC		1000000
+#define US_PER_MS		1000
+#define Q16_ONE			65536
+#define Q16_SHIFT		16
+#define Q8_ONE			256
+#define Q8_SHIFT		8
+#define RED_OFFSET      16
+#define GREEN_OFFSET    8
+#define BLUE_OFFSET     0
+/*==================[internal data declaration]==============================*/
+static neopixel_anim_t anim_actual;				/*!< Running animation */
+static volatile bool anim_running = false;
+static volatile bool anim_restart = false;		/*!< New animation started */
+static portMUX_TYPE anim_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static neopixel_color_t *frame = NULL;			/*!< Frame being drawn */
+static uint16_t frame_len = 0;
+static TickType_t frame_ticks;					/*!< Frame period (in ticks) */
+static uint16_t fps_achieved = 0;
+static uint32_t frames_dropped = 0;
+static TaskHandle_t anim_task_handle = NULL;
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/**
+ * @brief Scale a color (each component) by a Q8 factor (0 to 256)
+ */
+static inline neopixel_color_t NeoPixelAnimScale(neopixel_color_t c, uint16_t k){
+	return ((((c >> RED_OFFSET) & 0xFF) * k >> Q8_SHIFT) << RED_OFFSET) |
+	       ((((c >> GREEN_OFFSET) & 0xFF) * k >> Q8_SHIFT) << GREEN_OFFSET) |
+	       ((((c >> BLUE_OFFSET) & 0xFF) * k >> Q8_SHIFT) << BLUE_OFFSET);
+}
+
+/**
+ * @brief Mix two colors: k = 0 -> a, k = 256 -> b
+ */
+static inline neopixel_color_t NeoPixelAnimMix(neopixel_color_t a, neopixel_color_t b, uint16_t k){
+	return NeoPixelAnimScale(a, Q8_ONE - k) + NeoPixelAnimScale(b, k);
+}
+
+/**
+ * @brief Triangle wave: 0 -> 256 -> 0 along a cycle (phase in Q16)
+ */
+static inline uint16_t NeoPixelAnimTriangle(uint32_t phase){
+	return (phase < Q16_ONE / 2) ? (phase >> (Q16_SHIFT - Q8_SHIFT - 1)) : 
+		((Q16_ONE - phase) >> (Q16_SHIFT - Q8_SHIFT - 1));
+}
+
+/**
+ * @brief Draws a frame of the animation
+ * 
+ * @param a Animation
+ * @param phase Position in the cycle of the animation (Q16)
+ */
+static void NeoPixelAnimDraw(const neopixel_anim_t *a, uint32_t phase){
+	uint16_t k;
+	uint32_t pos, dist;
+	switch(a->effect){
+		case NEOPIXEL_ANIM_RAINBOW:
+			NeoPixelHSVGradient(frame, frame_len, phase, 
+				((uint32_t)(a->reps ? a->reps : 1) << 24) / frame_len, a->sat, a->val);
+			break;
+		case NEOPIXEL_ANIM_CHASE:{
+			uint8_t width = a->width ? a->width : 1;
+			uint8_t offset = (phase * width) >> Q16_SHIFT;
+			for(uint16_t i = 0; i < frame_len; i++){
+				frame[i] = ((i % width) == offset) ? a->color : a->color2;
+			}
+			break;
+		}
+		case NEOPIXEL_ANIM_FADE:
+			k = NeoPixelAnimTriangle(phase);
+			frame[0] = NeoPixelAnimMix(a->color, a->color2, k);
+			for(uint16_t i = 1; i < frame_len; i++){
+				frame[i] = frame[0];
+			}
+			break;
+		case NEOPIXEL_ANIM_BREATHE:
+			/* Squared triangle, so the change looks linear */
+			k = NeoPixelAnimTriangle(phase);
+			frame[0] = NeoPixelAnimScale(a->color, (k * k) >> Q8_SHIFT);
+			for(uint16_t i = 1; i < frame_len; i++){
+				frame[i] = frame[0];
+			}
+			break;
+		case NEOPIXEL_ANIM_SCANNER:{
+			uint8_t width = a->width ? a->width : 1;
+			/* Dot position (Q8 pixels), going back and forth */
+			pos = ((uint32_t)NeoPixelAnimTriangle(phase) * (frame_len - 1));
+			for(uint16_t i = 0; i < frame_len; i++){
+				dist = ((uint32_t)i << Q8_SHIFT) > pos ? ((uint32_t)i << Q8_SHIFT) - pos : pos - ((uint32_t)i << Q8_SHIFT);
+				if(dist < ((uint32_t)width << Q8_SHIFT)){
+					frame[i] = NeoPixelAnimScale(a->color, Q8_ONE - dist / width);
+				} else{
+					frame[i] = 0;
+				}
+			}
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Animation task. Draws one frame per period.
+ */
+static void NeoPixelAnimTask(void *pvParameter){
+	neopixel_anim_t a;
+	TickType_t last_wake = xTaskGetTickCount();
+	int64_t start_us = 0, now_us, fps_start_us = 0;
+	uint32_t period_us, fps_frames = 0;
+	while(true){
+		if(!xTaskDelayUntil(&last_wake, frame_ticks)){
+			/* Late: the missed frames are dropped instead of drawn back to back */
+			frames_dropped++;
+			last_wake = xTaskGetTickCount();
+		}
+		if(!anim_running){
+			fps_achieved = 0;
+			continue;
+		}
+		now_us = esp_timer_get_time();
+		portENTER_CRITICAL(&anim_spinlock);
+		a = anim_actual;
+		if(anim_restart){
+			anim_restart = false;
+			start_us = now_us;
+			fps_start_us = now_us;
+			fps_frames = 0;
+			frames_dropped = 0;
+		}
+		portEXIT_CRITICAL(&anim_spinlock);
+
+		period_us = (a.period_ms > 0 ? a.period_ms : 1) * US_PER_MS;
+		NeoPixelAnimDraw(&a, (((now_us - start_us) % period_us) << Q16_SHIFT) / period_us);
+		NeoPixelSetArray(frame);
+
+		fps_frames++;
+		if(now_us - fps_start_us >= US_PER_SEC){
+			fps_achieved = fps_frames;
+			fps_frames = 0;
+			fps_start_us = now_us;
+		}
+	}
+}
+/*==================[external functions definition]==========================*/
+bool NeoPixelAnimInit(uint16_t fps){
+	if(anim_task_handle != NULL){
+		return true;
+	}
+	frame_len = NeoPixelGetLength();
+	if(frame_len == 0){
+		return false;
+	}
+	frame = malloc(frame_len * sizeof(neopixel_color_t));
+	if(frame == NULL){
+		return false;
+	}
+	if(fps == 0){
+		fps = NEOPIXEL_ANIM_FPS;
+	}
+	frame_ticks = pdMS_TO_TICKS(1000 / fps);
+	if(frame_ticks == 0){
+		frame_ticks = 1;
+	}
+	/* Frames are limited to the same rate at the stripe level */
+	NeoPixelSetMaxFps(fps);
+	return xTaskCreate(&NeoPixelAnimTask, "NEOPIXEL_ANIM", ANIM_STACK, NULL, ANIM_PRIORITY, &anim_task_handle) == pdPASS;
+}
+
+void NeoPixelAnimStart(const neopixel_anim_t *anim){
+	portENTER_CRITICAL(&anim_spinlock);
+	anim_actual = *anim;
+	anim_restart = true;
+	anim_running = true;
+	portEXIT_CRITICAL(&anim_spinlock);
+}
+
+void NeoPixelAnimStop(void){
+	anim_running = false;
+}
+
+bool NeoPixelAnimRunning(void){
+	return anim_running;
+}
+
+uint16_t NeoPixelAnimGetFps(void){
+	return fps_achieved;
+}
+
+uint32_t NeoPixelAnimGetDropped(void){
+	return frames_dropped;
+}
+
+/*==================[end of file]============================================*/
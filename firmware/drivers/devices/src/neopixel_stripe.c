@@ -11,7 +11,11 @@
 
 /*==================[inclusions]=============================================*/
 #include "neopixel_stripe.h"
+#include <stdlib.h>
 #include "ws2812b.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
 /*==================[macros and definitions]=================================*/
 #define RED_MSK         0x00FF0000
 #define GREEN_MSK       0x0000FF00
@@ -21,10 +25,48 @@
 #define BLUE_OFFSET     0
 #define MAX_BRIGHT  	255
 #define BRIGHT_OFFSET   8
+#define LED_BYTES       3       /*!< Bytes per NeoPixel in the wire buffer (G, R, B) */
+#define DIRTY_BITS      32      /*!< Pixels per word of the dirty bitmap */
+#define US_PER_SEC      1000000
+#define US_PER_MS       1000
+#define LUT_SIZE        256
 /*==================[internal data declaration]==============================*/
-uint16_t stripe_length;
-uint8_t stripe_bright = MAX_BRIGHT;
-neopixel_color_t *stripe_colors; 
+/**
+ * @brief NeoPixel stripe
+ */
+struct neopixel_stripe {
+	uint16_t length;
+	uint8_t bright;
+	neopixel_color_t *colors;
+	uint8_t *wire;					/*!< Bytes transmitted to the stripe */
+	uint32_t *dirty;				/*!< Pixels changed since the last transmission (bitmap) */
+	bool any_dirty;					/*!< At least one pixel changed */
+	bool all_dirty;					/*!< All the pixels changed */
+	uint8_t lut_red[LUT_SIZE];		/*!< Red level to wire byte (brightness, white balance and gamma) */
+	uint8_t lut_green[LUT_SIZE];	/*!< Green level to wire byte */
+	uint8_t lut_blue[LUT_SIZE];		/*!< Blue level to wire byte */
+	uint8_t wb_red;					/*!< White balance */
+	uint8_t wb_green;
+	uint8_t wb_blue;
+	bool lut_valid;					/*!< LUTs built for actual brightness and white balance */
+	uint8_t transaction_depth;		/*!< Nested NeoPixelStripeBegin() calls */
+	uint32_t frame_period_us;		/*!< Min time between transmissions (0: no limit) */
+	int64_t last_frame_us;			/*!< Time of the last transmission */
+	ws2812b_channel_t *chan;		/*!< Own RMT channel (NULL if the stripe is in a group) */
+	neopixel_group_t *group;		/*!< Group of the stripe (NULL if it has its own channel) */
+};
+
+/**
+ * @brief Stripes transmitted in parallel
+ */
+struct neopixel_group {
+	ws2812b_bus_t *bus;
+	uint8_t n_stripes;
+	neopixel_stripe_t *stripes[NEOPIXEL_GROUP_MAX_STRIPES];
+	uint8_t transaction_depth;		/*!< Nested NeoPixelGroupBegin() calls */
+};
+
+static neopixel_stripe_t *default_stripe = NULL;	/*!< Stripe used by NeoPixel*() functions */
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
@@ -32,90 +74,544 @@ neopixel_color_t *stripe_colors;
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/**
+ * @brief Converts hue (16 bits) to a fully saturated R, G, B color
+ */
+static inline void NeoPixelHue2Rgb(uint16_t hue, uint8_t *rr, uint8_t *gg, uint8_t *bb){
+  uint8_t r, g, b;
 
+  hue = (hue * 1530L + 32768) / 65536;
+  // Convert hue to R,G,B (nested ifs faster than divide+mod+switch):
+  if (hue < 510) { // Red to Green-1
+    b = 0;
+    if (hue < 255) { //   Red to Yellow-1
+      r = 255;
+      g = hue;       //     g = 0 to 254
+    } else {         //   Yellow to Green-1
+      r = 510 - hue; //     r = 255 to 1
+      g = 255;
+    }
+  } else if (hue < 1020) { // Green to Blue-1
+    r = 0;
+    if (hue < 765) { //   Green to Cyan-1
+      g = 255;
+      b = hue - 510;  //     b = 0 to 254
+    } else {          //   Cyan to Blue-1
+      g = 1020 - hue; //     g = 255 to 1
+      b = 255;
+    }
+  } else if (hue < 1530) { // Blue to Red-1
+    g = 0;
+    if (hue < 1275) { //   Blue to Magenta-1
+      r = hue - 1020; //     r = 0 to 254
+      b = 255;
+    } else { //   Magenta to Red-1
+      r = 255;
+      b = 1530 - hue; //     b = 255 to 1
+    }
+  } else { // Last 0.5 Red (quicker than % operator)
+    r = 255;
+    g = b = 0;
+  }
+
+  *rr = r;
+  *gg = g;
+  *bb = b;
+}
+
+/**
+ * @brief Applies saturation and value (see NeoPixelHSV2Color()) to R, G, B
+ */
+static inline neopixel_color_t NeoPixelApplySatVal(uint8_t r, uint8_t g, uint8_t b, uint16_t s1, uint8_t s2, uint32_t v1){
+  return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+         (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
+         (((((b * s1) >> 8) + s2) * v1) >> 8);
+}
+
+static void NeoPixelMarkDirty(neopixel_stripe_t *stripe, uint16_t pixel){
+	stripe->dirty[pixel / DIRTY_BITS] |= 1UL << (pixel % DIRTY_BITS);
+	stripe->any_dirty = true;
+}
+
+static void NeoPixelMarkAllDirty(neopixel_stripe_t *stripe){
+	stripe->all_dirty = true;
+	stripe->any_dirty = true;
+}
+
+/**
+ * @brief Builds the LUTs that convert a color level to the wire byte, applying 
+ * brightness, white balance and gamma correction in one step.
+ */
+static void NeoPixelBuildLut(neopixel_stripe_t *stripe){
+	uint16_t level;
+	for (uint16_t i = 0; i < LUT_SIZE; i++){
+		level = (i * stripe->bright) >> BRIGHT_OFFSET;
+		stripe->lut_red[i] = ws2812bGammaCorrection((level * (stripe->wb_red + 1)) >> BRIGHT_OFFSET);
+		stripe->lut_green[i] = ws2812bGammaCorrection((level * (stripe->wb_green + 1)) >> BRIGHT_OFFSET);
+		stripe->lut_blue[i] = ws2812bGammaCorrection((level * (stripe->wb_blue + 1)) >> BRIGHT_OFFSET);
+	}
+	stripe->lut_valid = true;
+}
+
+/**
+ * @brief Recomputes the wire bytes of a pixel
+ */
+static inline void NeoPixelEncode(neopixel_stripe_t *stripe, uint16_t pixel){
+	neopixel_color_t color = stripe->colors[pixel];
+	uint8_t *wire = &stripe->wire[LED_BYTES * pixel];
+	wire[0] = stripe->lut_green[(color & GREEN_MSK) >> GREEN_OFFSET];
+	wire[1] = stripe->lut_red[(color & RED_MSK) >> RED_OFFSET];
+	wire[2] = stripe->lut_blue[(color & BLUE_MSK) >> BLUE_OFFSET];
+}
+
+/**
+ * @brief Recomputes the wire bytes of all the pixels
+ */
+static void NeoPixelEncodeAll(neopixel_stripe_t *stripe){
+	const neopixel_color_t *color = stripe->colors;
+	uint8_t *wire = stripe->wire;
+	neopixel_color_t c;
+	for (uint16_t i = stripe->length; i > 0; i--){
+		c = *color++;
+		*wire++ = stripe->lut_green[(uint8_t)(c >> GREEN_OFFSET)];
+		*wire++ = stripe->lut_red[(uint8_t)(c >> RED_OFFSET)];
+		*wire++ = stripe->lut_blue[(uint8_t)(c >> BLUE_OFFSET)];
+	}
+}
+
+/**
+ * @brief Time to wait before the next transmission of a stripe (frame rate limit)
+ */
+static uint32_t NeoPixelFrameWait(neopixel_stripe_t *stripe){
+	int64_t elapsed;
+	if(stripe->frame_period_us == 0){
+		return 0;
+	}
+	elapsed = esp_timer_get_time() - stripe->last_frame_us;
+	return (elapsed < stripe->frame_period_us) ? (stripe->frame_period_us - elapsed) : 0;
+}
+
+static void NeoPixelDelayUs(uint32_t wait_us){
+	if(wait_us > 0){
+		vTaskDelay(pdMS_TO_TICKS((wait_us + US_PER_MS - 1) / US_PER_MS));
+	}
+}
+
+/**
+ * @brief Updates the wire bytes of the changed pixels
+ * 
+ * @note The wire buffer must not be in transmission.
+ */
+static void NeoPixelEncodeDirty(neopixel_stripe_t *stripe){
+	uint32_t word;
+	if(!stripe->lut_valid){
+		NeoPixelBuildLut(stripe);
+	}
+	if(stripe->all_dirty){
+		NeoPixelEncodeAll(stripe);
+		for (uint16_t w = 0; w < (stripe->length + DIRTY_BITS - 1) / DIRTY_BITS; w++){
+			stripe->dirty[w] = 0;
+		}
+	} else{
+		for (uint16_t w = 0; w < (stripe->length + DIRTY_BITS - 1) / DIRTY_BITS; w++){
+			word = stripe->dirty[w];
+			stripe->dirty[w] = 0;
+			while(word){
+				uint8_t bit = __builtin_ctz(word);
+				word &= word - 1;
+				NeoPixelEncode(stripe, w * DIRTY_BITS + bit);
+			}
+		}
+	}
+	stripe->any_dirty = false;
+	stripe->all_dirty = false;
+}
+
+/**
+ * @brief Transmits all the stripes of a group at once, if any of them changed
+ * 
+ * @note Wire buffers are copied to the bus, so there is no need to wait the end
+ * of the previous transmission before encoding.
+ */
+static void NeoPixelGroupFlush(neopixel_group_t *group){
+	const uint8_t *wires[NEOPIXEL_GROUP_MAX_STRIPES];
+	uint16_t lens[NEOPIXEL_GROUP_MAX_STRIPES];
+	uint32_t wait_us = 0, aux;
+	bool any_dirty = false;
+	int64_t now;
+	for (uint8_t i = 0; i < group->n_stripes; i++){
+		any_dirty |= group->stripes[i]->any_dirty;
+		/* The group goes at the rate of the slowest stripe */
+		aux = NeoPixelFrameWait(group->stripes[i]);
+		if(aux > wait_us){
+			wait_us = aux;
+		}
+	}
+	if(!any_dirty){
+		return;
+	}
+	NeoPixelDelayUs(wait_us);
+	now = esp_timer_get_time();
+	for (uint8_t i = 0; i < group->n_stripes; i++){
+		if(group->stripes[i]->any_dirty){
+			NeoPixelEncodeDirty(group->stripes[i]);
+		}
+		group->stripes[i]->last_frame_us = now;
+		wires[i] = group->stripes[i]->wire;
+		lens[i] = group->stripes[i]->length;
+	}
+	ws2812bBusTransmit(group->bus, wires, lens, NULL, NULL);
+}
+
+/**
+ * @brief Transmits the changed pixels (if any), respecting the frame rate limit
+ */
+static void NeoPixelFlush(neopixel_stripe_t *stripe){
+	if(!stripe->any_dirty){
+		return;
+	}
+	NeoPixelDelayUs(NeoPixelFrameWait(stripe));
+	/* Wire buffer can't change while it is transmitted */
+	ws2812bChannelWaitDone(stripe->chan, -1);
+	NeoPixelEncodeDirty(stripe);
+	stripe->last_frame_us = esp_timer_get_time();
+	/* Returns immediately, the stripe is updated in background */
+	ws2812bChannelTransmit(stripe->chan, stripe->wire, LED_BYTES * stripe->length, NULL, NULL);
+}
+
+/**
+ * @brief Transmits the changes, unless a transaction is open
+ */
+static void NeoPixelUpdate(neopixel_stripe_t *stripe){
+	if(stripe->transaction_depth > 0){
+		return;
+	}
+	if(stripe->group != NULL){
+		if(stripe->group->transaction_depth == 0){
+			NeoPixelGroupFlush(stripe->group);
+		}
+	} else{
+		NeoPixelFlush(stripe);
+	}
+}
+
+/**
+ * @brief Allocates a stripe and its buffers
+ */
+static neopixel_stripe_t *NeoPixelStripeAlloc(uint16_t len, neopixel_color_t *color_array){
+	neopixel_stripe_t *stripe = calloc(1, sizeof(neopixel_stripe_t));
+	if(stripe == NULL){
+		return NULL;
+	}
+	stripe->wire = malloc(LED_BYTES * len);
+	stripe->dirty = calloc((len + DIRTY_BITS - 1) / DIRTY_BITS, sizeof(uint32_t));
+	if((stripe->wire == NULL) || (stripe->dirty == NULL)){
+		free(stripe->wire);
+		free(stripe->dirty);
+		free(stripe);
+		return NULL;
+	}
+	stripe->length = len;
+	stripe->colors = color_array;
+	stripe->bright = MAX_BRIGHT;
+	stripe->wb_red = MAX_BRIGHT;
+	stripe->wb_green = MAX_BRIGHT;
+	stripe->wb_blue = MAX_BRIGHT;
+	/* Wire buffer is computed for all the pixels in the first transmission */
+	NeoPixelMarkAllDirty(stripe);
+	return stripe;
+}
+
+static void NeoPixelStripeFree(neopixel_stripe_t *stripe){
+	free(stripe->wire);
+	free(stripe->dirty);
+	free(stripe);
+}
 /*==================[external functions definition]==========================*/
 
-void NeoPixelInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array){
-    stripe_length = len;
-	stripe_colors = color_array;
-    ws2812bInit(pin);
+neopixel_stripe_t *NeoPixelStripeInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array){
+	neopixel_stripe_t *stripe = NeoPixelStripeAlloc(len, color_array);
+	if(stripe == NULL){
+		return NULL;
+	}
+	stripe->chan = ws2812bChannelInit(pin);
+	if(stripe->chan == NULL){
+		NeoPixelStripeFree(stripe);
+		return NULL;
+	}
+	return stripe;
 }
 
-void NeoPixelAllOff(void){
-    rgb_led_t led;
-	ws2812bSendRet();
-	ws2812bSendRet();
-	ws2812bSendRet();
-	for (uint16_t i = 0; i < stripe_length; i++){
-		led.red = 0;
-		led.green = 0;
-		led.blue = 0;
-		ws2812bSend(led);
+void NeoPixelStripeDeinit(neopixel_stripe_t *stripe){
+	/* Stripes in a group share the bus with the other stripes */
+	if((stripe == NULL) || (stripe->group != NULL)){
+		return;
 	}
-	ws2812bSendRet();
+	ws2812bChannelDeinit(stripe->chan);
+	NeoPixelStripeFree(stripe);
 }
 
-void NeoPixelAllColor(neopixel_color_t color){
-	for (uint16_t i = 0; i < stripe_length; i++){
-		stripe_colors[i] = color;
+neopixel_group_t *NeoPixelGroupInit(const gpio_t *pins, const uint16_t *lens, neopixel_color_t *const *color_arrays, uint8_t n_stripes){
+	neopixel_group_t *group;
+	uint16_t max_len = 0;
+	if((n_stripes == 0) || (n_stripes > NEOPIXEL_GROUP_MAX_STRIPES)){
+		return NULL;
+	}
+	group = calloc(1, sizeof(neopixel_group_t));
+	if(group == NULL){
+		return NULL;
+	}
+	for (uint8_t i = 0; i < n_stripes; i++){
+		if(lens[i] > max_len){
+			max_len = lens[i];
+		}
+		group->stripes[i] = NeoPixelStripeAlloc(lens[i], color_arrays[i]);
+		if(group->stripes[i] == NULL){
+			while(i-- > 0){
+				NeoPixelStripeFree(group->stripes[i]);
+			}
+			free(group);
+			return NULL;
+		}
+		group->stripes[i]->group = group;
 	}
-	NeoPixelSetArray(stripe_colors);
+	group->n_stripes = n_stripes;
+	group->bus = ws2812bBusInit(pins, n_stripes, max_len);
+	if(group->bus == NULL){
+		for (uint8_t i = 0; i < n_stripes; i++){
+			NeoPixelStripeFree(group->stripes[i]);
+		}
+		free(group);
+		return NULL;
+	}
+	return group;
 }
 
-void NeoPixelSetPixel(uint16_t pixel, neopixel_color_t color){
-	stripe_colors[pixel] = color;
-	NeoPixelSetArray(stripe_colors);
+neopixel_stripe_t *NeoPixelGroupStripe(neopixel_group_t *group, uint8_t index){
+	if((group == NULL) || (index >= group->n_stripes)){
+		return NULL;
+	}
+	return group->stripes[index];
 }
 
-void NeoPixelSetArray(neopixel_color_t *color_array){
-    rgb_led_t led;
-	uint16_t red, green, blue;
-	ws2812bSendRet();
-	ws2812bSendRet();
-	ws2812bSendRet();
-	for (uint16_t i = 0; i < stripe_length; i++){
-		red = ((color_array[i] & RED_MSK) >> RED_OFFSET) * stripe_bright;
-		green = ((color_array[i] & GREEN_MSK) >> GREEN_OFFSET) * stripe_bright;
-		blue = ((color_array[i] & BLUE_MSK) >> BLUE_OFFSET) * stripe_bright;
-		led.red = red >> BRIGHT_OFFSET;
-		led.green = green >> BRIGHT_OFFSET;
-		led.blue = blue >> BRIGHT_OFFSET;
-		ws2812bSend(led);
-	}
-	ws2812bSendRet();
+void NeoPixelGroupBegin(neopixel_group_t *group){
+	group->transaction_depth++;
 }
 
-void NeoPixelShift(bool upwards){
+void NeoPixelGroupCommit(neopixel_group_t *group){
+	if(group->transaction_depth > 0){
+		group->transaction_depth--;
+	}
+	if(group->transaction_depth == 0){
+		NeoPixelGroupFlush(group);
+	}
+}
+
+void NeoPixelStripeBegin(neopixel_stripe_t *stripe){
+	stripe->transaction_depth++;
+}
+
+void NeoPixelStripeCommit(neopixel_stripe_t *stripe){
+	if(stripe->transaction_depth > 0){
+		stripe->transaction_depth--;
+	}
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeSetMaxFps(neopixel_stripe_t *stripe, uint16_t fps){
+	stripe->frame_period_us = (fps > 0) ? (US_PER_SEC / fps) : 0;
+}
+
+void NeoPixelStripeAllOff(neopixel_stripe_t *stripe){
+	/* Wire buffer can't change while it is transmitted (the bus copies it) */
+	if(stripe->group == NULL){
+		ws2812bChannelWaitDone(stripe->chan, -1);
+	}
+	for (uint16_t i = 0; i < LED_BYTES * stripe->length; i++){
+		stripe->wire[i] = 0;
+	}
+	stripe->last_frame_us = esp_timer_get_time();
+	if(stripe->group != NULL){
+		/* Other stripes of the group are transmitted with their actual wire bytes */
+		const uint8_t *wires[NEOPIXEL_GROUP_MAX_STRIPES];
+		uint16_t lens[NEOPIXEL_GROUP_MAX_STRIPES];
+		for (uint8_t i = 0; i < stripe->group->n_stripes; i++){
+			wires[i] = stripe->group->stripes[i]->wire;
+			lens[i] = stripe->group->stripes[i]->length;
+		}
+		ws2812bBusTransmit(stripe->group->bus, wires, lens, NULL, NULL);
+	} else{
+		ws2812bChannelTransmit(stripe->chan, stripe->wire, LED_BYTES * stripe->length, NULL, NULL);
+	}
+	/* Colors are kept, next update sends all the pixels again */
+	NeoPixelMarkAllDirty(stripe);
+}
+
+void NeoPixelStripeAllColor(neopixel_stripe_t *stripe, neopixel_color_t color){
+	for (uint16_t i = 0; i < stripe->length; i++){
+		stripe->colors[i] = color;
+	}
+	NeoPixelMarkAllDirty(stripe);
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeSetPixel(neopixel_stripe_t *stripe, uint16_t pixel, neopixel_color_t color){
+	if(pixel >= stripe->length){
+		return;
+	}
+	if(stripe->colors[pixel] != color){
+		stripe->colors[pixel] = color;
+		NeoPixelMarkDirty(stripe, pixel);
+	}
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeSetArray(neopixel_stripe_t *stripe, neopixel_color_t *color_array){
+	if(color_array == stripe->colors){
+		/* The stripe array itself was changed by the caller: changes can't be detected */
+		NeoPixelMarkAllDirty(stripe);
+		NeoPixelUpdate(stripe);
+		return;
+	}
+	for (uint16_t i = 0; i < stripe->length; i++){
+		if(stripe->colors[i] != color_array[i]){
+			stripe->colors[i] = color_array[i];
+			NeoPixelMarkDirty(stripe, i);
+		}
+	}
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeShift(neopixel_stripe_t *stripe, bool upwards){
 	neopixel_color_t carry;
+	neopixel_color_t *colors = stripe->colors;
+	uint16_t len = stripe->length;
 
+	if(len == 0){
+		return;
+	}
 	if(upwards){
-		carry = stripe_colors[stripe_length-1];
-		for (uint16_t i = 0; i < stripe_length-1; i++){
-			stripe_colors[stripe_length-1-i] = stripe_colors[stripe_length-2-i]; 
+		carry = colors[len-1];
+		for (uint16_t i = 0; i < len-1; i++){
+			colors[len-1-i] = colors[len-2-i]; 
 		}
-		stripe_colors[0] = carry;
+		colors[0] = carry;
 	}else{
-		carry = stripe_colors[0];
-		for (uint16_t i = 0; i < stripe_length-1; i++){
-			stripe_colors[i] = stripe_colors[i+1]; 
+		carry = colors[0];
+		for (uint16_t i = 0; i < len-1; i++){
+			colors[i] = colors[i+1]; 
 		}
-		stripe_colors[stripe_length-1] = carry;
+		colors[len-1] = carry;
+	}
+	NeoPixelMarkAllDirty(stripe);
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeBrightness(neopixel_stripe_t *stripe, uint8_t bright){
+	if(bright != stripe->bright){
+		stripe->bright = bright;
+		stripe->lut_valid = false;
+		NeoPixelMarkAllDirty(stripe);
+	}
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeWhiteBalance(neopixel_stripe_t *stripe, uint8_t red, uint8_t green, uint8_t blue){
+	stripe->wb_red = red;
+	stripe->wb_green = green;
+	stripe->wb_blue = blue;
+	stripe->lut_valid = false;
+	NeoPixelMarkAllDirty(stripe);
+	NeoPixelUpdate(stripe);
+}
+
+void NeoPixelStripeRainbow(neopixel_stripe_t *stripe, uint16_t first_hue, uint8_t sat, uint8_t val, uint8_t reps){
+	if(stripe->length == 0){
+		return;
+	}
+	NeoPixelHSVGradient(stripe->colors, stripe->length, first_hue, 
+		((uint32_t)reps << 24) / stripe->length, sat, val);
+	NeoPixelMarkAllDirty(stripe);
+	NeoPixelUpdate(stripe);
+}
+
+uint16_t NeoPixelStripeGetLength(neopixel_stripe_t *stripe){
+	return stripe->length;
+}
+
+void NeoPixelInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array){
+	NeoPixelStripeDeinit(default_stripe);
+	default_stripe = NeoPixelStripeInit(pin, len, color_array);
+}
+
+void NeoPixelBegin(void){
+	if(default_stripe != NULL){
+		NeoPixelStripeBegin(default_stripe);
+	}
+}
+
+void NeoPixelCommit(void){
+	if(default_stripe != NULL){
+		NeoPixelStripeCommit(default_stripe);
+	}
+}
+
+void NeoPixelSetMaxFps(uint16_t fps){
+	if(default_stripe != NULL){
+		NeoPixelStripeSetMaxFps(default_stripe, fps);
+	}
+}
+
+void NeoPixelAllOff(void){
+	if(default_stripe != NULL){
+		NeoPixelStripeAllOff(default_stripe);
+	}
+}
+
+void NeoPixelAllColor(neopixel_color_t color){
+	if(default_stripe != NULL){
+		NeoPixelStripeAllColor(default_stripe, color);
+	}
+}
+
+void NeoPixelSetPixel(uint16_t pixel, neopixel_color_t color){
+	if(default_stripe != NULL){
+		NeoPixelStripeSetPixel(default_stripe, pixel, color);
+	}
+}
+
+void NeoPixelSetArray(neopixel_color_t *color_array){
+	if(default_stripe != NULL){
+		NeoPixelStripeSetArray(default_stripe, color_array);
+	}
+}
+
+void NeoPixelShift(bool upwards){
+	if(default_stripe != NULL){
+		NeoPixelStripeShift(default_stripe, upwards);
 	}
-	NeoPixelSetArray(stripe_colors);
 }
 
 void NeoPixelBrightness(uint8_t bright){
-	stripe_bright = bright;
-	NeoPixelSetArray(stripe_colors);
+	if(default_stripe != NULL){
+		NeoPixelStripeBrightness(default_stripe, bright);
+	}
+}
+
+void NeoPixelWhiteBalance(uint8_t red, uint8_t green, uint8_t blue){
+	if(default_stripe != NULL){
+		NeoPixelStripeWhiteBalance(default_stripe, red, green, blue);
+	}
 }
 
 void NeoPixelRainbow(uint16_t first_hue, uint8_t sat, uint8_t val, uint8_t reps){
-	for (uint16_t i=0; i<stripe_length; i++) {
-		uint16_t hue = first_hue + (i * reps * 65536) / stripe_length;
-		neopixel_color_t color = NeoPixelHSV2Color(hue, sat, val);
-		stripe_colors[i] = color;
-  	}
-	NeoPixelSetArray(stripe_colors);
+	if(default_stripe != NULL){
+		NeoPixelStripeRainbow(default_stripe, first_hue, sat, val, reps);
+	}
+}
+
+uint16_t NeoPixelGetLength(void){
+	return (default_stripe != NULL) ? default_stripe->length : 0;
 }
 
 neopixel_color_t NeoPixelRgb2Color(uint8_t red, uint8_t green, uint8_t blue){
@@ -126,47 +622,27 @@ neopixel_color_t NeoPixelHSV2Color(uint16_t hue, uint8_t sat, uint8_t val){
 
   uint8_t r, g, b;
 
-  hue = (hue * 1530L + 32768) / 65536;
-  // Convert hue to R,G,B (nested ifs faster than divide+mod+switch):
-  if (hue < 510) { // Red to Green-1
-    b = 0;
-    if (hue < 255) { //   Red to Yellow-1
-      r = 255;
-      g = hue;       //     g = 0 to 254
-    } else {         //   Yellow to Green-1
-      r = 510 - hue; //     r = 255 to 1
-      g = 255;
-    }
-  } else if (hue < 1020) { // Green to Blue-1
-    r = 0;
-    if (hue < 765) { //   Green to Cyan-1
-      g = 255;
-      b = hue - 510;  //     b = 0 to 254
-    } else {          //   Cyan to Blue-1
-      g = 1020 - hue; //     g = 255 to 1
-      b = 255;
-    }
-  } else if (hue < 1530) { // Blue to Red-1
-    g = 0;
-    if (hue < 1275) { //   Blue to Magenta-1
-      r = hue - 1020; //     r = 0 to 254
-      b = 255;
-    } else { //   Magenta to Red-1
-      r = 255;
-      b = 1530 - hue; //     b = 255 to 1
-    }
-  } else { // Last 0.5 Red (quicker than % operator)
-    r = 255;
-    g = b = 0;
-  }
+  NeoPixelHue2Rgb(hue, &r, &g, &b);
 
   // Apply saturation and value to R,G,B, pack into 32-bit result:
   uint32_t v1 = 1 + val;  // 1 to 256; allows >>8 instead of /255
   uint16_t s1 = 1 + sat;  // 1 to 256; same reason
   uint8_t s2 = 255 - sat; // 255 to 0
-  return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
-         (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
-         (((((b * s1) >> 8) + s2) * v1) >> 8);
+  return NeoPixelApplySatVal(r, g, b, s1, s2, v1);
+}
+
+void NeoPixelHSVGradient(neopixel_color_t *colors, uint16_t len, uint16_t first_hue, uint32_t hue_step_q8, uint8_t sat, uint8_t val){
+  uint8_t r, g, b;
+  uint32_t hue_q8 = (uint32_t)first_hue << 8;
+  // Saturation and value factors are the same for all the pixels
+  uint32_t v1 = 1 + val;
+  uint16_t s1 = 1 + sat;
+  uint8_t s2 = 255 - sat;
+  for (uint16_t i = 0; i < len; i++){
+    NeoPixelHue2Rgb(hue_q8 >> 8, &r, &g, &b);
+    colors[i] = NeoPixelApplySatVal(r, g, b, s1, s2, v1);
+    hue_q8 += hue_step_q8;
+  }
 }
 
 /*==================[end of file]============================================*/
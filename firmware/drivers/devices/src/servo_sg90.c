@@ -1,75 +1,192 @@
 
+
 /*==================[inclusions]=============================================*/
 #include "servo_sg90.h"
+#include <stddef.h>
 #include "pwm_mcu.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
+#define SERVO_QTY	6
 #define SERVO_FREQ 	50
 #define MIN_ANG		-90
 #define MAX_ANG		90
-#define ANG_RANGE	180.0
-#define PERIOD_MS   20.0
-#define PULSEW_MS   1.0
-#define PERCENT   	100.0
+#define PERIOD_US   20000
+#define US_PER_MS	1000
+/* NOTE: adjusted (angle x 2) for the available servos: 1000 us every 90 degrees */
+#define US_PER_90DEG	1000
+#define Q16_ONE		65536
+#define Q16_SHIFT	16
 /*==================[internal data declaration]==============================*/
+/**
+ * @brief Servo state
+ */
+typedef struct {
+	uint16_t pulse_us;		/*!< Actual pulse width */
+	uint16_t start_us;		/*!< Pulse width at the start of the trajectory */
+	int32_t delta_us;		/*!< Trajectory displacement */
+	uint32_t elapsed_ms;	/*!< Time since the start of the trajectory */
+	uint32_t duration_ms;	/*!< Trajectory duration */
+	servo_profile_t profile;/*!< Trajectory speed profile */
+	volatile bool moving;	/*!< Trajectory running */
+} servo_state_t;
 
+static servo_state_t servo_state[SERVO_QTY];
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
-
+static const pwm_out_t servo_pwm[SERVO_QTY] = {PWM_0, PWM_1, PWM_2, PWM_3, PWM_4, PWM_5};
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
-uint8_t Angle2DutyCicle(int8_t angle){
-	static float h_time;
-	static float duty_cicle;
-	static int16_t deg;
-	deg = 2 * angle + MAX_ANG;	// NOTE: adjusted (angle x 2) for the available servos
-	h_time = (float)(deg/ANG_RANGE) + PULSEW_MS;
-	duty_cicle = (float)(h_time/PERIOD_MS) * PERCENT;
-	return (uint8_t) duty_cicle;
+static uint16_t Angle2Pulse(int8_t angle){
+	return SERVO_PULSE_CENTER_US + ((int16_t)angle * US_PER_90DEG) / MAX_ANG;
 }
-/*==================[external functions definition]==========================*/
 
-uint8_t ServoInit(servo_out_t servo, gpio_t gpio){
-	switch(servo){
-		case SERVO_0:
-			PWMInit(PWM_0, gpio, SERVO_FREQ);
-			break;
-		case SERVO_1:
-			PWMInit(PWM_1, gpio, SERVO_FREQ);
+/**
+ * @brief Load a pulse width in the PWM output
+ */
+static void IRAM_ATTR ServoWrite(servo_out_t servo, uint16_t pulse_us){
+	if(pulse_us < SERVO_PULSE_MIN_US){
+		pulse_us = SERVO_PULSE_MIN_US;
+	} else if(pulse_us > SERVO_PULSE_MAX_US){
+		pulse_us = SERVO_PULSE_MAX_US;
+	}
+	servo_state[servo].pulse_us = pulse_us;
+	PWMSetDutyTicks(servo_pwm[servo], ((uint64_t)pulse_us * PWMGetDutyMax(servo_pwm[servo])) / PERIOD_US);
+}
+
+/**
+ * @brief Normalized position along the trajectory for a normalized time (both in Q16)
+ */
+static int32_t IRAM_ATTR ServoProfile(servo_profile_t profile, int32_t u){
+	int64_t s;
+	switch(profile){
+		case SERVO_PROFILE_TRAPEZOIDAL:
+			/* Accelerates during 1/4 of the time, peak speed 4/3 */
+			if(u < Q16_ONE / 4){
+				s = (((int64_t)u * u) >> Q16_SHIFT) * 8 / 3;
+			} else if(u < 3 * Q16_ONE / 4){
+				s = ((int64_t)u - Q16_ONE / 8) * 4 / 3;
+			} else{
+				s = Q16_ONE - ((((int64_t)(Q16_ONE - u) * (Q16_ONE - u)) >> Q16_SHIFT) * 8 / 3);
+			}
 			break;
-		case SERVO_2:
-			PWMInit(PWM_2, gpio, SERVO_FREQ);
+		case SERVO_PROFILE_SCURVE:
+			/* Smootherstep: 6u^5 - 15u^4 + 10u^3 = u^3 (10 + u (6u - 15)) */
+			s = (6 * (int64_t)u - 15 * Q16_ONE);
+			s = ((s * u) >> Q16_SHIFT) + 10 * Q16_ONE;
+			s = (s * u) >> Q16_SHIFT;
+			s = (s * u) >> Q16_SHIFT;
+			s = (s * u) >> Q16_SHIFT;
 			break;
-		case SERVO_3:
-			PWMInit(PWM_3, gpio, SERVO_FREQ);
+		default:
+			s = u;
 			break;
 	}
+	return (int32_t)s;
+}
+
+/**
+ * @brief Timer callback. Advances all the trajectories one step.
+ */
+static void IRAM_ATTR ServoMotionTick(void *param){
+	servo_state_t *s;
+	int32_t u;
+	PWMSyncBegin();
+	for(uint8_t i = 0; i < SERVO_QTY; i++){
+		s = &servo_state[i];
+		if(!s->moving){
+			continue;
+		}
+		s->elapsed_ms += SERVO_TICK_MS;
+		if(s->elapsed_ms >= s->duration_ms){
+			s->moving = false;
+			ServoWrite(i, s->start_us + s->delta_us);
+		} else{
+			u = ((uint64_t)s->elapsed_ms << Q16_SHIFT) / s->duration_ms;
+			ServoWrite(i, s->start_us + (((int64_t)s->delta_us * ServoProfile(s->profile, u)) >> Q16_SHIFT));
+		}
+	}
+	PWMSyncEnd();
+}
+/*==================[external functions definition]==========================*/
+
+uint8_t ServoInit(servo_out_t servo, gpio_t gpio){
+	if(servo >= SERVO_QTY){
+		return 1;
+	}
+	servo_state[servo].moving = false;
+	if(PWMInit(servo_pwm[servo], gpio, SERVO_FREQ) != 0){
+		return 1;
+	}
+	ServoWrite(servo, SERVO_PULSE_CENTER_US);
 	return 0;
 }
 
 void ServoMove(servo_out_t servo, int8_t ang){
-	static uint8_t dc;
 	if(ang < MIN_ANG){
 		ang = MIN_ANG;
 	} else if(ang > MAX_ANG){
 		ang = MAX_ANG;
 	}
-	dc = Angle2DutyCicle(ang);
-	switch(servo){
-		case SERVO_0:
-			PWMSetDutyCycle(PWM_0, dc);
-			break;
-		case SERVO_1:
-			PWMSetDutyCycle(PWM_1, dc);
-			break;
-		case SERVO_2:
-			PWMSetDutyCycle(PWM_2, dc);
-			break;
-		case SERVO_3:
-			PWMSetDutyCycle(PWM_3, dc);
-			break;
+	ServoSetPulseUs(servo, Angle2Pulse(ang));
+}
+
+void ServoSetPulseUs(servo_out_t servo, uint16_t pulse_us){
+	if(servo < SERVO_QTY){
+		servo_state[servo].moving = false;
+		ServoWrite(servo, pulse_us);
+	}
+}
+
+uint16_t ServoGetPulseUs(servo_out_t servo){
+	if(servo >= SERVO_QTY){
+		return 0;
+	}
+	return servo_state[servo].pulse_us;
+}
+
+void ServoMotionInit(timer_mcu_t timer){
+	timer_config_t timer_motion = {
+		.timer = timer,
+		.period = SERVO_TICK_MS * US_PER_MS,
+		.func_p = ServoMotionTick,
+		.param_p = NULL
+	};
+	TimerInit(&timer_motion);
+	TimerStart(timer);
+}
+
+void ServoMoveTo(servo_out_t servo, uint16_t target_us, uint32_t duration_ms, servo_profile_t profile){
+	servo_state_t *s;
+	if(servo >= SERVO_QTY){
+		return;
+	}
+	if(duration_ms < SERVO_TICK_MS){
+		ServoSetPulseUs(servo, target_us);
+		return;
+	}
+	if(target_us < SERVO_PULSE_MIN_US){
+		target_us = SERVO_PULSE_MIN_US;
+	} else if(target_us > SERVO_PULSE_MAX_US){
+		target_us = SERVO_PULSE_MAX_US;
+	}
+	s = &servo_state[servo];
+	/* The trajectory is not evaluated by the timer until moving is set */
+	s->moving = false;
+	s->start_us = s->pulse_us;
+	s->delta_us = (int32_t)target_us - s->pulse_us;
+	s->elapsed_ms = 0;
+	s->duration_ms = duration_ms;
+	s->profile = profile;
+	s->moving = true;
+}
+
+bool ServoIsMoving(servo_out_t servo){
+	if(servo >= SERVO_QTY){
+		return false;
 	}
+	return servo_state[servo].moving;
 }
 
 /*==================[end of file]============================================*/
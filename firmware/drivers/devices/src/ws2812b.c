@@ -11,17 +11,69 @@
 
 /*==================[inclusions]=============================================*/
 #include "ws2812b.h"
+#include <stdlib.h>
+#include <string.h>
 #include "gpio_mcu.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "gpio_fast_out_mcu.h"
-#include "delay_mcu.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "driver/rmt_tx.h"
+#include "driver/parlio_tx.h"
 /*==================[macros and definitions]=================================*/
-#define RET_CMD (50)    // ret command 50us low
-#define BIT_0   (1)     // bit 0
-#define BIT_7   (1<<7)  // bit 0
+#define RMT_RESOLUTION_HZ   10000000    /*!< 10 MHz, 1 tick = 0.1us */
+#define RMT_MEM_SYMBOLS     48          /*!< RMT memory (symbols) of one channel */
+#define RMT_QUEUE_DEPTH     4           /*!< Transmissions that can be queued */
+#define T0H_TICKS           4           /*!< bit 0: 0.4us high */
+#define T0L_TICKS           8           /*!< bit 0: 0.8us low */
+#define T1H_TICKS           8           /*!< bit 1: 0.8us high */
+#define T1L_TICKS           4           /*!< bit 1: 0.4us low */
+#define RET_CMD             (280)       /*!< ret command 280us low (50us for older WS2812B) */
+#define RET_TICKS           (RET_CMD * (RMT_RESOLUTION_HZ / 1000000) / 2)
+#define LED_BYTES           3           /*!< Bytes per led (G, R, B) */
+#define LEGACY_BLOCK        (16 * LED_BYTES)    /*!< Legacy buffer grows in blocks of 16 leds */
+#define BUS_CLK_HZ          2400000     /*!< Parallel bus: each WS2812B bit is 3 slots of 0.42us (1: 110, 0: 100) */
+#define BUS_SLOTS_PER_BIT   3
+#define BUS_BYTES_PER_LED   (LED_BYTES * 8 * BUS_SLOTS_PER_BIT)     /*!< One byte per slot (8 lanes) */
+#define BUS_RET_BYTES       (RET_CMD * (BUS_CLK_HZ / 1000000))      /*!< Slots at 0 for the ret command */
 /*==================[internal data declaration]==============================*/
-gpio_t pin_number;
+/**
+ * @brief Encoder: bytes encoder for the colors, followed by the reset code
+ */
+typedef struct {
+    rmt_encoder_t base;             /*!< Must be the first member */
+    rmt_encoder_handle_t bytes_encoder;
+    rmt_encoder_handle_t copy_encoder;
+    int state;                      /*!< 0: sending colors, 1: sending reset code */
+    rmt_symbol_word_t reset_code;
+} ws2812b_encoder_t;
+
+/**
+ * @brief RMT channel driving one stripe
+ */
+struct ws2812b_channel {
+    rmt_channel_handle_t chan;
+    ws2812b_encoder_t encoder;
+    ws2812b_done_cb_t done_cb;
+    void *done_arg;
+};
+
+/**
+ * @brief Parallel bus driving up to 8 stripes
+ */
+struct ws2812b_bus {
+    parlio_tx_unit_handle_t unit;
+    uint8_t lanes;
+    uint16_t max_leds;
+    uint8_t *dma_buf;               /*!< One byte per slot, bit n drives lane n */
+    ws2812b_done_cb_t done_cb;
+    void *done_arg;
+};
+
+static ws2812b_channel_t *default_channel = NULL;  /*!< Channel used by ws2812bInit() API */
+static uint8_t *legacy_buf = NULL;  /*!< Colors stored by ws2812bSend() */
+static size_t legacy_len = 0;
+static size_t legacy_size = 0;
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
@@ -47,283 +99,87 @@ static const uint8_t gamma_table[256] = {
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
-void IRAM_ATTR ws2812bSendHigh(gpio_t pin){
-    GPIOFastWrite(1);
-    //delay 0.8us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-    __asm__ __volatile__ ("nop");   // 28
-    __asm__ __volatile__ ("nop");   // 29
-    __asm__ __volatile__ ("nop");   // 30
-    __asm__ __volatile__ ("nop");   // 31
-    __asm__ __volatile__ ("nop");   // 32
-    __asm__ __volatile__ ("nop");   // 33
-    __asm__ __volatile__ ("nop");   // 34
-    __asm__ __volatile__ ("nop");   // 35
-    __asm__ __volatile__ ("nop");   // 36
-    __asm__ __volatile__ ("nop");   // 37
-    __asm__ __volatile__ ("nop");   // 38
-    __asm__ __volatile__ ("nop");   // 39
-    __asm__ __volatile__ ("nop");   // 40
-    __asm__ __volatile__ ("nop");   // 41
-    __asm__ __volatile__ ("nop");   // 42
-    __asm__ __volatile__ ("nop");   // 43
-    __asm__ __volatile__ ("nop");   // 44
-    __asm__ __volatile__ ("nop");   // 45
-    __asm__ __volatile__ ("nop");   // 46
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 48
-    __asm__ __volatile__ ("nop");   // 49
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 60
-    __asm__ __volatile__ ("nop");   // 61
-    __asm__ __volatile__ ("nop");   // 62
-    __asm__ __volatile__ ("nop");   // 63
-    __asm__ __volatile__ ("nop");   // 64
-    __asm__ __volatile__ ("nop");   // 65
-    __asm__ __volatile__ ("nop");   // 66
-    __asm__ __volatile__ ("nop");   // 67
-    __asm__ __volatile__ ("nop");   // 68
-    __asm__ __volatile__ ("nop");   // 69
-    __asm__ __volatile__ ("nop");   // 70
-    __asm__ __volatile__ ("nop");   // 71
-    __asm__ __volatile__ ("nop");   // 72
-    __asm__ __volatile__ ("nop");   // 73
-    __asm__ __volatile__ ("nop");   // 74
-    __asm__ __volatile__ ("nop");   // 75
-    __asm__ __volatile__ ("nop");   // 76
-    __asm__ __volatile__ ("nop");   // 77
-    __asm__ __volatile__ ("nop");   // 78
-    __asm__ __volatile__ ("nop");   // 79
-    __asm__ __volatile__ ("nop");   // 80
-    __asm__ __volatile__ ("nop");   // 81
-    __asm__ __volatile__ ("nop");   // 82
-    __asm__ __volatile__ ("nop");   // 83
-    __asm__ __volatile__ ("nop");   // 84
-    __asm__ __volatile__ ("nop");   // 85
-    __asm__ __volatile__ ("nop");   // 86
-    __asm__ __volatile__ ("nop");   // 87
-    __asm__ __volatile__ ("nop");   // 88
-    __asm__ __volatile__ ("nop");   // 89
-    __asm__ __volatile__ ("nop");   // 90
-    __asm__ __volatile__ ("nop");   // 91
-    
-    GPIOFastWrite(0);
-	//delay 0.45us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-    __asm__ __volatile__ ("nop");   // 28
-    __asm__ __volatile__ ("nop");   // 29
+static size_t IRAM_ATTR ws2812bEncode(rmt_encoder_t *encoder, rmt_channel_handle_t channel, 
+                                      const void *data, size_t len, rmt_encode_state_t *ret_state){
+    ws2812b_encoder_t *enc = (ws2812b_encoder_t *)encoder;
+    rmt_encode_state_t session_state = RMT_ENCODING_RESET;
+    int state = RMT_ENCODING_RESET;
+    size_t encoded = 0;
+    switch(enc->state){
+        case 0:
+            encoded += enc->bytes_encoder->encode(enc->bytes_encoder, channel, data, len, &session_state);
+            if(session_state & RMT_ENCODING_COMPLETE){
+                enc->state = 1;
+            }
+            if(session_state & RMT_ENCODING_MEM_FULL){
+                /* Continue when there is free space in RMT memory */
+                *ret_state = RMT_ENCODING_MEM_FULL;
+                return encoded;
+            }
+        /* fall-through */
+        case 1:
+            encoded += enc->copy_encoder->encode(enc->copy_encoder, channel, &enc->reset_code,
+                                                 sizeof(enc->reset_code), &session_state);
+            if(session_state & RMT_ENCODING_COMPLETE){
+                enc->state = RMT_ENCODING_RESET;
+                state |= RMT_ENCODING_COMPLETE;
+            }
+            if(session_state & RMT_ENCODING_MEM_FULL){
+                state |= RMT_ENCODING_MEM_FULL;
+            }
+            break;
+    }
+    *ret_state = state;
+    return encoded;
+}
+
+static esp_err_t ws2812bEncoderReset(rmt_encoder_t *encoder){
+    ws2812b_encoder_t *enc = (ws2812b_encoder_t *)encoder;
+    rmt_encoder_reset(enc->bytes_encoder);
+    rmt_encoder_reset(enc->copy_encoder);
+    enc->state = RMT_ENCODING_RESET;
+    return ESP_OK;
+}
+
+static esp_err_t ws2812bEncoderDel(rmt_encoder_t *encoder){
+    ws2812b_encoder_t *enc = (ws2812b_encoder_t *)encoder;
+    rmt_del_encoder(enc->bytes_encoder);
+    rmt_del_encoder(enc->copy_encoder);
+    return ESP_OK;
+}
+
+static bool IRAM_ATTR ws2812bTransDone(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx){
+    ws2812b_channel_t *ch = user_ctx;
+    if(ch->done_cb != NULL){
+        ch->done_cb(ch->done_arg);
+    }
+    return false;
 }
 
-void IRAM_ATTR ws2812bSendLow(gpio_t pin){
-    GPIOFastWrite(1);
-    //delay 0.4us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
+static bool IRAM_ATTR ws2812bBusDone(parlio_tx_unit_handle_t unit, const parlio_tx_done_event_data_t *edata, void *user_ctx){
+    ws2812b_bus_t *bus = user_ctx;
+    if(bus->done_cb != NULL){
+        bus->done_cb(bus->done_arg);
+    }
+    return false;
+}
 
-    GPIOFastWrite(0);
-	//delay 0.85us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-    __asm__ __volatile__ ("nop");   // 28
-    __asm__ __volatile__ ("nop");   // 29
-    __asm__ __volatile__ ("nop");   // 30
-    __asm__ __volatile__ ("nop");   // 31
-    __asm__ __volatile__ ("nop");   // 32
-    __asm__ __volatile__ ("nop");   // 33
-    __asm__ __volatile__ ("nop");   // 34
-    __asm__ __volatile__ ("nop");   // 35
-    __asm__ __volatile__ ("nop");   // 36
-    __asm__ __volatile__ ("nop");   // 37
-    __asm__ __volatile__ ("nop");   // 38
-    __asm__ __volatile__ ("nop");   // 39
-    __asm__ __volatile__ ("nop");   // 40
-    __asm__ __volatile__ ("nop");   // 41
-    __asm__ __volatile__ ("nop");   // 42
-    __asm__ __volatile__ ("nop");   // 43
-    __asm__ __volatile__ ("nop");   // 44
-    __asm__ __volatile__ ("nop");   // 45
-    __asm__ __volatile__ ("nop");   // 46
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 48
-    __asm__ __volatile__ ("nop");   // 49
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 60
-    __asm__ __volatile__ ("nop");   // 61
-    __asm__ __volatile__ ("nop");   // 62
-    __asm__ __volatile__ ("nop");   // 63
-    __asm__ __volatile__ ("nop");   // 64
-    __asm__ __volatile__ ("nop");   // 65
-    __asm__ __volatile__ ("nop");   // 66
-    __asm__ __volatile__ ("nop");   // 67
-    __asm__ __volatile__ ("nop");   // 68
-    __asm__ __volatile__ ("nop");   // 69
-    __asm__ __volatile__ ("nop");   // 70
-    __asm__ __volatile__ ("nop");   // 71
-    __asm__ __volatile__ ("nop");   // 72
-    __asm__ __volatile__ ("nop");   // 73
-    __asm__ __volatile__ ("nop");   // 74
-    __asm__ __volatile__ ("nop");   // 75
-    __asm__ __volatile__ ("nop");   // 76
-    __asm__ __volatile__ ("nop");   // 77
-    __asm__ __volatile__ ("nop");   // 78
-    __asm__ __volatile__ ("nop");   // 79
-    __asm__ __volatile__ ("nop");   // 80
-    __asm__ __volatile__ ("nop");   // 81
-    __asm__ __volatile__ ("nop");   // 82
-    __asm__ __volatile__ ("nop");   // 83
-    __asm__ __volatile__ ("nop");   // 84
-    __asm__ __volatile__ ("nop");   // 85
-    __asm__ __volatile__ ("nop");   // 86
-    __asm__ __volatile__ ("nop");   // 87
-    __asm__ __volatile__ ("nop");   // 88
-    __asm__ __volatile__ ("nop");   // 89
-    __asm__ __volatile__ ("nop");   // 90
-    __asm__ __volatile__ ("nop");   // 91
-    __asm__ __volatile__ ("nop");   // 92
-    __asm__ __volatile__ ("nop");   // 93
-    __asm__ __volatile__ ("nop");   // 94
+/**
+ * @brief Transpose a 8x8 bit matrix: in[lane] bit (7 - b) -> out[b] bit lane
+ */
+static inline void ws2812bTranspose8(const uint8_t in[8], uint8_t out[8]){
+    uint32_t x, y, t;
+    x = ((uint32_t)in[7] << 24) | ((uint32_t)in[6] << 16) | ((uint32_t)in[5] << 8) | in[4];
+    y = ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[1] << 8) | in[0];
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+    out[0] = x >> 24; out[1] = x >> 16; out[2] = x >> 8; out[3] = x;
+    out[4] = y >> 24; out[5] = y >> 16; out[6] = y >> 8; out[7] = y;
 }
 
 uint8_t ws2812bGammaCorrection(uint8_t component){
@@ -331,46 +187,238 @@ uint8_t ws2812bGammaCorrection(uint8_t component){
 }
 
 /*==================[external functions definition]==========================*/
+ws2812b_channel_t *ws2812bChannelInit(gpio_t pin){
+    ws2812b_channel_t *ch = calloc(1, sizeof(ws2812b_channel_t));
+    if(ch == NULL){
+        return NULL;
+    }
+    rmt_tx_channel_config_t tx_chan_config = {
+        .gpio_num = pin,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = RMT_RESOLUTION_HZ,
+        .mem_block_symbols = RMT_MEM_SYMBOLS,
+        .trans_queue_depth = RMT_QUEUE_DEPTH,
+    };
+    if(rmt_new_tx_channel(&tx_chan_config, &ch->chan) != ESP_OK){
+        /* No free RMT channel */
+        free(ch);
+        return NULL;
+    }
 
-void ws2812bInit(gpio_t pin){
-    pin_number = pin;
-    GPIOFastInit(&pin, 1);
+    rmt_bytes_encoder_config_t bytes_encoder_config = {
+        .bit0 = {
+            .level0 = 1,
+            .duration0 = T0H_TICKS,
+            .level1 = 0,
+            .duration1 = T0L_TICKS,
+        },
+        .bit1 = {
+            .level0 = 1,
+            .duration0 = T1H_TICKS,
+            .level1 = 0,
+            .duration1 = T1L_TICKS,
+        },
+        .flags.msb_first = 1
+    };
+    rmt_new_bytes_encoder(&bytes_encoder_config, &ch->encoder.bytes_encoder);
+    rmt_copy_encoder_config_t copy_encoder_config = {};
+    rmt_new_copy_encoder(&copy_encoder_config, &ch->encoder.copy_encoder);
+    ch->encoder.reset_code = (rmt_symbol_word_t) {
+        .level0 = 0,
+        .duration0 = RET_TICKS,
+        .level1 = 0,
+        .duration1 = RET_TICKS,
+    };
+    ch->encoder.state = RMT_ENCODING_RESET;
+    ch->encoder.base.encode = ws2812bEncode;
+    ch->encoder.base.reset = ws2812bEncoderReset;
+    ch->encoder.base.del = ws2812bEncoderDel;
+
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = ws2812bTransDone,
+    };
+    rmt_tx_register_event_callbacks(ch->chan, &cbs, ch);
+    rmt_enable(ch->chan);
+    return ch;
 }
 
-void ws2812bSend(rgb_led_t led_color){
-    uint8_t i;
-	// Blue
-	for(i=0; i<=7; i++){
-        if(ws2812bGammaCorrection(led_color.green) & (BIT_7>>i)){
-            ws2812bSendHigh(pin_number);
-        }
-        else{
-            ws2812bSendLow(pin_number);
+void ws2812bChannelDeinit(ws2812b_channel_t *ch){
+    if(ch == NULL){
+        return;
+    }
+    rmt_tx_wait_all_done(ch->chan, -1);
+    rmt_disable(ch->chan);
+    rmt_del_channel(ch->chan);
+    ws2812bEncoderDel(&ch->encoder.base);
+    free(ch);
+}
+
+bool ws2812bChannelTransmit(ws2812b_channel_t *ch, const uint8_t *grb, size_t len, ws2812b_done_cb_t done_cb, void *arg){
+    rmt_transmit_config_t tx_config = {
+        .loop_count = 0,
+    };
+    if((ch == NULL) || (len == 0)){
+        return false;
+    }
+    /* One transmission at a time, so the callback belongs to this buffer */
+    rmt_tx_wait_all_done(ch->chan, -1);
+    ch->done_cb = done_cb;
+    ch->done_arg = arg;
+    return rmt_transmit(ch->chan, &ch->encoder.base, grb, len, &tx_config) == ESP_OK;
+}
+
+bool ws2812bChannelWaitDone(ws2812b_channel_t *ch, int32_t timeout_ms){
+    if(ch == NULL){
+        return true;
+    }
+    return rmt_tx_wait_all_done(ch->chan, timeout_ms) == ESP_OK;
+}
+
+ws2812b_bus_t *ws2812bBusInit(const gpio_t *pins, uint8_t lanes, uint16_t max_leds){
+    ws2812b_bus_t *bus;
+    size_t buf_size;
+    if((lanes == 0) || (lanes > WS2812B_BUS_MAX_LANES) || (max_leds == 0) || (max_leds > WS2812B_BUS_MAX_LEDS)){
+        return NULL;
+    }
+    bus = calloc(1, sizeof(ws2812b_bus_t));
+    if(bus == NULL){
+        return NULL;
+    }
+    buf_size = (size_t)max_leds * BUS_BYTES_PER_LED + BUS_RET_BYTES;
+    bus->dma_buf = heap_caps_calloc(1, buf_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if(bus->dma_buf == NULL){
+        free(bus);
+        return NULL;
+    }
+    bus->lanes = lanes;
+    bus->max_leds = max_leds;
+
+    parlio_tx_unit_config_t config = {
+        .clk_src = PARLIO_CLK_SRC_DEFAULT,
+        .clk_in_gpio_num = -1,
+        .output_clk_freq_hz = BUS_CLK_HZ,
+        .data_width = WS2812B_BUS_MAX_LANES,
+        .clk_out_gpio_num = -1,
+        .valid_gpio_num = -1,
+        .trans_queue_depth = RMT_QUEUE_DEPTH,
+        .max_transfer_size = buf_size,
+        .sample_edge = PARLIO_SAMPLE_EDGE_POS,
+        .bit_pack_order = PARLIO_BIT_PACK_ORDER_MSB,
+    };
+    for(uint8_t i = 0; i < PARLIO_TX_UNIT_MAX_DATA_WIDTH; i++){
+        config.data_gpio_nums[i] = (i < lanes) ? (int)pins[i] : -1;
+    }
+    if(parlio_new_tx_unit(&config, &bus->unit) != ESP_OK){
+        heap_caps_free(bus->dma_buf);
+        free(bus);
+        return NULL;
+    }
+    parlio_tx_event_callbacks_t cbs = {
+        .on_trans_done = ws2812bBusDone,
+    };
+    parlio_tx_unit_register_event_callbacks(bus->unit, &cbs, bus);
+    parlio_tx_unit_enable(bus->unit);
+    return bus;
+}
+
+bool ws2812bBusTransmit(ws2812b_bus_t *bus, const uint8_t *const *grb, const uint16_t *leds, 
+                        ws2812b_done_cb_t done_cb, void *arg){
+    parlio_transmit_config_t tx_config = {
+        .idle_value = 0,
+    };
+    uint16_t max = 0;
+    uint8_t in[8], bits[8];
+    uint8_t active;
+    uint8_t *out;
+    if(bus == NULL){
+        return false;
+    }
+    for(uint8_t l = 0; l < bus->lanes; l++){
+        if(leds[l] > max){
+            max = leds[l];
         }
     }
-	// Red
-    for(i=0; i<=7; i++){
-        if(ws2812bGammaCorrection(led_color.red) & (BIT_7>>i)){
-            ws2812bSendHigh(pin_number);
+    if(max > bus->max_leds){
+        max = bus->max_leds;
+    }
+    if(max == 0){
+        return false;
+    }
+    /* DMA buffer can't change while it is transmitted */
+    parlio_tx_unit_wait_all_done(bus->unit, -1);
+    out = bus->dma_buf;
+    for(uint16_t led = 0; led < max; led++){
+        /* Lanes with a shorter stripe stay low */
+        active = 0;
+        for(uint8_t l = 0; l < bus->lanes; l++){
+            if(led < leds[l]){
+                active |= 1 << l;
+            }
         }
-        else{
-            ws2812bSendLow(pin_number);
+        for(uint8_t byte = 0; byte < LED_BYTES; byte++){
+            for(uint8_t l = 0; l < WS2812B_BUS_MAX_LANES; l++){
+                in[l] = ((active >> l) & 1) ? grb[l][LED_BYTES * led + byte] : 0;
+            }
+            ws2812bTranspose8(in, bits);
+            for(uint8_t b = 0; b < 8; b++){
+                *out++ = active;        /* Slot 1: high */
+                *out++ = bits[b];       /* Slot 2: data */
+                *out++ = 0;             /* Slot 3: low */
+            }
         }
     }
-	// Green
-    for(i=0; i<=7; i++){
-        if(ws2812bGammaCorrection(led_color.blue) & (BIT_7>>i)){
-            ws2812bSendHigh(pin_number);
-        }
-        else{
-            ws2812bSendLow(pin_number);
+    /* Ret command */
+    memset(out, 0, BUS_RET_BYTES);
+    out += BUS_RET_BYTES;
+    bus->done_cb = done_cb;
+    bus->done_arg = arg;
+    return parlio_tx_unit_transmit(bus->unit, bus->dma_buf, (out - bus->dma_buf) * 8, &tx_config) == ESP_OK;
+}
+
+bool ws2812bBusWaitDone(ws2812b_bus_t *bus, int32_t timeout_ms){
+    if(bus == NULL){
+        return true;
+    }
+    return parlio_tx_unit_wait_all_done(bus->unit, timeout_ms) == ESP_OK;
+}
+
+void ws2812bInit(gpio_t pin){
+    default_channel = ws2812bChannelInit(pin);
+}
+
+bool ws2812bTransmit(const uint8_t *grb, size_t len, ws2812b_done_cb_t done_cb, void *arg){
+    return ws2812bChannelTransmit(default_channel, grb, len, done_cb, arg);
+}
+
+bool ws2812bWaitDone(int32_t timeout_ms){
+    return ws2812bChannelWaitDone(default_channel, timeout_ms);
+}
+
+void ws2812bSend(rgb_led_t led_color){
+    uint8_t *aux;
+    if(legacy_len + LED_BYTES > legacy_size){
+        aux = realloc(legacy_buf, legacy_size + LEGACY_BLOCK);
+        if(aux == NULL){
+            return;
         }
+        legacy_buf = aux;
+        legacy_size += LEGACY_BLOCK;
+    }
+    /* Buffer can't change while it is transmitted */
+    if(legacy_len == 0){
+        ws2812bWaitDone(-1);
     }
+    legacy_buf[legacy_len++] = ws2812bGammaCorrection(led_color.green);
+    legacy_buf[legacy_len++] = ws2812bGammaCorrection(led_color.red);
+    legacy_buf[legacy_len++] = ws2812bGammaCorrection(led_color.blue);
 }
 
 void ws2812bSendRet(void){
-    GPIOFastWrite(0);
-    DelayUs(RET_CMD);
+    if(legacy_len > 0){
+        ws2812bTransmit(legacy_buf, legacy_len, NULL, NULL);
+        ws2812bWaitDone(-1);
+        legacy_len = 0;
+    }
 }
 
 /*==================[end of file]============================================*/
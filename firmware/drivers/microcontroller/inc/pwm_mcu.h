@@ -11,8 +11,17 @@
  *
  * This driver provide functions to generate PWM signals 
  *
- * @note It can setup up to 4 PWM outputs, with independet duty 
- * cycle and frequency configuration
+ * @note It can setup up to 6 PWM outputs, with independet duty 
+ * cycle. Outputs with the same frequency share one of the 4 LEDC timers, so 
+ * up to 4 different frequencies can be used at the same time.
+ *
+ * @note Duty cycle resolution is selected automatically from the PWM frequency
+ * (the highest resolution available for that frequency, up to 19 bits). Besides
+ * the duty cycle in %, it can be set in timer ticks or as a Q16 fraction.
+ *
+ * @note PWMOn(), PWMOff(), the PWMSetDuty functions and PWMSyncBegin()/PWMSyncEnd() 
+ * can be called from timer callbacks (interrupts), except for outputs that used 
+ * PWMSetFade(): their duty cycle can only be changed from tasks.
  *
  * @author Albano Peñalva
  * 
@@ -21,6 +30,9 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 23/01/2024 | Document creation		                         |
+ * | 19/10/2026 | High resolution duty cycle and hardware fade   |
+ * | 19/10/2026 | Shared timers, 6 outputs and synchronized duty |
+ * | 19/10/2026 | Duty cycle updates from interrupts             |
  *
  */
 
@@ -28,13 +40,16 @@
 #include <stdint.h>
 #include <gpio_mcu.h>
 /*==================[macros]=================================================*/
+#define PWM_Q16_ONE		65536		/*!< Duty cycle 100% as Q16 fraction */
 
 /*==================[typedef]================================================*/
 typedef enum pwm_out {
 	PWM_0,      /**< PWM output 1 */
 	PWM_1,		/**< PWM output 2 */
 	PWM_2,		/**< PWM output 3 */
-	PWM_3		/**< PWM output 4 */
+	PWM_3,		/**< PWM output 4 */
+	PWM_4,		/**< PWM output 5 */
+	PWM_5		/**< PWM output 6 */
 } pwm_out_t;
 /*==================[internal data declaration]==============================*/
 
@@ -48,7 +63,7 @@ typedef enum pwm_out {
  * @param out PWM output
  * @param gpio GPIO pin number
  * @param freq PWM wave frequency
- * @return uint8_t 
+ * @return uint8_t 0: success, 1: error (no LEDC timer available for the frequency)
  */
 uint8_t PWMInit(pwm_out_t out, gpio_t gpio, uint16_t freq);
 
@@ -77,12 +92,86 @@ void PWMSetDutyCycle(pwm_out_t out, uint8_t duty_cycle);
 /**
  * @brief Change frequency of an PWM output
  * 
+ * @note If the timer is shared with other outputs, the output is moved to 
+ * another timer, so the frequency of the other outputs doesn't change.
+ * 
  * @param out PWM output 
  * @param freq Frequency of PWM output (40kHz máx)
- * @return uint8_t 
+ * @return uint8_t 0: success, 1: error (no LEDC timer available for the frequency)
  */
 uint8_t PWMSetFreq(pwm_out_t out, uint32_t freq);
 
+/**
+ * @brief Get the duty cycle resolution of an PWM output
+ * 
+ * @param out PWM output 
+ * @return uint8_t Resolution in bits
+ */
+uint8_t PWMGetResolution(pwm_out_t out);
+
+/**
+ * @brief Get the number of timer ticks of a PWM period (duty cycle 100%)
+ * 
+ * @param out PWM output 
+ * @return uint32_t 2^resolution
+ */
+uint32_t PWMGetDutyMax(pwm_out_t out);
+
+/**
+ * @brief Change PWM duty cycle of an PWM output, in timer ticks
+ * 
+ * @param out PWM output 
+ * @param ticks High time in timer ticks (0 to PWMGetDutyMax())
+ */
+void PWMSetDutyTicks(pwm_out_t out, uint32_t ticks);
+
+/**
+ * @brief Change PWM duty cycle of an PWM output, as Q16 fraction
+ * 
+ * @param out PWM output 
+ * @param duty_q16 duty cycle (0 to PWM_Q16_ONE)
+ */
+void PWMSetDutyQ16(pwm_out_t out, uint32_t duty_q16);
+
+/**
+ * @brief Change PWM duty cycle gradually, using the LEDC hardware fade.
+ * 
+ * @note The function returns immediately, and the duty cycle is updated by 
+ * hardware (without CPU intervention) until it reaches the target value.
+ * 
+ * @note After a fade, duty cycle changes of the output made from interrupts are ignored.
+ * 
+ * @param out PWM output 
+ * @param duty_q16 Target duty cycle (0 to PWM_Q16_ONE)
+ * @param time_ms Fade time (in ms)
+ * @return uint8_t 0: success, 1: error
+ */
+uint8_t PWMSetFade(pwm_out_t out, uint32_t duty_q16, uint32_t time_ms);
+
+/**
+ * @brief Stop a running fade, keeping the actual duty cycle
+ * 
+ * @param out PWM output 
+ */
+void PWMStopFade(pwm_out_t out);
+
+/**
+ * @brief Start a synchronized duty cycle update.
+ * 
+ * @note Duty cycles set after this call (by any of the PWMSetDuty functions) 
+ * are held until PWMSyncEnd() is called. Tasks and interrupts have separate 
+ * updates, so a timer callback doesn't apply (or hold) the duty cycles of a 
+ * task. Calls can be nested: the outermost PWMSyncEnd() applies the duty cycles.
+ */
+void PWMSyncBegin(void);
+
+/**
+ * @brief Apply all the duty cycles set since PWMSyncBegin().
+ * 
+ * @note Outputs sharing a timer change their duty cycle in the same PWM period.
+ */
+void PWMSyncEnd(void);
+
 /**
  * @brief PWM output de-inicialization
  * 
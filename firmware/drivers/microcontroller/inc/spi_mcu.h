@@ -14,6 +14,10 @@
  * 
  * @note MISO: GPIO_22, MOSI: GPIO_21, SCLK: GPIO_20, CS1: GPIO_19, CS2: GPIO_18, CS3: GPIO_9
  * 
+ * @note Each device has its own configuration and queue of transactions, so several devices
+ * (e.g. a display and a sensor or SD card) share the bus: their transactions are interleaved
+ * by the driver. The functions of a device must be called from a single task.
+ * 
  * @author Albano Peñalva
  *
  * @section changelog
@@ -21,12 +25,17 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 09/02/2024 | Document creation		                         						|
+ * | 19/10/2026 | Queued (DMA) writes and pre-transaction callback						|
+ * | 19/10/2026 | Command and answer read without releasing CS							|
+ * | 19/10/2026 | Per device state, queued reads, post-transaction callback, bus lock	|
+ * | 19/10/2026 | Bitrate change of an initialized device								|
  * 
  **/
 /*==================[inclusions]=============================================*/
 #include <stdbool.h>
 #include <stdint.h>
 /*==================[macros]=================================================*/
+#define SPI_MAX_TRANSFER_SIZE	8192	/*!< Max bytes in one transaction */
 
 /*==================[typedef]================================================*/
 
@@ -68,6 +77,10 @@ typedef struct{
 	transfer_mode_t transfer_mode;	/*!< Transfer mode */
 	void *func_p;					/*!< Pointer to callback function for transaction end */
 	void *param_p;					/*!< Pointer to callback parameter */
+	void (*pre_func_p)(void *);		/*!< Function called (in ISR) before each transaction starts, 
+										 with the user value of the transaction (NULL: none) */
+	void (*post_func_p)(void *);	/*!< Function called (in ISR) after each transaction ends, 
+										 with the user value of the transaction (NULL: none) */
 } spi_mcu_config_t;
 /*==================[external data declaration]==============================*/
 
@@ -75,11 +88,26 @@ typedef struct{
 /**
  * @brief Initialize SPI module with the corresponding configuration
  * 
+ * @note A device already initialized is added again with the new configuration (its
+ * queued transactions are waited and its bus lock is released).
+ * 
  * @param spi Structure with the module configuration
- * @return uint8_t 
+ * @return uint8_t 0 if success
  */
 uint8_t SpiInit(spi_mcu_config_t* spi);
 
+/**
+ * @brief Change the clock of an initialized device (e.g. a slower clock for reads)
+ * 
+ * @note Waits the queued transactions, and adds the device to the bus again (it takes
+ * longer than a transaction). Callbacks and bus lock are kept.
+ * 
+ * @param device SPI device
+ * @param bitrate Transfer speed (up to 26MHz)
+ * @return uint8_t 0 if success
+ */
+uint8_t SpiSetBitrate(spi_dev_t device, uint32_t bitrate);
+
 /**
  * @brief Read data from SPI port
  * 
@@ -108,11 +136,123 @@ void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size);
  */
 void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size);
 
+/**
+ * @brief Queue a write transaction, that is transmitted in background (using DMA).
+ * 
+ * @note The buffer must be DMA capable (see SpiDmaMalloc()) and can't be modified 
+ * until the transaction ends (see SpiQueueWait()). If there are already 8 transactions 
+ * in flight, waits the end of the oldest one.
+ * 
+ * @param device SPI device to write to
+ * @param tx_buffer pointer to buffer where data is stored
+ * @param tx_buffer_size numbers of bytes to write (up to SPI_MAX_TRANSFER_SIZE)
+ * @param user value passed to the pre and post-transaction functions (see spi_mcu_config_t)
+ * @return true if the transaction was queued
+ */
+bool SpiQueueWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void *user);
+
+/**
+ * @brief Queue a write and read (full duplex) transaction, that is transmitted in background (using DMA).
+ * 
+ * @note Same as SpiQueueWrite(). The received bytes are in rx_buffer when the transaction
+ * ends: the post-transaction function is called (see spi_mcu_config_t), or SpiQueueWait()
+ * and SpiQueuePending() return. rx_buffer must be DMA capable (see SpiDmaMalloc()).
+ * 
+ * @param device SPI device
+ * @param tx_buffer pointer to buffer with data to write (NULL: only read)
+ * @param rx_buffer pointer to buffer where data read is stored (NULL: only write)
+ * @param buffer_size numbers of bytes to write and read (up to SPI_MAX_TRANSFER_SIZE)
+ * @param user value passed to the pre and post-transaction functions (see spi_mcu_config_t)
+ * @return true if the transaction was queued
+ */
+bool SpiQueueTransfer(spi_dev_t device, const uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size, void *user);
+
+/**
+ * @brief Wait until at most max_pending queued transactions are in flight.
+ * 
+ * @param device SPI device
+ * @param max_pending transactions that can remain in flight (0: wait all)
+ */
+void SpiQueueWait(spi_dev_t device, uint8_t max_pending);
+
+/**
+ * @brief Queued transactions still in flight (doesn't wait).
+ * 
+ * @note Buffers of the transactions that ended can be used again.
+ * 
+ * @param device SPI device
+ * @return uint8_t transactions in flight
+ */
+uint8_t SpiQueuePending(spi_dev_t device);
+
+/**
+ * @brief Reserve the bus for a device, until SpiBusRelease(): transactions of the other
+ * devices wait, so a sequence of transactions (burst) isn't interrupted.
+ * 
+ * @note Calls can be nested (the bus is released with the last SpiBusRelease()).
+ * 
+ * @param device SPI device
+ */
+void SpiBusAcquire(spi_dev_t device);
+
+/**
+ * @brief Release the bus reserved with SpiBusAcquire().
+ * 
+ * @param device SPI device
+ */
+void SpiBusRelease(spi_dev_t device);
+
+/**
+ * @brief Write data from SPI port (polling), with a value for the pre-transaction function.
+ * 
+ * @note Waits the end of the queued transactions first.
+ * 
+ * @param device SPI device to write to
+ * @param tx_buffer pointer to buffer where data is stored
+ * @param tx_buffer_size numbers of bytes to write
+ * @param user value passed to the pre and post-transaction functions (see spi_mcu_config_t)
+ */
+void SpiPollingWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void *user);
+
+/**
+ * @brief Write a command and read its answer (polling), without releasing CS between them.
+ * 
+ * @note Waits the end of the queued transactions first. The bus is reserved for the device
+ * during both transactions.
+ * 
+ * @param device SPI device
+ * @param tx_buffer pointer to buffer with the command
+ * @param tx_buffer_size numbers of bytes to write
+ * @param tx_user value passed to the pre and post-transaction functions for the command
+ * @param rx_buffer pointer to buffer where the answer is stored
+ * @param rx_buffer_size numbers of bytes to read (up to SPI_MAX_TRANSFER_SIZE)
+ * @param rx_user value passed to the pre and post-transaction functions for the answer
+ */
+void SpiPollingRead(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void *tx_user,
+					uint8_t * rx_buffer, uint32_t rx_buffer_size, void *rx_user);
+
+/**
+ * @brief Allocate a buffer that can be used for DMA transactions.
+ * 
+ * @param size buffer size in bytes
+ * @return void* buffer, NULL if there is no memory
+ */
+void *SpiDmaMalloc(uint32_t size);
+
+/**
+ * @brief Free a buffer allocated with SpiDmaMalloc().
+ * 
+ * @param buffer buffer
+ */
+void SpiDmaFree(void *buffer);
+
 /**
  * @brief De-Initialize SPI module with the corresponding configuration
  * 
+ * @note Waits the queued transactions. The bus is freed with its last device.
+ * 
  * @param device SPI device 
- * @return uint8_t 
+ * @return uint8_t 0 if success
  */
 uint8_t SpiDeInit(spi_dev_t device);
 
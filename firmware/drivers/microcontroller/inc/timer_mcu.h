@@ -17,6 +17,7 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 20/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | TimerDeInit() added			                         				|
  * 
  **/
 
@@ -98,6 +99,15 @@ void TimerReset(timer_mcu_t timer);
  */
 void TimerUpdatePeriod(timer_mcu_t timer, uint32_t period);
 
+/**
+ * @brief Stop and release timer
+ *
+ * The timer can be used again (with other period and function) after a new call to TimerInit().
+ *
+ * @param timer Timer number
+ */
+void TimerDeInit(timer_mcu_t timer);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -11,10 +11,22 @@
 
 /*==================[inclusions]=============================================*/
 #include "pwm_mcu.h"
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
 #include "driver/ledc.h"
 /*==================[macros and definitions]=================================*/
-#define DC_MAX  1023
-#define DC_100  100
+#define DC_100          100
+#define PWM_QTY         6                       /*!< Number of PWM outputs (one per LEDC channel) */
+#define TIMER_QTY       4                       /*!< Number of LEDC timers */
+#define NO_TIMER        TIMER_QTY
+#define SRC_CLK_HZ      80000000                /*!< LEDC source clock (PLL_80M, selected by LEDC_AUTO_CLK) */
+/* Duty 100% (2^res ticks) can't be set at the widest timer resolution, so 1 bit less is used (19 bits) */
+#define RES_MAX         (LEDC_TIMER_BIT_MAX - 2)/*!< Max duty resolution */
+#define RES_MIN         1                       /*!< Min duty resolution */
+#define Q16_SHIFT       16
+#define SYNC_TASK       0                       /*!< Synchronized update started by a task */
+#define SYNC_ISR        1                       /*!< Synchronized update started by an interrupt */
+#define SYNC_QTY        2
 /*==================[internal data declaration]==============================*/
 static ledc_timer_config_t pwm_timer_cfg = {
     .speed_mode       = LEDC_LOW_SPEED_MODE,
@@ -27,150 +39,335 @@ static ledc_channel_config_t ledc_channel_cfg = {
     .duty           = 0,       /*!< Starts in 0% */
     .hpoint         = 0
 };
+static uint32_t timer_freq[TIMER_QTY];      /*!< Frequency of each LEDC timer */
+static uint8_t timer_res[TIMER_QTY];        /*!< Duty resolution (in bits) of each LEDC timer */
+static uint8_t timer_users[TIMER_QTY];      /*!< Number of outputs using each LEDC timer */
+static uint8_t pwm_timer[PWM_QTY];          /*!< LEDC timer used by each output */
+static uint32_t pwm_duty[PWM_QTY];          /*!< Duty cycle (in ticks) of each output */
+static bool pwm_init[PWM_QTY];              /*!< Output initialized (holds a timer) */
+static bool pwm_on[PWM_QTY];                /*!< Output enabled */
+static bool pwm_fade[PWM_QTY];              /*!< Output used the fade service (LEDC keeps a fade semaphore for it) */
+static bool fade_installed = false;         /*!< LEDC fade service installed */
+static uint8_t sync_active[SYNC_QTY];       /*!< Synchronized updates in progress (nested calls) of tasks and interrupts */
+static uint8_t sync_pending[SYNC_QTY];      /*!< Outputs with duty waiting for PWMSyncEnd() (bit mask) */
+static portMUX_TYPE pwm_spinlock = portMUX_INITIALIZER_UNLOCKED;
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
-
+/* PWM_x output uses LEDC_CHANNEL_x */
+static const ledc_channel_t pwm_channel[PWM_QTY] = {LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, 
+                                                    LEDC_CHANNEL_3, LEDC_CHANNEL_4, LEDC_CHANNEL_5};
+static const ledc_timer_t ledc_timer[TIMER_QTY] = {LEDC_TIMER_0, LEDC_TIMER_1, LEDC_TIMER_2, LEDC_TIMER_3};
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/**
+ * @brief Highest duty resolution for a PWM frequency (freq * 2^res must not exceed the source clock)
+ */
+static uint8_t PWMResolution(uint32_t freq){
+    uint8_t res = RES_MAX;
+    if(freq == 0){
+        return RES_MAX;
+    }
+    while((res > RES_MIN) && (((uint64_t)freq << res) > SRC_CLK_HZ)){
+        res--;
+    }
+    return res;
+}
+
+/**
+ * @brief Configure a LEDC timer
+ */
+static void PWMTimerConfig(uint8_t t, uint32_t freq, uint8_t res){
+    pwm_timer_cfg.freq_hz = freq;
+    pwm_timer_cfg.duty_resolution = res;
+    pwm_timer_cfg.timer_num = ledc_timer[t];
+    ledc_timer_config(&pwm_timer_cfg);
+    timer_freq[t] = freq;
+    timer_res[t] = res;
+}
 
+/**
+ * @brief Get a LEDC timer running at freq: a timer already in use at that frequency, 
+ * or a free one (configured here). Returns NO_TIMER if all timers are busy.
+ */
+static uint8_t PWMTimerGet(uint32_t freq){
+    uint8_t free = NO_TIMER;
+    for(uint8_t t = 0; t < TIMER_QTY; t++){
+        if(timer_users[t] == 0){
+            if(free == NO_TIMER){
+                free = t;
+            }
+        } else if(timer_freq[t] == freq){
+            timer_users[t]++;
+            return t;
+        }
+    }
+    if(free != NO_TIMER){
+        PWMTimerConfig(free, freq, PWMResolution(freq));
+        timer_users[free] = 1;
+    }
+    return free;
+}
+
+/**
+ * @brief Release a LEDC timer. The timer is paused when no output uses it.
+ */
+static void PWMTimerRelease(uint8_t t){
+    if((t < TIMER_QTY) && (timer_users[t] > 0)){
+        if(--timer_users[t] == 0){
+            ledc_timer_pause(LEDC_LOW_SPEED_MODE, ledc_timer[t]);
+        }
+    }
+}
+
+/**
+ * @brief Scale a duty cycle (in ticks) between resolutions
+ */
+static uint32_t PWMRescale(uint32_t ticks, uint8_t from, uint8_t to){
+    return (to >= from) ? (ticks << (to - from)) : (ticks >> (from - to));
+}
+
+/**
+ * @brief Synchronized update slot of the caller (tasks and interrupts don't share it)
+ */
+static inline uint8_t PWMSyncSlot(void){
+    return xPortInIsrContext() ? SYNC_ISR : SYNC_TASK;
+}
+
+/**
+ * @brief Load a new duty cycle (in ticks) in the LEDC channel. It can be called from 
+ * interrupts (timer callbacks) for outputs that don't use the fade service.
+ */
+static void PWMWriteDuty(pwm_out_t out, uint32_t ticks){
+    uint32_t max = 1UL << timer_res[pwm_timer[out]];
+    uint8_t slot = PWMSyncSlot();
+    if(ticks > max){
+        ticks = max;
+    }
+    pwm_duty[out] = ticks;
+    if(!pwm_on[out]){
+        /* Applied by PWMOn() */
+        return;
+    }
+    if(pwm_fade[out]){
+        /* LEDC protects fading channels with a semaphore: only tasks can update them */
+        if(slot == SYNC_TASK){
+            ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, pwm_channel[out], ticks, 0);
+        }
+        return;
+    }
+    /* Only registers are written (ledc_set_duty_and_update() takes a mutex, so it isn't ISR safe) */
+    portENTER_CRITICAL_SAFE(&pwm_spinlock);
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, pwm_channel[out], ticks);
+    if(sync_active[slot] > 0){
+        /* Applied by PWMSyncEnd() */
+        sync_pending[slot] |= (1 << out);
+    } else{
+        ledc_update_duty(LEDC_LOW_SPEED_MODE, pwm_channel[out]);
+    }
+    portEXIT_CRITICAL_SAFE(&pwm_spinlock);
+}
 /*==================[external functions definition]==========================*/
 uint8_t PWMInit(pwm_out_t out, gpio_t gpio, uint16_t freq){
-    switch(out){
-        case PWM_0:
-            pwm_timer_cfg.freq_hz = freq;
-            pwm_timer_cfg.timer_num = LEDC_TIMER_0;
-            ledc_timer_config(&pwm_timer_cfg);
-            ledc_channel_cfg.channel = LEDC_CHANNEL_0;
-            ledc_channel_cfg.timer_sel = LEDC_TIMER_0;
-            ledc_channel_cfg.gpio_num = gpio;
-            ledc_channel_config(&ledc_channel_cfg);
-            break;
-        case PWM_1:
-            pwm_timer_cfg.freq_hz = freq;
-            pwm_timer_cfg.timer_num = LEDC_TIMER_1;
-            ledc_timer_config(&pwm_timer_cfg);
-            ledc_channel_cfg.channel = LEDC_CHANNEL_1;
-            ledc_channel_cfg.timer_sel = LEDC_TIMER_1;
-            ledc_channel_cfg.gpio_num = gpio;
-            ledc_channel_config(&ledc_channel_cfg);
-            break;
-        case PWM_2:
-            pwm_timer_cfg.freq_hz = freq;
-            pwm_timer_cfg.timer_num = LEDC_TIMER_2;
-            ledc_timer_config(&pwm_timer_cfg);
-            ledc_channel_cfg.channel = LEDC_CHANNEL_2;
-            ledc_channel_cfg.timer_sel = LEDC_TIMER_2;
-            ledc_channel_cfg.gpio_num = gpio;
-            ledc_channel_config(&ledc_channel_cfg);
-            break;
-        case PWM_3:
-            pwm_timer_cfg.freq_hz = freq;
-            pwm_timer_cfg.timer_num = LEDC_TIMER_3;
-            ledc_timer_config(&pwm_timer_cfg);
-            ledc_channel_cfg.channel = LEDC_CHANNEL_3;
-            ledc_channel_cfg.timer_sel = LEDC_TIMER_3;
-            ledc_channel_cfg.gpio_num = gpio;
-            ledc_channel_config(&ledc_channel_cfg);
-            break;
+    uint8_t t;
+    if(out >= PWM_QTY){
+        return 1;
+    }
+    if(pwm_init[out]){
+        /* Re-initialization: release the previous timer */
+        PWMTimerRelease(pwm_timer[out]);
+        pwm_init[out] = false;
     }
+    t = PWMTimerGet(freq);
+    if(t == NO_TIMER){
+        pwm_on[out] = false;
+        return 1;
+    }
+    pwm_init[out] = true;
+    pwm_timer[out] = t;
+    pwm_duty[out] = 0;
+    pwm_on[out] = true;
+    ledc_channel_cfg.channel = pwm_channel[out];
+    ledc_channel_cfg.timer_sel = ledc_timer[t];
+    ledc_channel_cfg.gpio_num = gpio;
+    ledc_channel_config(&ledc_channel_cfg);
+    ledc_timer_resume(LEDC_LOW_SPEED_MODE, ledc_timer[t]);
     return 0;
 }
 
 void PWMOn(pwm_out_t out){
-    switch(out){
-        case PWM_0:
-            ledc_timer_resume(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0);
-            break;
-        case PWM_1:
-            ledc_timer_resume(LEDC_LOW_SPEED_MODE, LEDC_TIMER_1);
-            break;
-        case PWM_2:
-            ledc_timer_resume(LEDC_LOW_SPEED_MODE, LEDC_TIMER_2);
-            break;
-        case PWM_3:
-            ledc_timer_resume(LEDC_LOW_SPEED_MODE, LEDC_TIMER_3);
-            break;
+    if((out < PWM_QTY) && pwm_init[out] && !pwm_on[out]){
+        /* Updating the duty cycle enables the channel output again */
+        pwm_on[out] = true;
+        PWMWriteDuty(out, pwm_duty[out]);
     }
 }
 
 void PWMOff(pwm_out_t out){
-    switch(out){
-        case PWM_0:
-            ledc_timer_pause(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0);
-            break;
-        case PWM_1:
-            ledc_timer_pause(LEDC_LOW_SPEED_MODE, LEDC_TIMER_1);
-            break;
-        case PWM_2:
-            ledc_timer_pause(LEDC_LOW_SPEED_MODE, LEDC_TIMER_2);
-            break;
-        case PWM_3:
-            ledc_timer_pause(LEDC_LOW_SPEED_MODE, LEDC_TIMER_3);
-            break;
+    if((out < PWM_QTY) && pwm_on[out]){
+        /* The timer may be shared, so only this channel is stopped (output low) */
+        portENTER_CRITICAL_SAFE(&pwm_spinlock);
+        ledc_stop(LEDC_LOW_SPEED_MODE, pwm_channel[out], 0);
+        pwm_on[out] = false;
+        for(uint8_t slot = 0; slot < SYNC_QTY; slot++){
+            sync_pending[slot] &= ~(1 << out);
+        }
+        portEXIT_CRITICAL_SAFE(&pwm_spinlock);
     }
 }
 
 void PWMSetDutyCycle(pwm_out_t out, uint8_t duty_cycle){
+    if(out >= PWM_QTY){
+        return;
+    }
     if(duty_cycle > DC_100){
         duty_cycle = DC_100;
     }
-    uint32_t dc = ((uint32_t)duty_cycle * DC_MAX) / DC_100;
-    switch(out){
-        case PWM_0:
-            ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0, dc);
-            ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0);
-            break;
-        case PWM_1:
-            ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_1, dc);
-            ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_1);
-            break;
-        case PWM_2:
-            ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_2, dc);
-            ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_2);
-            break;
-        case PWM_3:
-            ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_3, dc);
-            ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_TIMER_3);
-            break;
-    }
+    PWMWriteDuty(out, ((uint32_t)duty_cycle << timer_res[pwm_timer[out]]) / DC_100);
 }
 
 uint8_t PWMSetFreq(pwm_out_t out, uint32_t freq){
-    switch(out){
-        case PWM_0:
-            ledc_set_freq(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0, freq);
-            break;
-        case PWM_1:
-            ledc_set_freq(LEDC_LOW_SPEED_MODE, LEDC_TIMER_1, freq);
-            break;
-        case PWM_2:
-            ledc_set_freq(LEDC_LOW_SPEED_MODE, LEDC_TIMER_2, freq);
-            break;
-        case PWM_3:
-            ledc_set_freq(LEDC_LOW_SPEED_MODE, LEDC_TIMER_3, freq);
-            break;
+    uint8_t t, new_t, res;
+    if((out >= PWM_QTY) || !pwm_init[out]){
+        return 1;
+    }
+    t = pwm_timer[out];
+    if(timer_freq[t] == freq){
+        return 0;
+    }
+    new_t = NO_TIMER;
+    for(uint8_t i = 0; i < TIMER_QTY; i++){
+        if((timer_users[i] > 0) && (timer_freq[i] == freq)){
+            new_t = i;
+        }
+    }
+    if((timer_users[t] == 1) && (new_t == NO_TIMER)){
+        /* Only user of the timer: change it in place */
+        res = PWMResolution(freq);
+        if(res >= timer_res[t]){
+            /* Actual resolution is still valid for the new frequency: only the divider changes */
+            ledc_set_freq(LEDC_LOW_SPEED_MODE, ledc_timer[t], freq);
+            timer_freq[t] = freq;
+        } else{
+            /* Resolution must be reduced: reconfigure timer and rescale duty cycle */
+            pwm_duty[out] = PWMRescale(pwm_duty[out], timer_res[t], res);
+            PWMTimerConfig(t, freq, res);
+            PWMWriteDuty(out, pwm_duty[out]);
+        }
+        return 0;
+    }
+    /* Shared timer (or another timer already runs at freq): move the output */
+    PWMTimerRelease(t);
+    new_t = PWMTimerGet(freq);
+    if(new_t == NO_TIMER){
+        timer_users[t]++;
+        ledc_timer_resume(LEDC_LOW_SPEED_MODE, ledc_timer[t]);
+        return 1;
+    }
+    ledc_timer_resume(LEDC_LOW_SPEED_MODE, ledc_timer[new_t]);
+    ledc_bind_channel_timer(LEDC_LOW_SPEED_MODE, pwm_channel[out], ledc_timer[new_t]);
+    pwm_timer[out] = new_t;
+    PWMWriteDuty(out, PWMRescale(pwm_duty[out], timer_res[t], timer_res[new_t]));
+    return 0;
+}
+
+uint8_t PWMGetResolution(pwm_out_t out){
+    if(out >= PWM_QTY){
+        return 0;
+    }
+    return timer_res[pwm_timer[out]];
+}
+
+uint32_t PWMGetDutyMax(pwm_out_t out){
+    if(out >= PWM_QTY){
+        return 0;
+    }
+    return 1UL << timer_res[pwm_timer[out]];
+}
+
+void PWMSetDutyTicks(pwm_out_t out, uint32_t ticks){
+    if(out < PWM_QTY){
+        PWMWriteDuty(out, ticks);
+    }
+}
+
+void PWMSetDutyQ16(pwm_out_t out, uint32_t duty_q16){
+    if(out >= PWM_QTY){
+        return;
+    }
+    if(duty_q16 > PWM_Q16_ONE){
+        duty_q16 = PWM_Q16_ONE;
+    }
+    PWMWriteDuty(out, ((uint64_t)duty_q16 << timer_res[pwm_timer[out]]) >> Q16_SHIFT);
+}
+
+uint8_t PWMSetFade(pwm_out_t out, uint32_t duty_q16, uint32_t time_ms){
+    uint32_t target;
+    if((out >= PWM_QTY) || !pwm_init[out]){
+        return 1;
+    }
+    if(!fade_installed){
+        if(ledc_fade_func_install(0) != ESP_OK){
+            return 1;
+        }
+        fade_installed = true;
+    }
+    if(duty_q16 > PWM_Q16_ONE){
+        duty_q16 = PWM_Q16_ONE;
+    }
+    target = ((uint64_t)duty_q16 << timer_res[pwm_timer[out]]) >> Q16_SHIFT;
+    if(ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, pwm_channel[out], target, time_ms) != ESP_OK){
+        return 1;
     }
+    ledc_fade_start(LEDC_LOW_SPEED_MODE, pwm_channel[out], LEDC_FADE_NO_WAIT);
+    pwm_fade[out] = true;
+    pwm_duty[out] = target;
+    pwm_on[out] = true;
     return 0;
 }
 
+void PWMStopFade(pwm_out_t out){
+    if((out < PWM_QTY) && fade_installed){
+        ledc_fade_stop(LEDC_LOW_SPEED_MODE, pwm_channel[out]);
+        pwm_duty[out] = ledc_get_duty(LEDC_LOW_SPEED_MODE, pwm_channel[out]);
+    }
+}
+
+void PWMSyncBegin(void){
+    uint8_t slot = PWMSyncSlot();
+    portENTER_CRITICAL_SAFE(&pwm_spinlock);
+    sync_active[slot]++;
+    portEXIT_CRITICAL_SAFE(&pwm_spinlock);
+}
+
+void PWMSyncEnd(void){
+    uint8_t slot = PWMSyncSlot();
+    /* All the updates in the same critical section, so they are latched in the same period */
+    portENTER_CRITICAL_SAFE(&pwm_spinlock);
+    if((sync_active[slot] > 0) && (--sync_active[slot] == 0)){
+        for(uint8_t out = 0; out < PWM_QTY; out++){
+            if(sync_pending[slot] & (1 << out)){
+                ledc_update_duty(LEDC_LOW_SPEED_MODE, pwm_channel[out]);
+            }
+        }
+        sync_pending[slot] = 0;
+    }
+    portEXIT_CRITICAL_SAFE(&pwm_spinlock);
+}
+
 uint8_t PWMDeinit(pwm_out_t out){
-    switch(out){
-        case PWM_0:
-            ledc_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, 0);
-            break;
-        case PWM_1:
-            ledc_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, 0);
-            break;
-        case PWM_2:
-            ledc_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_2, 0);
-            break;
-        case PWM_3:
-            ledc_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_3, 0);
-            break;
+    if(out >= PWM_QTY){
+        return 1;
+    }
+    ledc_stop(LEDC_LOW_SPEED_MODE, pwm_channel[out], 0);
+    if(pwm_init[out]){
+        PWMTimerRelease(pwm_timer[out]);
     }
+    pwm_init[out] = false;
+    pwm_on[out] = false;
+    pwm_duty[out] = 0;
     return 0;
 }
 
-/*==================[end of file]============================================*/
\ No newline at end of file
+/*==================[end of file]============================================*/
@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
 #include "gpio_mcu.h"
 /*==================[macros and definitions]=================================*/
 #define PIN_NUM_MISO	GPIO_22	/*!<  */
@@ -22,207 +23,316 @@
 #define PIN_NUM_CS1		GPIO_19	/*!<  */
 #define PIN_NUM_CS2		GPIO_18	/*!<  */
 #define PIN_NUM_CS3		GPIO_9	/*!<  */
+#define SPI_DEVICES		3		/*!< Devices in the bus (CS lines) */
+#define SPI_QUEUE_SIZE	8		/*!< Transactions that can be queued in each device */
 /*==================[internal data declaration]==============================*/
-spi_device_handle_t spi_1, spi_2, spi_3;
 const spi_bus_config_t bus_cfg = {
     .miso_io_num = PIN_NUM_MISO,
     .mosi_io_num = PIN_NUM_MOSI,
     .sclk_io_num = PIN_NUM_CLK,
     .quadwp_io_num = -1,
     .quadhd_io_num = -1,
-    .max_transfer_sz = 4092
+    .max_transfer_sz = SPI_MAX_TRANSFER_SIZE
 };
-transfer_mode_t transfer_mode_1, transfer_mode_2, transfer_mode_3;
-void (*spi_1_isr_p)(void*);	/*!<  */
-void (*spi_2_isr_p)(void*);	/*!<  */
-void (*spi_3_isr_p)(void*);	/*!<  */
-void *spi_1_user_data;	    /*!<  */
-void *spi_2_user_data;	    /*!<  */
-void *spi_3_user_data;	    /*!<  */
+static const gpio_t spi_cs[SPI_DEVICES] = {PIN_NUM_CS1, PIN_NUM_CS2, PIN_NUM_CS3};
+static bool spi_bus_initialized = false;
+static spi_device_handle_t spi_handle[SPI_DEVICES];			/*!< Devices added to the bus (NULL: not initialized) */
+static spi_device_interface_config_t spi_dev_cfg[SPI_DEVICES];	/*!< Configuration the devices were added with */
+static transfer_mode_t spi_transfer_mode[SPI_DEVICES];
+static void (*spi_isr_p[SPI_DEVICES])(void*);				/*!< Functions called at transaction end (SPI_INTERRUPT) */
+static void *spi_user_data[SPI_DEVICES];
+static void (*spi_pre_p[SPI_DEVICES])(void*);				/*!< Functions called before each transaction */
+static void (*spi_post_p[SPI_DEVICES])(void*);				/*!< Functions called after each transaction */
+static spi_transaction_t spi_queue[SPI_DEVICES][SPI_QUEUE_SIZE];	/*!< Transactions in flight (ring) */
+static uint8_t spi_queue_head[SPI_DEVICES];					/*!< Next free transaction */
+static uint8_t spi_queue_pending[SPI_DEVICES];				/*!< Transactions not yet completed */
+static uint8_t spi_bus_acquired[SPI_DEVICES];				/*!< Nested SpiBusAcquire() calls */
 /*==================[internal functions declaration]=========================*/
-static void IRAM_ATTR spi_1_isr(spi_transaction_t *t){
-	spi_1_isr_p(spi_1_user_data);
+static void IRAM_ATTR SpiPost(spi_dev_t device, spi_transaction_t *t){
+    if((spi_transfer_mode[device] == SPI_INTERRUPT) && (spi_isr_p[device] != NULL)){
+        spi_isr_p[device](spi_user_data[device]);
+    }
+    if(spi_post_p[device] != NULL){
+        spi_post_p[device](t->user);
+    }
+}
+static void IRAM_ATTR spi_1_post(spi_transaction_t *t){
+	SpiPost(SPI_1, t);
+}
+static void IRAM_ATTR spi_2_post(spi_transaction_t *t){
+	SpiPost(SPI_2, t);
+}
+static void IRAM_ATTR spi_3_post(spi_transaction_t *t){
+	SpiPost(SPI_3, t);
 }
-static void IRAM_ATTR spi_2_isr(spi_transaction_t *t){
-	spi_2_isr_p(spi_2_user_data);
+static void IRAM_ATTR spi_1_pre(spi_transaction_t *t){
+	spi_pre_p[SPI_1](t->user);
 }
-static void IRAM_ATTR spi_3_isr(spi_transaction_t *t){
-	spi_3_isr_p(spi_3_user_data);
+static void IRAM_ATTR spi_2_pre(spi_transaction_t *t){
+	spi_pre_p[SPI_2](t->user);
 }
+static void IRAM_ATTR spi_3_pre(spi_transaction_t *t){
+	spi_pre_p[SPI_3](t->user);
+}
+static const transaction_cb_t spi_pre_cb[SPI_DEVICES] = {spi_1_pre, spi_2_pre, spi_3_pre};
+static const transaction_cb_t spi_post_cb[SPI_DEVICES] = {spi_1_post, spi_2_post, spi_3_post};
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/**
+ * @brief Blocking transaction, polling or interrupt as configured in SpiInit()
+ */
+static void SpiTransmit(spi_dev_t device, const uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size){
+    spi_transaction_t t;
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return;
+    }
+    /* Results of queued transactions must be collected before (they end in order) */
+    SpiQueueWait(device, 0);
+    memset(&t, 0, sizeof(t));       // Zero out the transaction
+    t.length = buffer_size * 8;     // buffer_size is in bytes, transaction length is in bits.
+    t.rxlength = (rx_buffer != NULL) ? buffer_size * 8 : 0;
+    t.tx_buffer = tx_buffer;
+    t.rx_buffer = rx_buffer;
+    if(spi_transfer_mode[device] == SPI_INTERRUPT){
+        spi_device_transmit(spi_handle[device], &t);
+    } else {
+        spi_device_polling_transmit(spi_handle[device], &t);
+    }
+}
 
+/**
+ * @brief Queue a transaction (waits the oldest one if the queue is full)
+ */
+static bool SpiQueue(spi_dev_t device, const uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size, void *user){
+    spi_transaction_t *t, *done;
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL) || (buffer_size > SPI_MAX_TRANSFER_SIZE)){
+        return false;
+    }
+    /* Queue full: reuse the oldest transaction */
+    if(spi_queue_pending[device] == SPI_QUEUE_SIZE){
+        spi_device_get_trans_result(spi_handle[device], &done, portMAX_DELAY);
+        spi_queue_pending[device]--;
+    }
+    t = &spi_queue[device][spi_queue_head[device]];
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length = buffer_size * 8;
+    t->rxlength = (rx_buffer != NULL) ? buffer_size * 8 : 0;
+    t->tx_buffer = tx_buffer;
+    t->rx_buffer = rx_buffer;
+    t->user = user;
+    if(spi_device_queue_trans(spi_handle[device], t, portMAX_DELAY) != ESP_OK){
+        return false;
+    }
+    spi_queue_head[device] = (spi_queue_head[device] + 1) % SPI_QUEUE_SIZE;
+    spi_queue_pending[device]++;
+    return true;
+}
 /*==================[external functions definition]==========================*/
 uint8_t SpiInit(spi_mcu_config_t* spi){
-    static bool spi_initialized = false;
-    if(!spi_initialized){
-	    spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO);
-        spi_initialized = true;
+    spi_dev_t device = spi->device;
+    if(device >= SPI_DEVICES){
+        return 1;
+    }
+    if(!spi_bus_initialized){
+	    if(spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO) != ESP_OK){
+            return 1;
+        }
+        spi_bus_initialized = true;
+    }
+    /* Initialized again: the device is added with the new configuration */
+    if(spi_handle[device] != NULL){
+        SpiQueueWait(device, 0);
+        /* A device can't be removed while it holds the bus */
+        if(spi_bus_acquired[device] > 0){
+            spi_bus_acquired[device] = 0;
+            spi_device_release_bus(spi_handle[device]);
+        }
+        spi_bus_remove_device(spi_handle[device]);
+        spi_handle[device] = NULL;
     }
 	spi_device_interface_config_t dev_cfg = {
         .clock_speed_hz = spi->bitrate,     	
         .mode = spi->clk_mode,                  
-        .queue_size = 8,                        
+        .spics_io_num = spi_cs[device],
+        .queue_size = SPI_QUEUE_SIZE,           
     };
-    switch(spi->device){
-        case SPI_1:
-            dev_cfg.spics_io_num = PIN_NUM_CS1;
-            transfer_mode_1 = spi->transfer_mode;
-            if(transfer_mode_1 == SPI_INTERRUPT){
-                dev_cfg.post_cb = spi_1_isr;
-            } 
-            spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_1);
-            spi_1_isr_p = spi->func_p;
-            spi_1_user_data = spi->param_p;
-            break;
-        case SPI_2:
-            dev_cfg.spics_io_num = PIN_NUM_CS2;
-            if(transfer_mode_2 == SPI_INTERRUPT){
-                dev_cfg.post_cb = spi_2_isr;
-            } 
-            transfer_mode_1 = spi->transfer_mode;
-            spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_2);
-            spi_2_isr_p = spi->func_p;
-            spi_2_user_data = spi->param_p;
-            break;
-        case SPI_3:
-            dev_cfg.spics_io_num = PIN_NUM_CS3;
-            if(transfer_mode_3 == SPI_INTERRUPT){
-                dev_cfg.post_cb = spi_3_isr;
-            } 
-            transfer_mode_1 = spi->transfer_mode;
-            spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_3);
-            spi_3_isr_p = spi->func_p;
-            spi_3_user_data = spi->param_p;
-            break;
+    spi_transfer_mode[device] = spi->transfer_mode;
+    spi_isr_p[device] = spi->func_p;
+    spi_user_data[device] = spi->param_p;
+    spi_pre_p[device] = spi->pre_func_p;
+    spi_post_p[device] = spi->post_func_p;
+    if(spi->pre_func_p != NULL){
+        dev_cfg.pre_cb = spi_pre_cb[device];
+    }
+    if(((spi->transfer_mode == SPI_INTERRUPT) && (spi->func_p != NULL)) || (spi->post_func_p != NULL)){
+        dev_cfg.post_cb = spi_post_cb[device];
+    }
+    spi_queue_head[device] = 0;
+    spi_queue_pending[device] = 0;
+    spi_bus_acquired[device] = 0;
+    spi_dev_cfg[device] = dev_cfg;
+    if(spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_handle[device]) != ESP_OK){
+        spi_handle[device] = NULL;
+        return 1;
     }
     return 0;
 }
 
-void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size){
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));       // Zero out the transaction
-    t.length = rx_buffer_size * 8;  // tx_buffer_size is in bytes, transaction length is in bits.
-    t.rxlength = rx_buffer_size * 8;
-    t.rx_buffer = rx_buffer;        // Data
-    switch(device){
-        case SPI_1:
-            switch(transfer_mode_1){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_1, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_1, &t); 
-                    break;
-            }
-            break;
-        case SPI_2:
-            switch(transfer_mode_2){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_2, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_2, &t); 
-                    break;
-            }
-            break;
-        case SPI_3:
-            switch(transfer_mode_3){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_3, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_3, &t); 
-                    break;
-            }
-            break;
+uint8_t SpiSetBitrate(spi_dev_t device, uint32_t bitrate){
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return 1;
     }
+    if(spi_dev_cfg[device].clock_speed_hz == bitrate){
+        return 0;
+    }
+    SpiQueueWait(device, 0);
+    /* The clock is set when the device is added to the bus: it is added again, keeping the bus lock */
+    if(spi_bus_acquired[device] > 0){
+        spi_device_release_bus(spi_handle[device]);
+    }
+    spi_bus_remove_device(spi_handle[device]);
+    spi_dev_cfg[device].clock_speed_hz = bitrate;
+    if(spi_bus_add_device(SPI2_HOST, &spi_dev_cfg[device], &spi_handle[device]) != ESP_OK){
+        spi_handle[device] = NULL;
+        spi_bus_acquired[device] = 0;
+        return 1;
+    }
+    if(spi_bus_acquired[device] > 0){
+        spi_device_acquire_bus(spi_handle[device], portMAX_DELAY);
+    }
+    return 0;
+}
+
+void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size){
+    SpiTransmit(device, NULL, rx_buffer, rx_buffer_size);
 }
 
 void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size){
+    SpiTransmit(device, tx_buffer, NULL, tx_buffer_size);
+}
+
+void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size){
+    SpiTransmit(device, tx_buffer, rx_buffer, buffer_size);
+}
+
+bool SpiQueueWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void *user){
+    return SpiQueue(device, tx_buffer, NULL, tx_buffer_size, user);
+}
+
+bool SpiQueueTransfer(spi_dev_t device, const uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size, void *user){
+    return SpiQueue(device, tx_buffer, rx_buffer, buffer_size, user);
+}
+
+void SpiQueueWait(spi_dev_t device, uint8_t max_pending){
+    spi_transaction_t *done;
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return;
+    }
+    /* Transactions end in the same order they were queued */
+    while(spi_queue_pending[device] > max_pending){
+        spi_device_get_trans_result(spi_handle[device], &done, portMAX_DELAY);
+        spi_queue_pending[device]--;
+    }
+}
+
+uint8_t SpiQueuePending(spi_dev_t device){
+    spi_transaction_t *done;
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return 0;
+    }
+    /* Collects the ended transactions without waiting */
+    while((spi_queue_pending[device] > 0) && (spi_device_get_trans_result(spi_handle[device], &done, 0) == ESP_OK)){
+        spi_queue_pending[device]--;
+    }
+    return spi_queue_pending[device];
+}
+
+void SpiBusAcquire(spi_dev_t device){
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return;
+    }
+    if(spi_bus_acquired[device]++ == 0){
+        spi_device_acquire_bus(spi_handle[device], portMAX_DELAY);
+    }
+}
+
+void SpiBusRelease(spi_dev_t device){
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return;
+    }
+    if((spi_bus_acquired[device] > 0) && (--spi_bus_acquired[device] == 0)){
+        spi_device_release_bus(spi_handle[device]);
+    }
+}
+
+void SpiPollingWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void *user){
     spi_transaction_t t;
-    memset(&t, 0, sizeof(t));       // Zero out the transaction
-    t.length = tx_buffer_size * 8;  // tx_buffer_size is in bytes, transaction length is in bits.
-    t.tx_buffer = tx_buffer;        // Data
-    switch(device){
-        case SPI_1:
-            switch(transfer_mode_1){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_1, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_1, &t); 
-                    break;
-            }
-            break;
-        case SPI_2:
-            switch(transfer_mode_2){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_2, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_2, &t); 
-                    break;
-            }
-            break;
-        case SPI_3:
-            switch(transfer_mode_3){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_3, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_3, &t); 
-                    break;
-            }
-            break;
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return;
     }
+    /* Polling transactions can't start while there are queued transactions */
+    SpiQueueWait(device, 0);
+    memset(&t, 0, sizeof(t));
+    t.length = tx_buffer_size * 8;
+    t.tx_buffer = tx_buffer;
+    t.user = user;
+    spi_device_polling_transmit(spi_handle[device], &t);
 }
 
-void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size){
+void SpiPollingRead(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void *tx_user,
+                    uint8_t * rx_buffer, uint32_t rx_buffer_size, void *rx_user){
     spi_transaction_t t;
-    memset(&t, 0, sizeof(t));       // Zero out the transaction
-    t.length = buffer_size * 8;     // tx_buffer_size is in bytes, transaction length is in bits.
-    t.rxlength = buffer_size * 8;
-    t.tx_buffer = tx_buffer;        // Data
-    t.rx_buffer = rx_buffer;        
-    switch(device){
-        case SPI_1:
-            switch(transfer_mode_1){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_1, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_1, &t); 
-                    break;
-            }
-            break;
-        case SPI_2:
-            switch(transfer_mode_2){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_2, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_2, &t); 
-                    break;
-            }
-            break;
-        case SPI_3:
-            switch(transfer_mode_3){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_3, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_3, &t); 
-                    break;
-            }
-            break;
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return;
     }
+    SpiQueueWait(device, 0);
+    /* CS can only be kept active between transactions with the bus acquired */
+    SpiBusAcquire(device);
+    memset(&t, 0, sizeof(t));
+    t.length = tx_buffer_size * 8;
+    t.tx_buffer = tx_buffer;
+    t.user = tx_user;
+    t.flags = SPI_TRANS_CS_KEEP_ACTIVE;
+    spi_device_polling_transmit(spi_handle[device], &t);
+    memset(&t, 0, sizeof(t));
+    t.length = rx_buffer_size * 8;
+    t.rxlength = rx_buffer_size * 8;
+    t.rx_buffer = rx_buffer;
+    t.user = rx_user;
+    spi_device_polling_transmit(spi_handle[device], &t);
+    SpiBusRelease(device);
+}
+
+void *SpiDmaMalloc(uint32_t size){
+    return heap_caps_malloc(size, MALLOC_CAP_DMA);
+}
+
+void SpiDmaFree(void *buffer){
+    heap_caps_free(buffer);
 }
 
 uint8_t SpiDeInit(spi_dev_t device){
+    if((device >= SPI_DEVICES) || (spi_handle[device] == NULL)){
+        return 1;
+    }
+    SpiQueueWait(device, 0);
+    if(spi_bus_acquired[device] > 0){
+        spi_bus_acquired[device] = 0;
+        spi_device_release_bus(spi_handle[device]);
+    }
+    spi_bus_remove_device(spi_handle[device]);
+    spi_handle[device] = NULL;
+    /* The bus is freed with its last device */
+    for(uint8_t i = 0; i < SPI_DEVICES; i++){
+        if(spi_handle[i] != NULL){
+            return 0;
+        }
+    }
+    spi_bus_free(SPI2_HOST);
+    spi_bus_initialized = false;
     return 0;
 }
 
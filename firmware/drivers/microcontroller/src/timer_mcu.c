@@ -188,4 +188,27 @@ void TimerUpdatePeriod(timer_mcu_t timer, uint32_t period){
 	}
 }
 
+void TimerDeInit(timer_mcu_t timer){
+	gptimer_handle_t *handle = NULL;
+	switch(timer){
+	 	case TIMER_A:
+			handle = &timer_a;
+	 	break;
+	 	case TIMER_B:
+			handle = &timer_b;
+	 	break;
+	 	case TIMER_C:
+			handle = &timer_c;
+	 	break;
+	}
+	if((handle == NULL) || (*handle == NULL)){
+		return;
+	}
+	/* Stop fails (harmlessly) if the timer isn't running */
+	gptimer_stop(*handle);
+	gptimer_disable(*handle);
+	gptimer_del_timer(*handle);
+	*handle = NULL;
+}
+
 /*==================[end of file]============================================*/
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+"""
+Packs images, fonts and icons into an assets partition for the ILI9341 driver.
+
+The output is a binary file flashed in a data partition (subtype 0x40), whose assets
+are found by name and drawn from the flash with the ILI9341Assets*() functions (see
+ili9341_assets.h), so they don't need to be compiled into the application:
+
+    --image NAME=FILE[:FORMAT]             PNG or BMP image (see img2ili9341.py)
+    --picture NAME=FILE.c:ARRAY:WxH        RGB565 array of a C source (e.g. esp_edu_pic.c)
+    --font NAME=FILE.c:VARIABLE            Font_t of a C source (e.g. fonts.c:font_30)
+    --icons NAME=FILE.c:VARIABLE           icon_font_t of a C source (e.g. icons.c:icon_30)
+    --aa-font NAME=FILE.ttf:HEIGHT[:BPP]   anti-aliased font, printable ASCII (see font2ili9341.py)
+
+Images and pictures are stored with the smallest compression format (unless one is
+selected). Anti-aliased fonts require Pillow (pip install pillow).
+
+Usage:
+    python3 assets2ili9341.py assets.bin --font font_30=fonts.c:font_30 --image logo=logo.png
+                              [--partition-size 1M]
+    python3 assets2ili9341.py --list assets.bin
+
+Flashing:
+    parttool.py write_partition --partition-name assets --input assets.bin
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import img2ili9341  # noqa: E402
+
+MAGIC = b"ILAS"
+VERSION = 1
+HEADER = struct.Struct("<4sHHI")
+ENTRY = struct.Struct("<20sB3xII")
+NAME_LEN = 20
+ALIGN = 4
+TYPES = {1: "image", 2: "font", 3: "aa_font", 4: "icons"}
+TYPE_ID = {v: k for k, v in TYPES.items()}
+FONT_CHARS = 95
+NO_CHAR = 0xFF
+
+
+def align(data):
+    return data + bytes(-len(data) % ALIGN)
+
+
+def split_spec(spec, fields):
+    """NAME=A:B[:C] -> name, [A, B, C] (at least fields values)."""
+    if "=" not in spec:
+        raise SystemExit("Asset without name: %s" % spec)
+    name, value = spec.split("=", 1)
+    # Windows paths (C:\\...) keep their drive letter
+    drive = ""
+    if re.match(r"^[A-Za-z]:[\\/]", value):
+        drive, value = value[:2], value[2:]
+    values = value.split(":")
+    values[0] = drive + values[0]
+    if len(values) < fields:
+        raise SystemExit("Missing fields in %s" % spec)
+    return name, values
+
+
+def c_source(path):
+    """C source without comments."""
+    with open(path, encoding="utf-8", errors="ignore") as f:
+        text = f.read()
+    return re.sub(r"/\*.*?\*/|//[^\n]*", "", text, flags=re.S)
+
+
+def c_initializer(text, variable):
+    """Values between the braces of "variable = {...}" (nested braces are flattened)."""
+    match = re.search(r"\b%s\s*(\[\s*\d*\s*\])?\s*=\s*\{" % re.escape(variable), text)
+    if match is None:
+        raise SystemExit("%s not found" % variable)
+    depth, start = 1, match.end()
+    for i in range(start, len(text)):
+        depth += {"{": 1, "}": -1}.get(text[i], 0)
+        if depth == 0:
+            return [v.strip() for v in re.split(r"[,{}]", text[start:i]) if v.strip()]
+    raise SystemExit("%s isn't terminated" % variable)
+
+
+def c_numbers(text, variable):
+    return [int(v, 0) for v in c_initializer(text, variable)]
+
+
+def image_asset(width, height, pixels, fmt):
+    results = {}
+    for f in [fmt] if fmt else img2ili9341.FORMATS:
+        result = img2ili9341.encode(pixels, f)
+        if result is not None:
+            data, palette, bpp = result
+            if palette is not None:
+                # The driver requires a color for every index value (it doesn't check the indexes)
+                palette = palette + [0] * ((1 << bpp) - len(palette))
+            results[f] = (data, palette, bpp)
+    if not results:
+        raise SystemExit("Image has more than 256 colors, %s format can't be used" % fmt)
+    fmt = min(results, key=lambda k: img2ili9341.encoded_size(results[k]))
+    data, palette, bpp = results[fmt]
+    palette = palette or []
+    header = struct.pack("<HHBBHI", width, height, img2ili9341.FORMATS.index(fmt), bpp, len(palette), len(data))
+    return header + struct.pack("<%dH" % len(palette), *palette) + data, "%dx%d %s" % (width, height, fmt)
+
+
+def pack_image(spec):
+    name, (path, *fmt) = split_spec(spec, 1)
+    if fmt and fmt[0] not in img2ili9341.FORMATS:
+        raise SystemExit("Unknown format %s" % fmt[0])
+    with open(path, "rb") as f:
+        raw = f.read()
+    if raw[:2] == b"BM":
+        width, height, rows = img2ili9341.read_bmp(raw)
+    elif raw[:8] == b"\x89PNG\r\n\x1a\n":
+        width, height, rows = img2ili9341.read_png(raw)
+    else:
+        raise SystemExit("Unknown image file %s (only PNG and BMP are supported)" % path)
+    pixels = img2ili9341.to_rgb565(rows, 0xFFFFFF)
+    return name, "image", image_asset(width, height, pixels, fmt[0] if fmt else None)
+
+
+def pack_picture(spec):
+    name, (path, array, size) = split_spec(spec, 3)
+    width, height = (int(v) for v in size.lower().split("x"))
+    data = c_numbers(c_source(path), array)
+    if len(data) != width * height * 2:
+        raise SystemExit("%s has %d bytes, %dx%d pixels expected" % (array, len(data), width, height))
+    pixels = [(data[i] << 8) | data[i + 1] for i in range(0, len(data), 2)]
+    return name, "image", image_asset(width, height, pixels, None)
+
+
+def pack_font(spec):
+    name, (path, variable) = split_spec(spec, 2)
+    text = c_source(path)
+    height, info, data = c_initializer(text, variable)
+    info = c_numbers(text, info)
+    data = bytes(c_numbers(text, data))
+    if len(info) != FONT_CHARS * 2:
+        raise SystemExit("%s: %d characters expected" % (variable, FONT_CHARS))
+    # char_info_t: width (8 bits), padding, offset (16 bits)
+    asset = struct.pack("<BxHI", int(height, 0), FONT_CHARS, len(data))
+    asset += b"".join(struct.pack("<BxH", info[i], info[i + 1]) for i in range(0, len(info), 2))
+    return name, "font", (asset + data, "%s pixels" % height)
+
+
+def pack_icons(spec):
+    name, (path, variable) = split_spec(spec, 2)
+    text = c_source(path)
+    height, width, offset, data = c_initializer(text, variable)
+    height, width, offset = int(height, 0), int(width, 0), int(offset, 0)
+    data = bytes(c_numbers(text, data))
+    icons = len(data) // offset
+    asset = struct.pack("<BBHHxxI", height, width, offset, icons, len(data)) + data
+    return name, "icons", (asset, "%dx%d, %d icons" % (width, height, icons))
+
+
+def pack_aa_font(spec):
+    name, (path, height, *bpp) = split_spec(spec, 2)
+    import font2ili9341
+    height, bpp = int(height), int(bpp[0]) if bpp else 4
+    if bpp not in (2, 4):
+        raise SystemExit("Anti-aliased fonts have 2 or 4 bpp")
+    chars = font2ili9341.select_chars(None, None)
+    glyphs, fmt, data, _ = font2ili9341.convert(path, height, bpp, chars)
+    first, last = ord(chars[0]), ord(chars[-1])
+    index = {c: i for i, c in enumerate(chars)}
+    char_map = bytes(index.get(chr(i), NO_CHAR) for i in range(first, last + 1))
+    asset = struct.pack("<BBBBBxHI", height, bpp, fmt == "rle", first, last, len(chars), len(data))
+    asset = align(asset + char_map)
+    # aa_char_info_t: width (8 bits), padding, offset (32 bits)
+    asset += b"".join(struct.pack("<B3xI", width, offset) for width, offset in glyphs)
+    return name, "aa_font", (asset + data, "%d pixels, %d bpp %s" % (height, bpp, fmt))
+
+
+def build(assets):
+    """Partition content: header, index sorted by name, assets."""
+    names = [name.encode() for name, _, _ in assets]
+    for name in names:
+        if len(name) >= NAME_LEN:
+            raise SystemExit("Name too long (max %d characters): %s" % (NAME_LEN - 1, name.decode()))
+    if len(set(names)) != len(names):
+        raise SystemExit("Repeated asset names")
+    assets = sorted(zip(names, assets), key=lambda a: a[0])
+    offset = HEADER.size + ENTRY.size * len(assets)
+    index, blobs = b"", b""
+    for name, (_, kind, (data, _)) in assets:
+        index += ENTRY.pack(name, TYPE_ID[kind], offset + len(blobs), len(data))
+        blobs += align(data)
+    used = offset + len(blobs)
+    return HEADER.pack(MAGIC, VERSION, len(assets), used) + index + blobs
+
+
+def read_index(content):
+    """[(name, type, offset, size)] of a partition content (host reader of ili9341_assets.c)."""
+    magic, version, count, used = HEADER.unpack_from(content, 0)
+    if magic != MAGIC or version != VERSION or used > len(content):
+        raise SystemExit("Not an assets partition")
+    entries = []
+    for i in range(count):
+        name, kind, offset, size = ENTRY.unpack_from(content, HEADER.size + i * ENTRY.size)
+        entries.append((name.rstrip(b"\0").decode(), TYPES.get(kind, "unknown"), offset, size))
+    return entries
+
+
+def parse_size(value):
+    units = {"K": 1024, "M": 1024 * 1024}
+    value = value.upper()
+    return int(value[:-1], 0) * units[value[-1]] if value[-1] in units else int(value, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("output", help="partition file")
+    parser.add_argument("--image", action="append", default=[], help="NAME=FILE[:FORMAT]")
+    parser.add_argument("--picture", action="append", default=[], help="NAME=FILE.c:ARRAY:WxH")
+    parser.add_argument("--font", action="append", default=[], help="NAME=FILE.c:VARIABLE")
+    parser.add_argument("--icons", action="append", default=[], help="NAME=FILE.c:VARIABLE")
+    parser.add_argument("--aa-font", action="append", default=[], help="NAME=FILE.ttf:HEIGHT[:BPP]")
+    parser.add_argument("--partition-size", type=parse_size, help="fail if the assets don't fit (e.g. 1M)")
+    parser.add_argument("--list", action="store_true", help="print the assets of an existing partition file")
+    args = parser.parse_args()
+
+    if args.list:
+        with open(args.output, "rb") as f:
+            for name, kind, offset, size in read_index(f.read()):
+                print("%-20s %-8s offset 0x%06X %8d bytes" % (name, kind, offset, size))
+        return
+
+    assets = [pack_image(s) for s in args.image] + [pack_picture(s) for s in args.picture] + \
+             [pack_font(s) for s in args.font] + [pack_icons(s) for s in args.icons] + \
+             [pack_aa_font(s) for s in args.aa_font]
+    if not assets:
+        raise SystemExit("No assets")
+    content = build(assets)
+    if args.partition_size is not None and len(content) > args.partition_size:
+        raise SystemExit("Assets need %d bytes, partition has %d" % (len(content), args.partition_size))
+    with open(args.output, "wb") as f:
+        f.write(content)
+    for name, kind, (data, description) in assets:
+        print("%-20s %-8s %8d bytes  %s" % (name, kind, len(data), description))
+    print("%s: %d assets, %d bytes" % (args.output, len(assets), len(content)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+Converts a TrueType (or OpenType) font into an anti-aliased font for the ILI9341 driver.
+
+The output is a C source file with an aa_font_t variable (see fonts.h), drawn with
+ILI9341DrawAAString(). Only the selected characters are included, each one with
+2 or 4 bits per pixel of coverage (blended with the background color when drawn),
+compressed with the smallest format (unless one is selected):
+    packed  levels packed in bytes
+    rle     runs of pixels with the same level (1 or 2 bytes each)
+
+Characters are selected with --chars and/or --chars-from (every printable ASCII
+character found in the files, e.g. the sources of the project). Without them, all
+the printable ASCII characters are included.
+
+Requires Pillow (pip install pillow).
+
+Usage:
+    python3 font2ili9341.py font.ttf output.c --name font_name --height 48
+                            [--bpp 4] [--chars "0123456789.-"] [--chars-from main.c]
+                            [--format rle]
+
+In the project: extern const aa_font_t font_name;
+"""
+import argparse
+
+try:
+    from PIL import Image, ImageDraw, ImageFont
+except ImportError:
+    raise SystemExit("Pillow is required: pip install pillow")
+
+FORMATS = ["packed", "rle"]
+FIRST_CHAR = 32
+LAST_CHAR = 126
+NO_CHAR = 0xFF
+
+
+def load_font(path, height):
+    """Biggest size of the font whose ascent + descent fits in height pixels."""
+    size = height
+    while size > 1:
+        font = ImageFont.truetype(path, size)
+        ascent, descent = font.getmetrics()
+        if ascent + descent <= height:
+            return font, (height - ascent - descent) // 2
+        size -= 1
+    raise SystemExit("Font height too small")
+
+
+def render(font, top, height, c, bpp):
+    """Returns (width, levels row by row) of a character."""
+    advance = round(font.getlength(c))
+    left, _, right, _ = font.getbbox(c)
+    left = min(0, left)
+    width = max(1, max(advance, right) - left)
+    image = Image.new("L", (width, height), 0)
+    ImageDraw.Draw(image).text((-left, top), c, font=font, fill=255)
+    top_level = (1 << bpp) - 1
+    return width, [(p * top_level + 127) // 255 for p in image.tobytes()]
+
+
+def encode(levels, bpp, fmt):
+    out = bytearray()
+    if fmt == "packed":
+        acc, used = 0, 0
+        for v in levels:
+            acc = (acc << bpp) | v
+            used += bpp
+            if used == 8:
+                out.append(acc)
+                acc, used = 0, 0
+        if used:
+            out.append(acc << (8 - used))
+        return bytes(out)
+    mask = (1 << (8 - bpp)) - 1
+    i = 0
+    while i < len(levels):
+        run = 1
+        while i + run < len(levels) and run < mask + 1 + 255 and levels[i + run] == levels[i]:
+            run += 1
+        if run <= mask:
+            out.append((levels[i] << (8 - bpp)) | (run - 1))
+        else:
+            out.extend(((levels[i] << (8 - bpp)) | mask, run - mask - 1))
+        i += run
+    return bytes(out)
+
+
+def select_chars(chars, files):
+    selected = set(chars or "")
+    for path in files or []:
+        with open(path, encoding="utf-8", errors="ignore") as f:
+            selected.update(f.read())
+    if chars is None and not files:
+        selected = set(map(chr, range(FIRST_CHAR, LAST_CHAR + 1)))
+    return sorted(c for c in selected if FIRST_CHAR <= ord(c) <= LAST_CHAR)
+
+
+def convert(path, height, bpp, chars, fmt=None):
+    """Returns (glyphs as (width, offset), format, data, 1 bpp bitmaps size) of the characters."""
+    font, top = load_font(path, height)
+    rendered = [render(font, top, height, c, bpp) for c in chars]
+    results = {}
+    for f in [fmt] if fmt else FORMATS:
+        data = bytearray()
+        glyphs = []
+        for width, levels in rendered:
+            glyphs.append((width, len(data)))
+            data.extend(encode(levels, bpp, f))
+        results[f] = (glyphs, bytes(data))
+    fmt = min(results, key=lambda k: len(results[k][1]))
+    glyphs, data = results[fmt]
+    bitmap = sum((width + 7) // 8 * height for width, _ in rendered)
+    return glyphs, fmt, data, bitmap
+
+
+def c_char(c):
+    return "'\\''" if c == "'" else "'\\\\'" if c == "\\" else "'%s'" % c
+
+
+def write_c(path, name, args, chars, glyphs, fmt, data):
+    first, last = ord(chars[0]), ord(chars[-1])
+    index = {c: i for i, c in enumerate(chars)}
+    with open(path, "w") as f:
+        f.write("/* Generated by font2ili9341.py, do not edit */\n")
+        f.write("/* %s, %d pixels, %d bpp */\n" % (args.input.split("/")[-1], args.height, args.bpp))
+        f.write('#include "fonts.h"\n\n')
+        f.write("static const uint8_t %s_data[%d] = {\n" % (name, len(data)))
+        for i in range(0, len(data), 16):
+            f.write("\t" + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",\n")
+        f.write("};\n\n")
+        f.write("static const aa_char_info_t %s_info[%d] = {\n" % (name, len(chars)))
+        for c, (width, offset) in zip(chars, glyphs):
+            f.write("\t{%d, %d},\t/* %s */\n" % (width, offset, c_char(c)))
+        f.write("};\n\n")
+        f.write("static const uint8_t %s_map[%d] = {\n" % (name, last - first + 1))
+        values = [index.get(chr(i), NO_CHAR) for i in range(first, last + 1)]
+        for i in range(0, len(values), 16):
+            f.write("\t" + ", ".join("0x%02X" % v for v in values[i:i + 16]) + ",\n")
+        f.write("};\n\n")
+        f.write("const aa_font_t %s = {\n" % name)
+        f.write("\t.font_height = %d,\n" % args.height)
+        f.write("\t.bpp = %d,\n" % args.bpp)
+        f.write("\t.rle = %s,\n" % ("true" if fmt == "rle" else "false"))
+        f.write("\t.first = %s,\n" % c_char(chars[0]))
+        f.write("\t.last = %s,\n" % c_char(chars[-1]))
+        f.write("\t.map = %s_map,\n" % name)
+        f.write("\t.info = %s_info,\n" % name)
+        f.write("\t.data = %s_data\n" % name)
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="TrueType or OpenType font file")
+    parser.add_argument("output", help="C source file")
+    parser.add_argument("--name", required=True, help="aa_font_t variable name")
+    parser.add_argument("--height", type=int, required=True, help="font height in pixels")
+    parser.add_argument("--bpp", type=int, choices=[2, 4], default=4, help="bits per pixel (default 4)")
+    parser.add_argument("--chars", help="characters to include")
+    parser.add_argument("--chars-from", nargs="+", metavar="FILE", help="include the characters used in these files")
+    parser.add_argument("--format", choices=FORMATS, help="compression format (default: the smallest)")
+    args = parser.parse_args()
+
+    chars = select_chars(args.chars, args.chars_from)
+    if not chars:
+        raise SystemExit("No printable ASCII characters selected")
+    glyphs, fmt, data, bitmap = convert(args.input, args.height, args.bpp, chars, args.format)
+    write_c(args.output, args.name, args, chars, glyphs, fmt, data)
+    print("%s: %d characters, %s, %d bytes of data (1 bpp bitmaps: %d bytes)"
+          % (args.name, len(chars), fmt, len(data), bitmap))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,204 @@
+/* Generated by font2ili9341.py, do not edit */
+/* Lato-Regular.ttf, 59 pixels, 4 bpp */
+#include "fonts.h"
+
+static const uint8_t font_aa_59_data[2663] = {
+	0x0F, 0xFF, 0x0F, 0xFF, 0x03, 0x90, 0xFA, 0x40, 0x03, 0x90, 0xFA, 0x40, 0x03, 0x90, 0xFA, 0x40,
+	0x0F, 0xFF, 0x0F, 0x7B, 0x0F, 0xFF, 0x0F, 0x88, 0x70, 0xD0, 0xE0, 0x90, 0x10, 0x03, 0x70, 0xF3,
+	0x90, 0x03, 0xC0, 0xF4, 0x03, 0xC0, 0xF4, 0x03, 0x70, 0xF3, 0xA0, 0x04, 0x80, 0xD0, 0xE0, 0x90,
+	0x10, 0x0F, 0x60, 0x0F, 0xFF, 0x0F, 0x56, 0x20, 0x70, 0xB0, 0xE0, 0xF1, 0xD0, 0xB0, 0x60, 0x10,
+	0x0F, 0x00, 0x20, 0xA0, 0xF9, 0x80, 0x10, 0x0C, 0x40, 0xE0, 0xFB, 0xD0, 0x20, 0x0A, 0x50, 0xF3,
+	0xE0, 0x70, 0x30, 0x11, 0x30, 0x90, 0xF3, 0xE0, 0x20, 0x08, 0x20, 0xE0, 0xF2, 0xB0, 0x10, 0x05,
+	0x20, 0xD0, 0xF2, 0xD0, 0x10, 0x07, 0xC0, 0xF2, 0xC0, 0x10, 0x07, 0x20, 0xE0, 0xF2, 0x90, 0x06,
+	0x50, 0xF3, 0x20, 0x09, 0x40, 0xF3, 0x20, 0x05, 0xC0, 0xF2, 0x90, 0x0B, 0xC0, 0xF2, 0x90, 0x04,
+	0x30, 0xF3, 0x20, 0x0B, 0x50, 0xF2, 0xE0, 0x10, 0x03, 0x80, 0xF2, 0xC0, 0x0C, 0x10, 0xF3, 0x50,
+	0x03, 0xC0, 0xF2, 0x80, 0x0D, 0xB0, 0xF2, 0x90, 0x02, 0x10, 0xF3, 0x50, 0x0D, 0x80, 0xF2, 0xD0,
+	0x02, 0x30, 0xF3, 0x30, 0x0D, 0x60, 0xF3, 0x02, 0x50, 0xF3, 0x10, 0x0D, 0x40, 0xF3, 0x30, 0x01,
+	0x60, 0xF3, 0x0E, 0x20, 0xF3, 0x40, 0x01, 0x80, 0xF2, 0xE0, 0x0E, 0x10, 0xF3, 0x50, 0x01, 0x80,
+	0xF2, 0xD0, 0x0E, 0x10, 0xF3, 0x60, 0x01, 0x80, 0xF2, 0xD0, 0x0E, 0x10, 0xF3, 0x60, 0x01, 0x80,
+	0xF2, 0xD0, 0x0E, 0x10, 0xF3, 0x60, 0x01, 0x80, 0xF2, 0xE0, 0x0E, 0x10, 0xF3, 0x50, 0x01, 0x70,
+	0xF3, 0x0E, 0x20, 0xF3, 0x40, 0x01, 0x50, 0xF3, 0x10, 0x0D, 0x40, 0xF3, 0x30, 0x01, 0x30, 0xF3,
+	0x30, 0x0D, 0x60, 0xF3, 0x10, 0x01, 0x10, 0xF3, 0x50, 0x0D, 0x80, 0xF2, 0xD0, 0x03, 0xC0, 0xF2,
+	0x80, 0x0D, 0xB0, 0xF2, 0x90, 0x03, 0x80, 0xF2, 0xC0, 0x0C, 0x10, 0xF3, 0x50, 0x03, 0x30, 0xF3,
+	0x20, 0x0B, 0x50, 0xF3, 0x10, 0x04, 0xC0, 0xF2, 0x80, 0x0B, 0xB0, 0xF2, 0x90, 0x05, 0x50, 0xF2,
+	0xE0, 0x20, 0x09, 0x40, 0xF3, 0x30, 0x06, 0xC0, 0xF2, 0xC0, 0x08, 0x20, 0xE0, 0xF2, 0x90, 0x07,
+	0x30, 0xE0, 0xF2, 0xB0, 0x10, 0x05, 0x20, 0xD0, 0xF2, 0xD0, 0x10, 0x08, 0x50, 0xF3, 0xE0, 0x70,
+	0x30, 0x11, 0x30, 0x90, 0xF3, 0xE0, 0x30, 0x0A, 0x50, 0xE0, 0xFB, 0xD0, 0x30, 0x0C, 0x20, 0xA0,
+	0xF9, 0x90, 0x10, 0x0F, 0x00, 0x20, 0x80, 0xB0, 0xE0, 0xF1, 0xD0, 0xB0, 0x70, 0x10, 0x0F, 0xFF,
+	0x0F, 0x1E, 0x0F, 0xFF, 0x0F, 0x5B, 0x70, 0xF2, 0x80, 0x0F, 0x06, 0x90, 0xF3, 0x80, 0x0F, 0x04,
+	0x10, 0xA0, 0xF4, 0x80, 0x0F, 0x03, 0x10, 0xC0, 0xF5, 0x80, 0x0F, 0x02, 0x20, 0xD0, 0xF6, 0x80,
+	0x0F, 0x01, 0x30, 0xE0, 0xF7, 0x80, 0x0F, 0x00, 0x40, 0xE0, 0xF3, 0x90, 0xA0, 0xF2, 0x80, 0x0E,
+	0x50, 0xF4, 0x70, 0x00, 0xB0, 0xF2, 0x80, 0x0D, 0x70, 0xF3, 0xE0, 0x50, 0x01, 0xB0, 0xF2, 0x80,
+	0x0D, 0xD0, 0xF2, 0xE0, 0x30, 0x02, 0xB0, 0xF2, 0x80, 0x0D, 0x30, 0xF1, 0xD0, 0x20, 0x03, 0xB0,
+	0xF2, 0x80, 0x0E, 0x40, 0x70, 0x10, 0x04, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F,
+	0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07,
+	0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0,
+	0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2,
+	0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80,
+	0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F,
+	0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0F, 0x07, 0xB0, 0xF2, 0x80, 0x0E, 0x20,
+	0xFF, 0x02, 0x50, 0x07, 0x20, 0xFF, 0x02, 0x50, 0x07, 0x20, 0xFF, 0x02, 0x50, 0x0F, 0xFF, 0x0F,
+	0x17, 0x0F, 0xFF, 0x0F, 0x56, 0x10, 0x60, 0xA0, 0xD0, 0xE0, 0xF0, 0xE0, 0xC0, 0x90, 0x50, 0x0F,
+	0x00, 0x10, 0x90, 0xE0, 0xF8, 0xD0, 0x50, 0x0C, 0x30, 0xD0, 0xFC, 0x90, 0x0A, 0x30, 0xE0, 0xF2,
+	0xE0, 0x80, 0x30, 0x10, 0x00, 0x20, 0x60, 0xC0, 0xF3, 0x80, 0x08, 0x10, 0xD0, 0xF2, 0xC0, 0x20,
+	0x06, 0x80, 0xF3, 0x40, 0x07, 0x80, 0xF2, 0xD0, 0x10, 0x08, 0xA0, 0xF2, 0xC0, 0x06, 0x10, 0xE0,
+	0xF2, 0x40, 0x09, 0x20, 0xF3, 0x30, 0x05, 0x50, 0xF2, 0xD0, 0x0B, 0xC0, 0xF2, 0x70, 0x05, 0x90,
+	0xF2, 0x80, 0x0B, 0xA0, 0xF2, 0x90, 0x05, 0x60, 0xB0, 0xE0, 0xD0, 0x20, 0x0B, 0xA0, 0xF2, 0xB0,
+	0x0F, 0x07, 0xB0, 0xF2, 0xB0, 0x0F, 0x07, 0xE0, 0xF2, 0x90, 0x0F, 0x06, 0x30, 0xF3, 0x70, 0x0F,
+	0x06, 0x90, 0xF3, 0x30, 0x0F, 0x05, 0x20, 0xF3, 0xC0, 0x0F, 0x06, 0xB0, 0xF3, 0x50, 0x0F, 0x05,
+	0x70, 0xF3, 0xC0, 0x0F, 0x05, 0x40, 0xF4, 0x30, 0x0F, 0x04, 0x30, 0xE0, 0xF3, 0x70, 0x0F, 0x04,
+	0x20, 0xE0, 0xF3, 0xA0, 0x0F, 0x04, 0x20, 0xD0, 0xF3, 0xB0, 0x0F, 0x04, 0x10, 0xD0, 0xF3, 0xC0,
+	0x10, 0x0F, 0x03, 0x10, 0xC0, 0xF3, 0xD0, 0x10, 0x0F, 0x03, 0x10, 0xC0, 0xF3, 0xD0, 0x20, 0x0F,
+	0x03, 0x10, 0xC0, 0xF3, 0xE0, 0x20, 0x0F, 0x03, 0x10, 0xB0, 0xF3, 0xE0, 0x30, 0x0F, 0x03, 0x10,
+	0xB0, 0xF3, 0xE0, 0x30, 0x0F, 0x04, 0xB0, 0xF4, 0x40, 0x0F, 0x04, 0xA0, 0xF4, 0x50, 0x0F, 0x04,
+	0xA0, 0xF4, 0x50, 0x0F, 0x04, 0xA0, 0xF4, 0x60, 0x0F, 0x04, 0x90, 0xF4, 0x70, 0x0F, 0x04, 0x40,
+	0xF4, 0xE0, 0xA0, 0xD0, 0xE0, 0xFB, 0xD0, 0x30, 0x03, 0x70, 0xFF, 0x06, 0x70, 0x03, 0x80, 0xFF,
+	0x06, 0x70, 0x0F, 0xFF, 0x0F, 0x17, 0x0F, 0xFF, 0x0F, 0x57, 0x40, 0x90, 0xC0, 0xE0, 0xF0, 0xE0,
+	0xD0, 0xB0, 0x70, 0x20, 0x0F, 0x00, 0x60, 0xD0, 0xF9, 0xB0, 0x20, 0x0B, 0x10, 0xB0, 0xFC, 0xE0,
+	0x40, 0x09, 0x10, 0xC0, 0xF3, 0xB0, 0x50, 0x20, 0x00, 0x10, 0x40, 0x80, 0xE0, 0xF3, 0x30, 0x08,
+	0x90, 0xF3, 0x50, 0x06, 0x20, 0xD0, 0xF2, 0xD0, 0x07, 0x30, 0xF3, 0x50, 0x08, 0x30, 0xF3, 0x50,
+	0x06, 0xA0, 0xF2, 0xA0, 0x0A, 0xA0, 0xF2, 0xA0, 0x06, 0xE0, 0xF2, 0x30, 0x0A, 0x60, 0xF2, 0xC0,
+	0x05, 0x30, 0xF2, 0xD0, 0x0B, 0x50, 0xF2, 0xD0, 0x06, 0x30, 0x60, 0x70, 0x20, 0x0B, 0x50, 0xF2,
+	0xD0, 0x0F, 0x07, 0x70, 0xF2, 0xA0, 0x0F, 0x07, 0xC0, 0xF2, 0x60, 0x0F, 0x06, 0x60, 0xF2, 0xD0,
+	0x0F, 0x06, 0x70, 0xF3, 0x40, 0x0F, 0x01, 0x10, 0x20, 0x40, 0x80, 0xD0, 0xF2, 0xE0, 0x40, 0x0F,
+	0x01, 0x60, 0xF5, 0xD0, 0x60, 0x10, 0x0F, 0x02, 0x60, 0xF5, 0xB0, 0x60, 0x0F, 0x03, 0x60, 0xF7,
+	0xD0, 0x40, 0x0F, 0x02, 0x10, 0x20, 0x30, 0x60, 0xB0, 0xF4, 0x60, 0x0F, 0x06, 0x30, 0xC0, 0xF3,
+	0x30, 0x0F, 0x06, 0x10, 0xC0, 0xF2, 0xC0, 0x0F, 0x07, 0x40, 0xF3, 0x30, 0x0F, 0x07, 0xD0, 0xF2,
+	0x70, 0x0F, 0x07, 0xB0, 0xF2, 0x90, 0x0F, 0x07, 0x90, 0xF2, 0xA0, 0x04, 0x30, 0xA0, 0xC0, 0x50,
+	0x0D, 0xA0, 0xF2, 0x90, 0x03, 0x40, 0xF3, 0x10, 0x0C, 0xC0, 0xF2, 0x70, 0x04, 0xE0, 0xF2, 0x80,
+	0x0B, 0x20, 0xF3, 0x30, 0x04, 0x80, 0xF2, 0xE0, 0x10, 0x0A, 0x90, 0xF2, 0xD0, 0x05, 0x10, 0xE0,
+	0xF2, 0xB0, 0x09, 0x40, 0xF3, 0x60, 0x06, 0x60, 0xF3, 0xA0, 0x10, 0x06, 0x50, 0xF3, 0xC0, 0x08,
+	0xA0, 0xF3, 0xE0, 0x70, 0x30, 0x10, 0x00, 0x20, 0x50, 0xB0, 0xF3, 0xD0, 0x10, 0x09, 0xA0, 0xFD,
+	0xB0, 0x20, 0x0B, 0x50, 0xD0, 0xF9, 0xD0, 0x70, 0x0F, 0x00, 0x40, 0x80, 0xC0, 0xD0, 0xE0, 0xF0,
+	0xE0, 0xC0, 0x90, 0x50, 0x0F, 0xFF, 0x0F, 0x1E, 0x0F, 0xFF, 0x0F, 0x5E, 0xA0, 0xF2, 0xA0, 0x0F,
+	0x06, 0x60, 0xF3, 0xA0, 0x0F, 0x05, 0x30, 0xF4, 0xA0, 0x0F, 0x04, 0x10, 0xD0, 0xF4, 0xA0, 0x0F,
+	0x04, 0x90, 0xF5, 0xA0, 0x0F, 0x03, 0x50, 0xF2, 0xD0, 0xF2, 0xA0, 0x0F, 0x02, 0x20, 0xE0, 0xF2,
+	0x40, 0xF2, 0xA0, 0x0F, 0x02, 0xC0, 0xF2, 0x80, 0x10, 0xF2, 0xA0, 0x0F, 0x01, 0x80, 0xF2, 0xC0,
+	0x00, 0x10, 0xF2, 0xA0, 0x0F, 0x00, 0x40, 0xF2, 0xE0, 0x20, 0x00, 0x10, 0xF2, 0xA0, 0x0E, 0x20,
+	0xE0, 0xF2, 0x60, 0x01, 0x10, 0xF2, 0xA0, 0x0E, 0xB0, 0xF2, 0xA0, 0x02, 0x10, 0xF2, 0xA0, 0x0D,
+	0x70, 0xF2, 0xE0, 0x10, 0x02, 0x10, 0xF2, 0xA0, 0x0C, 0x40, 0xF3, 0x40, 0x03, 0x10, 0xF2, 0xA0,
+	0x0B, 0x10, 0xD0, 0xF2, 0x90, 0x04, 0x10, 0xF2, 0xA0, 0x0B, 0xA0, 0xF2, 0xD0, 0x10, 0x04, 0x10,
+	0xF2, 0xA0, 0x0A, 0x70, 0xF3, 0x30, 0x05, 0x10, 0xF2, 0xA0, 0x09, 0x30, 0xF3, 0x70, 0x06, 0x10,
+	0xF2, 0xA0, 0x08, 0x10, 0xD0, 0xF2, 0xB0, 0x07, 0x10, 0xF2, 0xA0, 0x08, 0xA0, 0xF2, 0xE0, 0x20,
+	0x07, 0x10, 0xF2, 0xA0, 0x07, 0x60, 0xF3, 0x50, 0x08, 0x10, 0xF2, 0xA0, 0x06, 0x20, 0xE0, 0xF2,
+	0xA0, 0x09, 0x10, 0xF2, 0xA0, 0x06, 0xC0, 0xF2, 0xD0, 0x10, 0x09, 0x10, 0xF2, 0xA0, 0x06, 0xE0,
+	0xFF, 0x08, 0xD0, 0x01, 0xB0, 0xFF, 0x08, 0xD0, 0x01, 0x40, 0xE0, 0xFF, 0x07, 0xA0, 0x0F, 0x02,
+	0x10, 0xF2, 0xA0, 0x0F, 0x07, 0x10, 0xF2, 0xA0, 0x0F, 0x07, 0x10, 0xF2, 0xA0, 0x0F, 0x07, 0x10,
+	0xF2, 0xA0, 0x0F, 0x07, 0x10, 0xF2, 0xA0, 0x0F, 0x07, 0x10, 0xF2, 0xA0, 0x0F, 0x07, 0x10, 0xF2,
+	0xA0, 0x0F, 0x07, 0x10, 0xF2, 0xA0, 0x0F, 0x07, 0x10, 0xF2, 0xA0, 0x0F, 0xFF, 0x0F, 0x1B, 0x0F,
+	0xFF, 0x0F, 0x54, 0xE0, 0xFE, 0x70, 0x09, 0x10, 0xFF, 0x00, 0x60, 0x09, 0x40, 0xFD, 0xE0, 0xB0,
+	0x10, 0x09, 0x60, 0xF2, 0x10, 0x0F, 0x07, 0x90, 0xF1, 0xE0, 0x0F, 0x08, 0xC0, 0xF1, 0xC0, 0x0F,
+	0x08, 0xE0, 0xF1, 0x90, 0x0F, 0x07, 0x20, 0xF2, 0x70, 0x0F, 0x07, 0x40, 0xF2, 0x50, 0x0F, 0x07,
+	0x70, 0xF2, 0x30, 0x0F, 0x07, 0x90, 0xF2, 0x0F, 0x08, 0xC0, 0xF1, 0xD0, 0x0F, 0x08, 0xE0, 0xF1,
+	0xB0, 0x0F, 0x07, 0x20, 0xF2, 0xC0, 0x90, 0xC0, 0xD0, 0xE0, 0xF0, 0xE0, 0xD0, 0xA0, 0x60, 0x20,
+	0x0C, 0x50, 0xFD, 0x90, 0x20, 0x0A, 0x70, 0xFE, 0xE0, 0x40, 0x09, 0x30, 0x90, 0xE1, 0xA0, 0x60,
+	0x30, 0x10, 0x00, 0x10, 0x30, 0x60, 0xC0, 0xF4, 0x30, 0x0F, 0x06, 0x60, 0xF3, 0xD0, 0x10, 0x0F,
+	0x06, 0x50, 0xF3, 0x70, 0x0F, 0x07, 0xA0, 0xF2, 0xD0, 0x0F, 0x07, 0x40, 0xF3, 0x30, 0x0F, 0x07,
+	0xF3, 0x60, 0x0F, 0x07, 0xD0, 0xF2, 0x70, 0x0F, 0x07, 0xC0, 0xF2, 0x80, 0x0F, 0x07, 0xD0, 0xF2,
+	0x60, 0x0F, 0x07, 0xF3, 0x50, 0x0F, 0x06, 0x40, 0xF3, 0x10, 0x0F, 0x06, 0x90, 0xF2, 0xB0, 0x0F,
+	0x06, 0x20, 0xF3, 0x50, 0x07, 0x50, 0x60, 0x0A, 0x10, 0xC0, 0xF2, 0xB0, 0x07, 0x50, 0xF1, 0xD0,
+	0x50, 0x07, 0x20, 0xC0, 0xF2, 0xE0, 0x20, 0x06, 0x10, 0xE0, 0xF3, 0xC0, 0x70, 0x30, 0x10, 0x00,
+	0x10, 0x40, 0x90, 0xF3, 0xE0, 0x30, 0x07, 0x10, 0xA0, 0xFE, 0xD0, 0x20, 0x0A, 0x30, 0xA0, 0xFA,
+	0xE0, 0x70, 0x10, 0x0D, 0x10, 0x50, 0x90, 0xC0, 0xD0, 0xE0, 0xF0, 0xD0, 0xC0, 0x90, 0x50, 0x0F,
+	0xFF, 0x0F, 0x20, 0x0F, 0xFF, 0x0F, 0x5C, 0x10, 0xA0, 0xE0, 0xF2, 0x30, 0x0F, 0x05, 0xC0, 0xF3,
+	0x60, 0x0F, 0x05, 0x90, 0xF3, 0x80, 0x0F, 0x05, 0x50, 0xF3, 0xB0, 0x0F, 0x05, 0x20, 0xE0, 0xF2,
+	0xD0, 0x10, 0x0F, 0x05, 0xC0, 0xF2, 0xE0, 0x30, 0x0F, 0x05, 0x80, 0xF3, 0x50, 0x0F, 0x05, 0x40,
+	0xF3, 0x70, 0x0F, 0x05, 0x10, 0xE0, 0xF2, 0xA0, 0x0F, 0x06, 0xB0, 0xF2, 0xC0, 0x10, 0x0F, 0x05,
+	0x70, 0xF2, 0xE0, 0x20, 0x0F, 0x05, 0x30, 0xF3, 0x40, 0x0F, 0x05, 0x10, 0xD0, 0xF2, 0x60, 0x0F,
+	0x06, 0xA0, 0xF2, 0x90, 0x40, 0x90, 0xC0, 0xE0, 0xF0, 0xE0, 0xC0, 0x90, 0x40, 0x0C, 0x50, 0xF2,
+	0xE0, 0xC0, 0xF8, 0xC0, 0x40, 0x09, 0x10, 0xE0, 0xFF, 0x00, 0x60, 0x08, 0x80, 0xF4, 0xE0, 0x80,
+	0x30, 0x10, 0x00, 0x20, 0x60, 0xB0, 0xF4, 0x60, 0x06, 0x10, 0xE0, 0xF3, 0xA0, 0x10, 0x06, 0x50,
+	0xE0, 0xF3, 0x20, 0x05, 0x70, 0xF3, 0xA0, 0x09, 0x40, 0xF3, 0xA0, 0x05, 0xB0, 0xF2, 0xD0, 0x10,
+	0x0A, 0x90, 0xF3, 0x10, 0x03, 0x10, 0xF3, 0x60, 0x0B, 0x20, 0xF3, 0x60, 0x03, 0x30, 0xF3, 0x10,
+	0x0C, 0xD0, 0xF2, 0x90, 0x03, 0x50, 0xF2, 0xD0, 0x0D, 0x90, 0xF2, 0xA0, 0x03, 0x60, 0xF2, 0xB0,
+	0x0D, 0x80, 0xF2, 0xB0, 0x03, 0x50, 0xF2, 0xB0, 0x0D, 0x80, 0xF2, 0xA0, 0x03, 0x30, 0xF2, 0xD0,
+	0x0D, 0xA0, 0xF2, 0x90, 0x03, 0x10, 0xF3, 0x10, 0x0C, 0xD0, 0xF2, 0x50, 0x04, 0xB0, 0xF2, 0x50,
+	0x0B, 0x30, 0xF3, 0x10, 0x04, 0x60, 0xF2, 0xC0, 0x0B, 0xB0, 0xF2, 0xA0, 0x06, 0xD0, 0xF2, 0x70,
+	0x09, 0x70, 0xF3, 0x20, 0x06, 0x50, 0xF3, 0x70, 0x07, 0x80, 0xF3, 0x70, 0x08, 0x80, 0xF3, 0xC0,
+	0x60, 0x20, 0x11, 0x20, 0x70, 0xD0, 0xF3, 0x90, 0x0A, 0x70, 0xFD, 0x80, 0x0C, 0x40, 0xC0, 0xF9,
+	0xB0, 0x30, 0x0F, 0x00, 0x30, 0x80, 0xC0, 0xD0, 0xE1, 0xD0, 0xB0, 0x70, 0x30, 0x0F, 0xFF, 0x0F,
+	0x1E, 0x0F, 0xFF, 0x0F, 0x4F, 0x50, 0xFF, 0x07, 0x03, 0x50, 0xFF, 0x07, 0x03, 0x30, 0xE0, 0xFF,
+	0x06, 0x0F, 0x07, 0xB0, 0xF2, 0xB0, 0x0F, 0x06, 0x50, 0xF3, 0x50, 0x0F, 0x06, 0xD0, 0xF2, 0xD0,
+	0x0F, 0x06, 0x50, 0xF3, 0x50, 0x0F, 0x06, 0xD0, 0xF2, 0xD0, 0x0F, 0x06, 0x50, 0xF3, 0x60, 0x0F,
+	0x06, 0xC0, 0xF2, 0xD0, 0x0F, 0x06, 0x50, 0xF3, 0x60, 0x0F, 0x06, 0xC0, 0xF2, 0xD0, 0x0F, 0x06,
+	0x40, 0xF3, 0x70, 0x0F, 0x06, 0xB0, 0xF2, 0xE0, 0x10, 0x0F, 0x05, 0x40, 0xF3, 0x70, 0x0F, 0x06,
+	0xB0, 0xF2, 0xE0, 0x10, 0x0F, 0x05, 0x30, 0xF3, 0x70, 0x0F, 0x06, 0xA0, 0xF2, 0xE0, 0x10, 0x0F,
+	0x05, 0x30, 0xF3, 0x80, 0x0F, 0x06, 0xA0, 0xF2, 0xE0, 0x10, 0x0F, 0x05, 0x20, 0xF3, 0x80, 0x0F,
+	0x06, 0xA0, 0xF2, 0xE0, 0x10, 0x0F, 0x05, 0x20, 0xF3, 0x90, 0x0F, 0x06, 0x90, 0xF3, 0x20, 0x0F,
+	0x05, 0x20, 0xF3, 0x90, 0x0F, 0x06, 0x90, 0xF3, 0x20, 0x0F, 0x05, 0x10, 0xE0, 0xF2, 0x90, 0x0F,
+	0x06, 0x80, 0xF3, 0x20, 0x0F, 0x05, 0x10, 0xE0, 0xF2, 0xA0, 0x0F, 0x06, 0x80, 0xF3, 0x30, 0x0F,
+	0x05, 0x10, 0xE0, 0xF2, 0xA0, 0x0F, 0x06, 0x70, 0xF3, 0x30, 0x0F, 0x05, 0x10, 0xE0, 0xF2, 0xB0,
+	0x0F, 0x06, 0x70, 0xF3, 0x30, 0x0F, 0x06, 0xE0, 0xF1, 0xE0, 0x50, 0x0F, 0xFF, 0x0F, 0x26, 0x0F,
+	0xFF, 0x0F, 0x56, 0x40, 0x80, 0xC0, 0xD0, 0xF0, 0xE0, 0xD0, 0xB0, 0x70, 0x20, 0x0F, 0x00, 0x40,
+	0xC0, 0xF9, 0xA0, 0x20, 0x0C, 0x80, 0xFC, 0xE0, 0x50, 0x0A, 0x80, 0xF3, 0xC0, 0x60, 0x20, 0x00,
+	0x10, 0x30, 0x70, 0xD0, 0xF3, 0x50, 0x08, 0x40, 0xF3, 0x80, 0x06, 0x10, 0xB0, 0xF2, 0xE0, 0x10,
+	0x07, 0xC0, 0xF2, 0xA0, 0x08, 0x10, 0xD0, 0xF2, 0x80, 0x06, 0x20, 0xF3, 0x20, 0x09, 0x50, 0xF2,
+	0xE0, 0x06, 0x50, 0xF2, 0xD0, 0x0A, 0x10, 0xF3, 0x20, 0x05, 0x70, 0xF2, 0xB0, 0x0B, 0xE0, 0xF2,
+	0x40, 0x05, 0x70, 0xF2, 0xB0, 0x0B, 0xE0, 0xF2, 0x30, 0x05, 0x50, 0xF2, 0xD0, 0x0A, 0x10, 0xF3,
+	0x20, 0x05, 0x10, 0xF3, 0x30, 0x09, 0x60, 0xF2, 0xD0, 0x07, 0xA0, 0xF2, 0xA0, 0x08, 0x10, 0xD0,
+	0xF2, 0x70, 0x07, 0x20, 0xE0, 0xF2, 0x80, 0x06, 0x10, 0xB0, 0xF2, 0xC0, 0x09, 0x40, 0xE0, 0xF2,
+	0xC0, 0x60, 0x20, 0x00, 0x10, 0x20, 0x70, 0xD0, 0xF2, 0xD0, 0x20, 0x0A, 0x20, 0xB0, 0xFB, 0x90,
+	0x10, 0x0C, 0x10, 0x90, 0xF9, 0x70, 0x0C, 0x10, 0x80, 0xE0, 0xFB, 0xE0, 0x60, 0x09, 0x20, 0xC0,
+	0xF3, 0xA0, 0x50, 0x20, 0x00, 0x10, 0x20, 0x60, 0xC0, 0xF3, 0xA0, 0x07, 0x10, 0xD0, 0xF2, 0xD0,
+	0x40, 0x07, 0x60, 0xF3, 0xA0, 0x06, 0x90, 0xF2, 0xE0, 0x30, 0x09, 0x50, 0xF3, 0x60, 0x04, 0x10,
+	0xF3, 0x70, 0x0B, 0xB0, 0xF2, 0xD0, 0x04, 0x60, 0xF3, 0x20, 0x0B, 0x50, 0xF3, 0x20, 0x03, 0x90,
+	0xF2, 0xD0, 0x0C, 0x10, 0xF3, 0x50, 0x03, 0xA0, 0xF2, 0xB0, 0x0D, 0xF3, 0x70, 0x03, 0xA0, 0xF2,
+	0xB0, 0x0D, 0xE0, 0xF2, 0x70, 0x03, 0x90, 0xF2, 0xD0, 0x0C, 0x10, 0xF3, 0x50, 0x03, 0x60, 0xF3,
+	0x10, 0x0B, 0x50, 0xF3, 0x30, 0x03, 0x10, 0xF3, 0x80, 0x0B, 0xB0, 0xF2, 0xD0, 0x05, 0xA0, 0xF2,
+	0xE0, 0x30, 0x09, 0x50, 0xF3, 0x70, 0x05, 0x20, 0xE0, 0xF2, 0xE0, 0x40, 0x07, 0x60, 0xF3, 0xC0,
+	0x07, 0x40, 0xF4, 0xA0, 0x50, 0x20, 0x00, 0x10, 0x20, 0x60, 0xC0, 0xF3, 0xE0, 0x20, 0x08, 0x40,
+	0xE0, 0xFD, 0xC0, 0x20, 0x0A, 0x10, 0x90, 0xE0, 0xF9, 0xE0, 0x70, 0x0E, 0x10, 0x60, 0x90, 0xC0,
+	0xE0, 0xF0, 0xE0, 0xD0, 0xC0, 0x90, 0x50, 0x0F, 0xFF, 0x0F, 0x1E, 0x0F, 0xFF, 0x0F, 0x57, 0x30,
+	0x70, 0xB0, 0xD0, 0xE1, 0xD0, 0xB0, 0x70, 0x20, 0x0F, 0x00, 0x30, 0xB0, 0xF9, 0x90, 0x10, 0x0C,
+	0x60, 0xFC, 0xE0, 0x30, 0x0A, 0x80, 0xF3, 0xC0, 0x60, 0x20, 0x11, 0x30, 0x80, 0xE0, 0xF3, 0x30,
+	0x08, 0x50, 0xF3, 0x70, 0x06, 0x10, 0xB0, 0xF2, 0xD0, 0x10, 0x06, 0x10, 0xE0, 0xF2, 0x70, 0x08,
+	0x10, 0xC0, 0xF2, 0x80, 0x06, 0x70, 0xF2, 0xC0, 0x0A, 0x30, 0xF2, 0xE0, 0x10, 0x05, 0xD0, 0xF2,
+	0x50, 0x0B, 0xC0, 0xF2, 0x50, 0x04, 0x20, 0xF3, 0x10, 0x0B, 0x70, 0xF2, 0x90, 0x04, 0x50, 0xF2,
+	0xE0, 0x0C, 0x50, 0xF2, 0xB0, 0x04, 0x60, 0xF2, 0xD0, 0x0C, 0x40, 0xF2, 0xC0, 0x04, 0x60, 0xF2,
+	0xD0, 0x0C, 0x50, 0xF2, 0xD0, 0x04, 0x50, 0xF3, 0x10, 0x0B, 0x70, 0xF2, 0xC0, 0x04, 0x30, 0xF3,
+	0x40, 0x0B, 0xC0, 0xF2, 0xA0, 0x05, 0xD0, 0xF2, 0xA0, 0x0A, 0x40, 0xF3, 0x70, 0x05, 0x80, 0xF3,
+	0x40, 0x08, 0x10, 0xD0, 0xF3, 0x20, 0x05, 0x10, 0xE0, 0xF2, 0xE0, 0x40, 0x06, 0x20, 0xC0, 0xF3,
+	0xC0, 0x07, 0x50, 0xF4, 0x90, 0x40, 0x10, 0x00, 0x10, 0x40, 0x90, 0xF5, 0x50, 0x08, 0x70, 0xFF,
+	0x00, 0xD0, 0x0A, 0x40, 0xD0, 0xF8, 0xB0, 0xC0, 0xF2, 0x50, 0x0C, 0x50, 0x90, 0xD0, 0xE0, 0xF0,
+	0xE0, 0xB0, 0x80, 0x30, 0x60, 0xF2, 0xA0, 0x0F, 0x06, 0x30, 0xE0, 0xF1, 0xE0, 0x20, 0x0F, 0x05,
+	0x10, 0xD0, 0xF2, 0x60, 0x0F, 0x06, 0xA0, 0xF2, 0xA0, 0x0F, 0x06, 0x70, 0xF2, 0xE0, 0x10, 0x0F,
+	0x05, 0x40, 0xF3, 0x50, 0x0F, 0x05, 0x20, 0xE0, 0xF2, 0xA0, 0x0F, 0x06, 0xC0, 0xF2, 0xD0, 0x10,
+	0x0F, 0x05, 0x90, 0xF3, 0x40, 0x0F, 0x05, 0x60, 0xF3, 0x90, 0x0F, 0x05, 0x30, 0xE0, 0xF2, 0xD0,
+	0x10, 0x0F, 0x04, 0x10, 0xD0, 0xF3, 0x30, 0x0F, 0x05, 0xB0, 0xF3, 0x80, 0x0F, 0x05, 0x70, 0xF3,
+	0xC0, 0x0F, 0x05, 0x40, 0xF3, 0xB0, 0x20, 0x0F, 0xFF, 0x0F, 0x23, 0x0F, 0xFF, 0x0F, 0x05, 0x70,
+	0xD0, 0xE0, 0x80, 0x10, 0x05, 0x70, 0xF3, 0x90, 0x05, 0xC0, 0xF3, 0xE0, 0x05, 0xD0, 0xF3, 0xE0,
+	0x05, 0x70, 0xF3, 0x90, 0x06, 0x80, 0xE1, 0x90, 0x10, 0x0F, 0x87, 0x70, 0xD0, 0xE0, 0x80, 0x10,
+	0x05, 0x70, 0xF3, 0x90, 0x05, 0xC0, 0xF3, 0xE0, 0x05, 0xD0, 0xF3, 0xE0, 0x05, 0x70, 0xF3, 0x90,
+	0x06, 0x80, 0xE1, 0x90, 0x10, 0x0F, 0x77,
+};
+
+static const aa_char_info_t font_aa_59_info[13] = {
+	{17, 0},	/* '-' */
+	{10, 20},	/* '.' */
+	{28, 51},	/* '0' */
+	{28, 354},	/* '1' */
+	{28, 561},	/* '2' */
+	{28, 806},	/* '3' */
+	{28, 1080},	/* '4' */
+	{28, 1327},	/* '5' */
+	{28, 1555},	/* '6' */
+	{28, 1825},	/* '7' */
+	{28, 2015},	/* '8' */
+	{28, 2331},	/* '9' */
+	{12, 2603},	/* ':' */
+};
+
+static const uint8_t font_aa_59_map[14] = {
+	0x00, 0x01, 0xFF, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C,
+};
+
+const aa_font_t font_aa_59 = {
+	.font_height = 59,
+	.bpp = 4,
+	.rle = true,
+	.first = '-',
+	.last = ':',
+	.map = font_aa_59_map,
+	.info = font_aa_59_info,
+	.data = font_aa_59_data
+};
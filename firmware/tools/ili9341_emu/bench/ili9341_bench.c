@@ -0,0 +1,344 @@
+/**
+ * @file ili9341_bench.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Rendering benchmarks of the ILI9341 drivers on the host emulator
+ *
+ * Draws representative screens and prints the SPI traffic of each one. A hash
+ * of each screen detects changes in the rendered images between versions.
+ *
+ * Usage: ili9341_bench [-o dir] [-w hashes.txt | -c hashes.txt]
+ *   -o dir: save a PPM snapshot of each screen in dir
+ *   -w file: write the screen hashes
+ *   -c file: compare the screen hashes, returns 1 if an image changed
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ili9341_emu.h"
+#include "gpio_mcu.h"
+#include "spi_mcu.h"
+#include "ili9341.h"
+#include "ili9341_scene.h"
+#include "ili9341_chart.h"
+#include "ili9341_sprite.h"
+#include "ili9341_assets.h"
+/*==================[macros and definitions]=================================*/
+#define GPIO_DC		GPIO_2		/*!< Data/command line of the emulated LCD */
+#define GPIO_RST	GPIO_3		/*!< Reset line of the emulated LCD */
+#define PIC_W		120			/*!< Test picture width */
+#define PIC_H		80			/*!< Test picture height */
+#define BENCH_MAX	16			/*!< Max benchmarks */
+#define BALL_SIZE	24			/*!< Sprite width and height */
+#define BALL_KEY	ILI9341_MAGENTA	/*!< Sprite transparent color */
+/*==================[internal data declaration]==============================*/
+extern const aa_font_t font_aa_59;	/*!< Generated with font2ili9341.py (see font_aa_59.c) */
+/**
+ * @brief Benchmark
+ */
+typedef struct {
+	const char *name;
+	void (*setup)(void);	/*!< Not measured (NULL: none) */
+	void (*draw)(void);		/*!< Measured */
+	void (*end)(void);		/*!< Not measured, after the snapshot (NULL: none) */
+} bench_t;
+
+static uint8_t picture[PIC_W * PIC_H * 2];
+static uint8_t stripes_data[PIC_H * 8];
+static const uint16_t stripes_palette[] = {ILI9341_NAVY, ILI9341_ORANGE, ILI9341_WHITE, ILI9341_DARKGREEN};
+static ili9341_image_t stripes = {PIC_W, PIC_H, ILI9341_IMAGE_PALETTE_RLE, 8, stripes_palette, stripes_data, 0};
+static ili9341_item_t scene_ball;
+static uint8_t ball_data[BALL_SIZE * BALL_SIZE / 8];
+static const uint16_t ball_palette[] = {BALL_KEY, ILI9341_YELLOW};
+static const ili9341_image_t ball = {BALL_SIZE, BALL_SIZE, ILI9341_IMAGE_PALETTE, 1, ball_palette, ball_data, sizeof(ball_data)};
+static ili9341_sprite_t sprite_ball;
+/* Assets from the partition (see assets.bin in the Makefile) */
+static ili9341_image_t asset_picture;
+static Font_t asset_font;
+static icon_font_t asset_icons;
+/*==================[internal functions definition]==========================*/
+static void BenchPictures(void){
+	uint32_t i = 0;
+	uint16_t color;
+	/* Gradient (every pixel different) */
+	for (uint16_t y = 0; y < PIC_H; y++){
+		for (uint16_t x = 0; x < PIC_W; x++){
+			color = ((x * 31 / PIC_W) << 11) | ((y * 63 / PIC_H) << 5) | ((x + y) & 0x1F);
+			picture[i++] = color >> 8;
+			picture[i++] = color & 0xFF;
+		}
+	}
+	/* Palette RLE image: 4 runs of 30 pixels per row */
+	i = 0;
+	for (uint16_t y = 0; y < PIC_H; y++){
+		for (uint8_t s = 0; s < 4; s++){
+			stripes_data[i++] = 0x80 | (30 - 1);
+			stripes_data[i++] = (s + y / 20) % 4;
+		}
+	}
+	stripes.size = i;
+	/* 1 bpp ball, transparent corners */
+	for (int16_t y = 0; y < BALL_SIZE; y++){
+		for (int16_t x = 0; x < BALL_SIZE; x++){
+			int16_t dx = 2 * x - BALL_SIZE + 1, dy = 2 * y - BALL_SIZE + 1;
+			if (dx * dx + dy * dy <= BALL_SIZE * BALL_SIZE){
+				ball_data[(y * BALL_SIZE + x) / 8] |= 0x80 >> (x % 8);
+			}
+		}
+	}
+}
+
+static void Clear(void){
+	ILI9341Rotate(ILI9341_Portrait_1);
+	ILI9341Fill(ILI9341_BLACK);
+}
+
+static void DrawFill(void){
+	ILI9341Fill(ILI9341_BLUE);
+}
+
+static void DrawText(void){
+	ILI9341DrawString(4, 4, "ESP-EDU ILI9341", &font_30, ILI9341_WHITE, ILI9341_BLACK);
+	ILI9341DrawString(4, 40, "Frecuencia cardiaca:\nTemperatura:\nBateria:", &font_19, ILI9341_YELLOW, ILI9341_BLACK);
+	for (uint8_t i = 0; i < 12; i++){
+		ILI9341DrawString(4, 110 + i * 14, "The quick brown fox jumps over the dog", &font_11, ILI9341_GREEN, ILI9341_BLACK);
+	}
+	ILI9341DrawInt(180, 40, 72, 3, &font_19, ILI9341_RED, ILI9341_BLACK);
+	ILI9341DrawInt(180, 60, 365, 3, &font_19, ILI9341_RED, ILI9341_BLACK);
+}
+
+static void DrawTextBottom(void){
+	/* Lines partially below the LCD: only the visible rows are drawn */
+	ILI9341DrawString(4, 300, "bottom", &font_30, ILI9341_WHITE, ILI9341_BLACK);
+	ILI9341DrawInt(120, 310, 365, 3, &font_19, ILI9341_RED, ILI9341_BLACK);
+}
+
+static void DrawDigits(void){
+	ILI9341DrawString(4, 4, "12:48", &font_59, ILI9341_WHITE, ILI9341_BLACK);
+	ILI9341DrawString(4, 80, "-37.5", &font_59, ILI9341_CYAN, ILI9341_NAVY);
+}
+
+static void DrawDigitsAA(void){
+	ILI9341DrawAAString(4, 4, "12:48", &font_aa_59, ILI9341_WHITE, ILI9341_BLACK);
+	ILI9341DrawAAString(4, 80, "-37.5", &font_aa_59, ILI9341_CYAN, ILI9341_NAVY);
+}
+
+static void DrawShapes(void){
+	for (uint8_t i = 0; i < 8; i++){
+		ILI9341DrawLine(0, i * 40, 239, 319 - i * 40, ILI9341_CYAN);
+	}
+	ILI9341DrawRectangle(10, 10, 229, 309, ILI9341_WHITE);
+	ILI9341DrawCircle(120, 100, 60, ILI9341_YELLOW);
+	ILI9341DrawFilledCircle(60, 220, 40, ILI9341_RED);
+	ILI9341DrawFilledCircle(180, 220, 25, ILI9341_MAGENTA);
+	ILI9341DrawTriangle(20, 300, 120, 180, 220, 300, ILI9341_GREEN);
+	ILI9341DrawFilledTriangle(100, 260, 140, 250, 120, 300, ILI9341_ORANGE);
+}
+
+static void DrawIcons(void){
+	for (uint8_t i = 0; i < 6; i++){
+		ILI9341DrawIcon(4 + i * 36, 4, ICON_BAT_0 + i, &icon_30, ILI9341_WHITE, ILI9341_BLACK);
+		ILI9341DrawIcon(4 + i * 36, 50, ICON_SIGNAL_0 + (i % 4), &icon_30, ILI9341_GREEN, ILI9341_BLACK);
+	}
+}
+
+static void DrawPictures(void){
+	ILI9341DrawPicture(0, 0, PIC_W, PIC_H, picture);
+	ILI9341DrawPicture(PIC_W, PIC_H, PIC_W, PIC_H, picture);
+}
+
+static void DrawImages(void){
+	ILI9341DrawImage(0, 0, &stripes);
+	ILI9341DrawImage(PIC_W, PIC_H, &stripes);
+}
+
+static void SceneSetup(void){
+	Clear();
+	ILI9341SceneInit(ILI9341_BLACK, 0);
+	ILI9341SceneAddRect(0, 0, 240, 30, ILI9341_NAVY, true);
+	ILI9341SceneAddText(6, 8, "Scene", &font_19, ILI9341_WHITE);
+	ILI9341SceneAddLine(0, 160, 239, 160, ILI9341_DARKGREY);
+	ILI9341SceneAddCircle(60, 240, 30, ILI9341_GREEN, false);
+	scene_ball = ILI9341SceneAddCircle(120, 160, 16, ILI9341_RED, true);
+	ILI9341SceneFlush();
+}
+
+static void DrawSceneMove(void){
+	/* Ball moves 10 frames */
+	for (uint8_t i = 0; i < 10; i++){
+		ILI9341SceneMove(scene_ball, 4, 2);
+		ILI9341SceneFlush();
+	}
+}
+
+static void SpriteSetup(void){
+	Clear();
+	ILI9341DrawPicture(0, 0, PIC_W, PIC_H, picture);
+	ILI9341DrawImage(PIC_W, 0, &stripes);
+	ILI9341DrawString(4, 100, "Sprite", &font_30, ILI9341_WHITE, ILI9341_BLACK);
+	ILI9341SpriteInit(&sprite_ball, &ball, BALL_KEY, NULL);
+}
+
+static void DrawSpriteMove(void){
+	/* Ball moves 30 frames over the pictures and the text */
+	for (int16_t i = 0; i < 30; i++){
+		ILI9341SpriteMove(&sprite_ball, 200 - i * 6, 10 + i * 4);
+	}
+}
+
+static void SpriteEnd(void){
+	ILI9341SpriteHide(&sprite_ball);
+	ILI9341SpriteDeinit(&sprite_ball);
+}
+
+static void AssetsSetup(void){
+	Clear();
+	ILI9341AssetsImage("esp_edu", &asset_picture);
+	ILI9341AssetsFont("font_30", &asset_font);
+	ILI9341AssetsIcons("icon_30", &asset_icons);
+}
+
+static void DrawAssets(void){
+	/* Same drawings as with the compiled assets, from the mapped partition */
+	ILI9341DrawImage(0, 0, &asset_picture);
+	ILI9341DrawString(4, 4, "ESP-EDU", &asset_font, ILI9341_WHITE, ILI9341_BLACK);
+	for (uint8_t i = 0; i < 6; i++){
+		ILI9341DrawIcon(4 + i * 36, 280, ICON_BAT_0 + i, &asset_icons, ILI9341_WHITE, ILI9341_BLACK);
+	}
+}
+
+static void ChartSetup(void){
+	ILI9341Rotate(ILI9341_Landscape_1);
+	ILI9341Fill(ILI9341_BLACK);
+	ili9341_chart_config_t chart = {
+		.start = 40,
+		.length = 280,
+		.min = 0,
+		.max = 3300,
+		.color = ILI9341_GREEN,
+		.background = ILI9341_BLACK,
+		.grid_color = ILI9341_DARKGREY,
+		.grid_step = 40,
+	};
+	ILI9341ChartInit(&chart);
+}
+
+static void DrawChart(void){
+	uint16_t samples[500];
+	for (uint16_t i = 0; i < 500; i++){
+		samples[i] = 1650 + 1500 * sin(i * 0.05);
+	}
+	ILI9341ChartPush(samples, 500);
+}
+
+static void ChartEnd(void){
+	ILI9341ChartDeinit();
+}
+
+static const bench_t benchs[] = {
+	{"fill", Clear, DrawFill, NULL},
+	{"text", Clear, DrawText, NULL},
+	{"text_bottom", Clear, DrawTextBottom, NULL},
+	{"digits_59", Clear, DrawDigits, NULL},
+	{"digits_aa_59", Clear, DrawDigitsAA, NULL},
+	{"shapes", Clear, DrawShapes, NULL},
+	{"icons", Clear, DrawIcons, NULL},
+	{"picture_raw", Clear, DrawPictures, NULL},
+	{"image_palette_rle", Clear, DrawImages, NULL},
+	{"scene_move", SceneSetup, DrawSceneMove, NULL},
+	{"sprite_move", SpriteSetup, DrawSpriteMove, SpriteEnd},
+	{"assets_partition", AssetsSetup, DrawAssets, NULL},
+	{"chart_500_samples", ChartSetup, DrawChart, ChartEnd},
+};
+/*==================[external functions definition]==========================*/
+int main(int argc, char **argv){
+	const char *out_dir = NULL, *write_path = NULL, *check_path = NULL, *assets_path = NULL;
+	uint32_t hashes[BENCH_MAX];
+	uint8_t n = sizeof(benchs) / sizeof(benchs[0]);
+	emu_counters_t c;
+	char path[256], name[64];
+	unsigned hash;
+	int changed = 0;
+
+	for (int i = 1; i < argc - 1; i++){
+		if (strcmp(argv[i], "-o") == 0){
+			out_dir = argv[++i];
+		} else if (strcmp(argv[i], "-w") == 0){
+			write_path = argv[++i];
+		} else if (strcmp(argv[i], "-c") == 0){
+			check_path = argv[++i];
+		} else if (strcmp(argv[i], "-a") == 0){
+			assets_path = argv[++i];
+		}
+	}
+
+	BenchPictures();
+	EmuInit(GPIO_DC);
+	ILI9341Init(SPI_1, GPIO_DC, GPIO_RST);
+	if ((assets_path == NULL) || !EmuPartitionLoad("assets", ILI9341_ASSETS_SUBTYPE, assets_path) || !ILI9341AssetsInit(NULL)){
+		printf("No assets partition (-a assets.bin)\n");
+		return 2;
+	}
+
+	printf("%-20s %8s %8s %9s %8s %8s %9s %9s  %s\n",
+		"benchmark", "trans", "queued", "bytes", "windows", "ramwr", "pixels", "spi_ms", "hash");
+	for (uint8_t i = 0; i < n; i++){
+		if (benchs[i].setup != NULL){
+			benchs[i].setup();
+		}
+		/* Transactions still queued belong to the previous step */
+		SpiQueueWait(SPI_1, 0);
+		EmuCountersReset();
+		benchs[i].draw();
+		SpiQueueWait(SPI_1, 0);
+		EmuCountersGet(&c);
+		hashes[i] = EmuScreenHash();
+		printf("%-20s %8u %8u %9u %8u %8u %9u %9.2f  %08x\n", benchs[i].name,
+			c.transactions, c.queued, c.bytes, c.windows, c.mem_writes, c.pixels,
+			EmuSpiTimeUs(&c) / 1000.0, hashes[i]);
+		if (out_dir != NULL){
+			snprintf(path, sizeof(path), "%s/%s.ppm", out_dir, benchs[i].name);
+			EmuSavePpm(path);
+		}
+		if (benchs[i].end != NULL){
+			benchs[i].end();
+		}
+	}
+
+	if (write_path != NULL){
+		FILE *f = fopen(write_path, "w");
+		if (f == NULL){
+			return 2;
+		}
+		for (uint8_t i = 0; i < n; i++){
+			fprintf(f, "%s %08x\n", benchs[i].name, hashes[i]);
+		}
+		fclose(f);
+	}
+	if (check_path != NULL){
+		FILE *f = fopen(check_path, "r");
+		if (f == NULL){
+			return 2;
+		}
+		while (fscanf(f, "%63s %x", name, &hash) == 2){
+			for (uint8_t i = 0; i < n; i++){
+				if ((strcmp(name, benchs[i].name) == 0) && (hash != hashes[i])){
+					printf("%s: image changed (%08x, expected %08x)\n", name, hashes[i], hash);
+					changed = 1;
+				}
+			}
+		}
+		fclose(f);
+	}
+	return changed;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,118 @@
+#ifndef ILI9341_EMU_H_
+#define ILI9341_EMU_H_
+/** \addtogroup Tools Tools
+ ** @{ */
+/** \addtogroup ILI9341_Emu ILI9341 emulator
+ ** @{ */
+
+/** \brief Host emulator of the ILI9341 display.
+ *
+ * Replaces spi_mcu, gpio_mcu, delay_mcu and esp_partition, so the ILI9341 drivers
+ * (ili9341.c, ili9341_scene.c, ili9341_chart.c, ili9341_sprite.c, ili9341_assets.c)
+ * can be compiled and run on a PC. The bytes sent through SPI are decoded as the LCD controller does (DC line,
+ * CASET, PASET, RAMWR, MADCTL, VSCRDEF and VSCRSAD) into a 240x320 frame memory,
+ * that can be read back (RAMRD).
+ *
+ * Every transaction is accounted (bytes, commands, address windows, pixels), so the
+ * cost of each drawing function can be measured without a display.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    |
+ * |:----------:|:-----------------------------------------------|
+ * | 19/10/2026 | Document creation		                         |
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+/*==================[macros]=================================================*/
+#define EMU_COLUMNS		240			/*!< Frame memory columns */
+#define EMU_LINES		320			/*!< Frame memory lines */
+#define EMU_SPI_HZ		20000000	/*!< SPI clock used for time estimations */
+#define EMU_READ_HZ		6000000		/*!< SPI clock of frame memory reads, used for time estimations */
+#define EMU_READ_MAX_HZ	6666666		/*!< Max clock of frame memory reads (150 ns read cycle) */
+#define EMU_TRANS_US	5			/*!< Estimated overhead of each SPI transaction (us) */
+/*==================[typedef]================================================*/
+/**
+ * @brief SPI traffic counters
+ */
+typedef struct {
+	uint32_t transactions;		/*!< SPI transactions (polling and queued) */
+	uint32_t queued;			/*!< Queued (DMA) transactions */
+	uint32_t bytes;				/*!< Bytes transferred (sent and read) */
+	uint32_t read_bytes;		/*!< Bytes read from frame memory (included in bytes) */
+	uint32_t commands;			/*!< Command bytes (DC low) */
+	uint32_t windows;			/*!< Address window changes (CASET and PASET) */
+	uint32_t mem_writes;		/*!< RAMWR commands */
+	uint32_t pixels;			/*!< Pixels written in frame memory */
+} emu_counters_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Emulator initialization: black frame memory, default registers, counters in 0
+ * @param[in]  	gpio_dc: GPIO used as data/command line (same as in ILI9341Init())
+ * @retval 		None
+ */
+void EmuInit(uint8_t gpio_dc);
+
+/**
+ * @brief  		Reset the traffic counters
+ * @retval 		None
+ */
+void EmuCountersReset(void);
+
+/**
+ * @brief  		Read the traffic counters
+ * @param[out]  counters: Counters since the last reset
+ * @retval 		None
+ */
+void EmuCountersGet(emu_counters_t *counters);
+
+/**
+ * @brief  		Estimated SPI time of the counted traffic
+ * @param[in]  	counters: Counters
+ * @retval 		Time in microseconds (EMU_SPI_HZ clock, EMU_READ_HZ for frame memory reads,
+ * 				EMU_TRANS_US per transaction)
+ */
+uint32_t EmuSpiTimeUs(const emu_counters_t *counters);
+
+/**
+ * @brief  		Pixel shown by the LCD (orientation and scrolling applied)
+ * @param[in]  	x: X position, in the orientation set with MADCTL
+ * @param[in]  	y: Y position, in the orientation set with MADCTL
+ * @retval 		Color (RGB565)
+ */
+uint16_t EmuGetPixel(uint16_t x, uint16_t y);
+
+/**
+ * @brief  		Hash of the image shown by the LCD (to detect changes between versions)
+ * @retval 		FNV-1a hash
+ */
+uint32_t EmuScreenHash(void);
+
+/**
+ * @brief  		Save the image shown by the LCD as a PPM file
+ * @param[in]  	path: File name
+ * @retval 		true if success
+ */
+bool EmuSavePpm(const char *path);
+
+/**
+ * @brief  		Load a file as a flash partition (found and mapped with the esp_partition functions)
+ * @param[in]  	label: Partition name
+ * @param[in]  	subtype: Data partition subtype
+ * @param[in]  	path: File with the partition content (e.g. made with assets2ili9341.py)
+ * @retval 		true if success
+ */
+bool EmuPartitionLoad(const char *label, uint8_t subtype, const char *path);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ILI9341_EMU_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,548 @@
+/**
+ * @file ili9341_emu.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host emulator of the ILI9341 display (mock of spi_mcu, gpio_mcu, delay_mcu and esp_partition)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ili9341_emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spi_mcu.h"
+#include "gpio_mcu.h"
+#include "delay_mcu.h"
+#include "soc/gpio_reg.h"
+#include "esp_partition.h"
+/*==================[macros and definitions]=================================*/
+#define EMU_QUEUE_SIZE	8		/*!< Queued transactions (same as spi_mcu) */
+#define EMU_GPIOS		32		/*!< Emulated GPIOs */
+#define EMU_PARTITIONS	4		/*!< Partitions loaded with EmuPartitionLoad() */
+#define EMU_FLASH_SECTOR	4096	/*!< Partition sizes are multiple of the flash sector */
+
+/* Commands decoded by the emulator */
+#define CMD_RESET			0x01
+#define CMD_COLUMN_ADDR_SET	0x2A
+#define CMD_PAGE_ADDR_SET	0x2B
+#define CMD_MEM_WRITE		0x2C
+#define CMD_MEM_READ		0x2E
+#define CMD_MEM_READ_CONT	0x3E
+#define CMD_VERT_SCROLL_DEF	0x33
+#define CMD_MEM_ACC_CTRL	0x36
+#define CMD_VERT_SCROLL_START	0x37
+
+/* MADCTL bits */
+#define MADCTL_MY		0x80
+#define MADCTL_MX		0x40
+#define MADCTL_MV		0x20
+/*==================[internal data declaration]==============================*/
+/**
+ * @brief Transaction queued by the driver, decoded when it "ends"
+ */
+typedef struct {
+	const uint8_t *tx;
+	uint8_t *rx;
+	uint32_t size;
+	void *user;
+} emu_trans_t;
+
+/**
+ * @brief Emulated SPI device
+ */
+typedef struct {
+	void (*pre_func_p)(void *);				/*!< Pre-transaction function (drives DC) */
+	void (*post_func_p)(void *);			/*!< Post-transaction function */
+	uint32_t bitrate;						/*!< SPI clock */
+	emu_trans_t queue[EMU_QUEUE_SIZE];		/*!< Transactions in flight */
+	uint8_t head;
+	uint8_t pending;
+} emu_spi_t;
+
+static uint16_t gram[EMU_LINES][EMU_COLUMNS];	/*!< Frame memory (Portrait_1 frame) */
+static bool gpio_level[EMU_GPIOS];
+static uint8_t dc_pin;
+static emu_spi_t spi_dev[3];
+static emu_counters_t counters;
+/* Controller registers */
+static uint8_t madctl;
+static uint16_t col_start, col_end, page_start, page_end;
+static uint16_t scroll_top, scroll_lines, scroll_start;
+/* Command being decoded */
+static uint8_t cmd;
+static uint8_t params[6];
+static uint8_t n_params;
+static uint16_t cur_x, cur_y;
+static int16_t high_byte;
+static uint16_t read_x, read_y;		/*!< Next pixel read */
+static int8_t read_byte;			/*!< Byte of the pixel read (-1: dummy byte) */
+static uint8_t read_rgb[3];
+/* Flash partitions */
+static esp_partition_t partitions[EMU_PARTITIONS];
+static uint8_t *partition_data[EMU_PARTITIONS];
+static uint8_t n_partitions;
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/**
+ * @brief Frame memory position of a pixel (x, y) in the orientation selected with MADCTL
+ */
+static void EmuMap(uint16_t x, uint16_t y, uint16_t *col, uint16_t *line){
+	uint16_t c = (madctl & MADCTL_MV) ? y : x;
+	uint16_t l = (madctl & MADCTL_MV) ? x : y;
+	/* Portrait_1 (MX = 1) is the reference frame */
+	*col = (madctl & MADCTL_MX) ? c : (EMU_COLUMNS - 1 - c);
+	*line = (madctl & MADCTL_MY) ? (EMU_LINES - 1 - l) : l;
+}
+
+static void EmuCommand(uint8_t c){
+	counters.commands++;
+	cmd = c;
+	n_params = 0;
+	high_byte = -1;
+	switch (cmd){
+	case CMD_MEM_WRITE:
+		counters.mem_writes++;
+		cur_x = col_start;
+		cur_y = page_start;
+		break;
+	case CMD_MEM_READ:
+		read_x = col_start;
+		read_y = page_start;
+		read_byte = -1;
+		break;
+	case CMD_MEM_READ_CONT:
+		read_byte = -1;
+		break;
+	case CMD_RESET:
+		madctl = 0;
+		scroll_top = 0;
+		scroll_lines = EMU_LINES;
+		scroll_start = 0;
+		break;
+	}
+}
+
+static void EmuPixel(uint16_t color){
+	uint16_t col, line;
+	if (cur_y > page_end){
+		return;
+	}
+	EmuMap(cur_x, cur_y, &col, &line);
+	if ((col < EMU_COLUMNS) && (line < EMU_LINES)){
+		gram[line][col] = color;
+	}
+	counters.pixels++;
+	if (++cur_x > col_end){
+		cur_x = col_start;
+		cur_y++;
+	}
+}
+
+/**
+ * @brief Byte answered to a memory read: a dummy byte, then R, G and B (6 bits, left aligned) of each pixel
+ */
+static uint8_t EmuReadByte(void){
+	uint16_t col, line, color = 0;
+	if ((cmd != CMD_MEM_READ) && (cmd != CMD_MEM_READ_CONT)){
+		return 0;
+	}
+	if (read_byte < 0){
+		read_byte = 0;
+		return 0;
+	}
+	if (read_byte == 0){
+		EmuMap(read_x, read_y, &col, &line);
+		if ((col < EMU_COLUMNS) && (line < EMU_LINES) && (read_y <= page_end)){
+			color = gram[line][col];
+		}
+		read_rgb[0] = (color >> 8) & 0xF8;
+		read_rgb[1] = (color >> 3) & 0xFC;
+		read_rgb[2] = (color << 3) & 0xF8;
+		if (++read_x > col_end){
+			read_x = col_start;
+			read_y++;
+		}
+	}
+	color = read_rgb[read_byte];
+	read_byte = (read_byte + 1) % 3;
+	return color;
+}
+
+static void EmuData(uint8_t data){
+	switch (cmd){
+	case CMD_MEM_WRITE:
+		if (high_byte < 0){
+			high_byte = data;
+		} else{
+			EmuPixel((high_byte << 8) | data);
+			high_byte = -1;
+		}
+		return;
+	case CMD_COLUMN_ADDR_SET:
+	case CMD_PAGE_ADDR_SET:
+	case CMD_VERT_SCROLL_DEF:
+	case CMD_VERT_SCROLL_START:
+	case CMD_MEM_ACC_CTRL:
+		if (n_params < sizeof(params)){
+			params[n_params++] = data;
+		}
+		break;
+	default:
+		return;
+	}
+	if ((cmd == CMD_COLUMN_ADDR_SET) && (n_params == 4)){
+		col_start = (params[0] << 8) | params[1];
+		col_end = (params[2] << 8) | params[3];
+		counters.windows++;
+	} else if ((cmd == CMD_PAGE_ADDR_SET) && (n_params == 4)){
+		page_start = (params[0] << 8) | params[1];
+		page_end = (params[2] << 8) | params[3];
+		counters.windows++;
+	} else if ((cmd == CMD_VERT_SCROLL_DEF) && (n_params == 6)){
+		scroll_top = (params[0] << 8) | params[1];
+		scroll_lines = (params[2] << 8) | params[3];
+	} else if ((cmd == CMD_VERT_SCROLL_START) && (n_params == 2)){
+		scroll_start = (params[0] << 8) | params[1];
+	} else if (cmd == CMD_MEM_ACC_CTRL){
+		madctl = params[0];
+	}
+}
+
+/**
+ * @brief Transfer of a transaction: the pre-transaction function drives DC, then the bytes are decoded
+ */
+static void EmuTransfer(emu_spi_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t size, void *user){
+	if (dev->pre_func_p != NULL){
+		dev->pre_func_p(user);
+	}
+	counters.transactions++;
+	counters.bytes += size;
+	if ((rx != NULL) && ((cmd == CMD_MEM_READ) || (cmd == CMD_MEM_READ_CONT))){
+		counters.read_bytes += size;
+		if (dev->bitrate > EMU_READ_MAX_HZ){
+			fprintf(stderr, "emu: frame memory read at %u Hz (max %d Hz)\n", (unsigned)dev->bitrate, EMU_READ_MAX_HZ);
+		}
+	}
+	for (uint32_t i = 0; i < size; i++){
+		/* While the LCD answers (SDO), MOSI is ignored */
+		if (rx != NULL){
+			rx[i] = EmuReadByte();
+		} else if (tx == NULL){
+			continue;
+		} else if (gpio_level[dc_pin]){
+			EmuData(tx[i]);
+		} else{
+			EmuCommand(tx[i]);
+		}
+	}
+	if (dev->post_func_p != NULL){
+		dev->post_func_p(user);
+	}
+}
+
+/**
+ * @brief Ends the oldest queued transactions (DMA reads the buffers at this moment)
+ */
+static void EmuQueueFlush(emu_spi_t *dev, uint8_t max_pending){
+	emu_trans_t *t;
+	while (dev->pending > max_pending){
+		t = &dev->queue[(dev->head + EMU_QUEUE_SIZE - dev->pending) % EMU_QUEUE_SIZE];
+		EmuTransfer(dev, t->tx, t->rx, t->size, t->user);
+		dev->pending--;
+	}
+}
+
+/**
+ * @brief Frame memory line shown at a line of the LCD (vertical scrolling)
+ */
+static uint16_t EmuScrollLine(uint16_t line){
+	if ((scroll_lines == 0) || (line < scroll_top) || (line >= scroll_top + scroll_lines)){
+		return line;
+	}
+	return scroll_top + (line - scroll_top + scroll_start - scroll_top + scroll_lines) % scroll_lines;
+}
+
+/*==================[external functions definition]==========================*/
+void EmuInit(uint8_t gpio_dc){
+	memset(gram, 0, sizeof(gram));
+	memset(gpio_level, 0, sizeof(gpio_level));
+	memset(spi_dev, 0, sizeof(spi_dev));
+	dc_pin = gpio_dc % EMU_GPIOS;
+	EmuCommand(CMD_RESET);
+	col_start = 0;
+	col_end = EMU_COLUMNS - 1;
+	page_start = 0;
+	page_end = EMU_LINES - 1;
+	EmuCountersReset();
+}
+
+void EmuCountersReset(void){
+	memset(&counters, 0, sizeof(counters));
+}
+
+void EmuCountersGet(emu_counters_t *c){
+	/* Queued transactions are counted when they end */
+	for (uint8_t i = 0; i < 3; i++){
+		EmuQueueFlush(&spi_dev[i], 0);
+	}
+	*c = counters;
+}
+
+uint32_t EmuSpiTimeUs(const emu_counters_t *c){
+	return (uint32_t)((uint64_t)(c->bytes - c->read_bytes) * 8 * 1000000 / EMU_SPI_HZ) +
+		(uint32_t)((uint64_t)c->read_bytes * 8 * 1000000 / EMU_READ_HZ) + c->transactions * EMU_TRANS_US;
+}
+
+uint16_t EmuGetPixel(uint16_t x, uint16_t y){
+	uint16_t col, line;
+	EmuMap(x, y, &col, &line);
+	if ((col >= EMU_COLUMNS) || (line >= EMU_LINES)){
+		return 0;
+	}
+	return gram[EmuScrollLine(line)][col];
+}
+
+uint32_t EmuScreenHash(void){
+	uint32_t hash = 2166136261u;
+	for (uint16_t line = 0; line < EMU_LINES; line++){
+		for (uint16_t col = 0; col < EMU_COLUMNS; col++){
+			uint16_t color = gram[EmuScrollLine(line)][col];
+			hash = (hash ^ (color >> 8)) * 16777619u;
+			hash = (hash ^ (color & 0xFF)) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+bool EmuSavePpm(const char *path){
+	bool landscape = (madctl & MADCTL_MV) != 0;
+	uint16_t width = landscape ? EMU_LINES : EMU_COLUMNS;
+	uint16_t height = landscape ? EMU_COLUMNS : EMU_LINES;
+	uint16_t color;
+	FILE *f = fopen(path, "wb");
+	if (f == NULL){
+		return false;
+	}
+	fprintf(f, "P6\n%d %d\n255\n", width, height);
+	for (uint16_t y = 0; y < height; y++){
+		for (uint16_t x = 0; x < width; x++){
+			color = EmuGetPixel(x, y);
+			fputc(((color >> 11) & 0x1F) * 255 / 31, f);
+			fputc(((color >> 5) & 0x3F) * 255 / 63, f);
+			fputc((color & 0x1F) * 255 / 31, f);
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+bool EmuPartitionLoad(const char *label, uint8_t subtype, const char *path){
+	esp_partition_t *p = &partitions[n_partitions];
+	FILE *f;
+	long size;
+
+	if ((n_partitions == EMU_PARTITIONS) || ((f = fopen(path, "rb")) == NULL)){
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	/* Erased flash (0xFF) up to the end of the last sector */
+	p->size = (size + EMU_FLASH_SECTOR - 1) / EMU_FLASH_SECTOR * EMU_FLASH_SECTOR;
+	partition_data[n_partitions] = malloc(p->size);
+	if (partition_data[n_partitions] == NULL){
+		fclose(f);
+		return false;
+	}
+	memset(partition_data[n_partitions], 0xFF, p->size);
+	if (fread(partition_data[n_partitions], 1, size, f) != (size_t)size){
+		free(partition_data[n_partitions]);
+		fclose(f);
+		return false;
+	}
+	fclose(f);
+	p->type = ESP_PARTITION_TYPE_DATA;
+	p->subtype = subtype;
+	p->address = 0;
+	snprintf(p->label, sizeof(p->label), "%s", label);
+	n_partitions++;
+	return true;
+}
+
+/* esp_partition mock */
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label){
+	for (uint8_t i = 0; i < n_partitions; i++){
+		if ((partitions[i].type == type) && ((subtype == ESP_PARTITION_SUBTYPE_ANY) || (partitions[i].subtype == subtype)) &&
+			((label == NULL) || (strcmp(partitions[i].label, label) == 0))){
+			return &partitions[i];
+		}
+	}
+	return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size){
+	uint8_t i = partition - partitions;
+	if ((src_offset > partition->size) || (size > partition->size - src_offset)){
+		return ESP_ERR_INVALID_SIZE;
+	}
+	memcpy(dst, &partition_data[i][src_offset], size);
+	return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+							 esp_partition_mmap_memory_t memory, const void **out_ptr, esp_partition_mmap_handle_t *out_handle){
+	uint8_t i = partition - partitions;
+	if ((offset > partition->size) || (size > partition->size - offset)){
+		return ESP_ERR_INVALID_SIZE;
+	}
+	/* Mapped memory is read only, as the flash cache */
+	*out_ptr = &partition_data[i][offset];
+	*out_handle = i;
+	return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle){
+}
+
+/* spi_mcu mock */
+uint8_t SpiInit(spi_mcu_config_t *spi){
+	EmuQueueFlush(&spi_dev[spi->device], 0);
+	spi_dev[spi->device].pre_func_p = spi->pre_func_p;
+	spi_dev[spi->device].post_func_p = spi->post_func_p;
+	spi_dev[spi->device].bitrate = spi->bitrate;
+	return 0;
+}
+
+uint8_t SpiSetBitrate(spi_dev_t device, uint32_t bitrate){
+	EmuQueueFlush(&spi_dev[device], 0);
+	spi_dev[device].bitrate = bitrate;
+	return 0;
+}
+
+void SpiRead(spi_dev_t device, uint8_t *rx_buffer, uint32_t rx_buffer_size){
+	EmuQueueFlush(&spi_dev[device], 0);
+	EmuTransfer(&spi_dev[device], NULL, rx_buffer, rx_buffer_size, NULL);
+}
+
+void SpiWrite(spi_dev_t device, uint8_t *tx_buffer, uint32_t tx_buffer_size){
+	EmuQueueFlush(&spi_dev[device], 0);
+	EmuTransfer(&spi_dev[device], tx_buffer, NULL, tx_buffer_size, NULL);
+}
+
+void SpiReadWrite(spi_dev_t device, uint8_t *tx_buffer, uint8_t *rx_buffer, uint32_t buffer_size){
+	EmuQueueFlush(&spi_dev[device], 0);
+	EmuTransfer(&spi_dev[device], tx_buffer, rx_buffer, buffer_size, NULL);
+}
+
+bool SpiQueueTransfer(spi_dev_t device, const uint8_t *tx_buffer, uint8_t *rx_buffer, uint32_t buffer_size, void *user){
+	emu_spi_t *dev = &spi_dev[device];
+	if (buffer_size > SPI_MAX_TRANSFER_SIZE){
+		fprintf(stderr, "emu: transaction of %u bytes (max %d)\n", (unsigned)buffer_size, SPI_MAX_TRANSFER_SIZE);
+		return false;
+	}
+	EmuQueueFlush(dev, EMU_QUEUE_SIZE - 1);
+	dev->queue[dev->head] = (emu_trans_t){tx_buffer, rx_buffer, buffer_size, user};
+	dev->head = (dev->head + 1) % EMU_QUEUE_SIZE;
+	dev->pending++;
+	counters.queued++;
+	return true;
+}
+
+bool SpiQueueWrite(spi_dev_t device, const uint8_t *tx_buffer, uint32_t tx_buffer_size, void *user){
+	return SpiQueueTransfer(device, tx_buffer, NULL, tx_buffer_size, user);
+}
+
+void SpiQueueWait(spi_dev_t device, uint8_t max_pending){
+	EmuQueueFlush(&spi_dev[device], max_pending);
+}
+
+uint8_t SpiQueuePending(spi_dev_t device){
+	/* The emulated bus is instantaneous: queued transactions end when they are polled */
+	EmuQueueFlush(&spi_dev[device], 0);
+	return 0;
+}
+
+void SpiBusAcquire(spi_dev_t device){
+}
+
+void SpiBusRelease(spi_dev_t device){
+}
+
+void SpiPollingWrite(spi_dev_t device, const uint8_t *tx_buffer, uint32_t tx_buffer_size, void *user){
+	EmuQueueFlush(&spi_dev[device], 0);
+	EmuTransfer(&spi_dev[device], tx_buffer, NULL, tx_buffer_size, user);
+}
+
+void SpiPollingRead(spi_dev_t device, const uint8_t *tx_buffer, uint32_t tx_buffer_size, void *tx_user,
+					uint8_t *rx_buffer, uint32_t rx_buffer_size, void *rx_user){
+	emu_spi_t *dev = &spi_dev[device];
+	EmuQueueFlush(dev, 0);
+	EmuTransfer(dev, tx_buffer, NULL, tx_buffer_size, tx_user);
+	EmuTransfer(dev, NULL, rx_buffer, rx_buffer_size, rx_user);
+}
+
+void *SpiDmaMalloc(uint32_t size){
+	return malloc(size);
+}
+
+void SpiDmaFree(void *buffer){
+	free(buffer);
+}
+
+uint8_t SpiDeInit(spi_dev_t device){
+	EmuQueueFlush(&spi_dev[device], 0);
+	return 0;
+}
+
+/* gpio_mcu mock */
+void GPIOInit(gpio_t pin, io_t io){
+}
+
+void GPIOOn(gpio_t pin){
+	gpio_level[pin % EMU_GPIOS] = true;
+}
+
+void GPIOOff(gpio_t pin){
+	gpio_level[pin % EMU_GPIOS] = false;
+}
+
+void GPIOState(gpio_t pin, bool state){
+	gpio_level[pin % EMU_GPIOS] = state;
+}
+
+void GPIOToggle(gpio_t pin){
+	gpio_level[pin % EMU_GPIOS] = !gpio_level[pin % EMU_GPIOS];
+}
+
+bool GPIORead(gpio_t pin){
+	return gpio_level[pin % EMU_GPIOS];
+}
+
+void EmuRegWrite(uint32_t reg, uint32_t value){
+	for (uint8_t i = 0; i < EMU_GPIOS; i++){
+		if (value & (1UL << i)){
+			gpio_level[i] = (reg == GPIO_OUT_W1TS_REG);
+		}
+	}
+}
+
+/* delay_mcu mock */
+void DelaySec(uint16_t sec){
+}
+
+void DelayMs(uint16_t msec){
+}
+
+void DelayUs(uint16_t usec){
+}
+
+/*==================[end of file]============================================*/
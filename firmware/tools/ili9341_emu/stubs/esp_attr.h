@@ -0,0 +1,6 @@
+/* Host stub of esp_attr.h (ILI9341 emulator) */
+#ifndef ESP_ATTR_H_
+#define ESP_ATTR_H_
+#define IRAM_ATTR
+#define DRAM_ATTR
+#endif /* ESP_ATTR_H_ */
@@ -0,0 +1,9 @@
+/* Host stub of esp_err.h (ILI9341 emulator) */
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+typedef int esp_err_t;
+#define ESP_OK					0
+#define ESP_FAIL				-1
+#define ESP_ERR_INVALID_ARG		0x102
+#define ESP_ERR_INVALID_SIZE	0x104
+#endif /* ESP_ERR_H_ */
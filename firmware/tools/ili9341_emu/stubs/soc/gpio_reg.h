@@ -0,0 +1,9 @@
+/* Host stub of soc/gpio_reg.h (ILI9341 emulator): GPIO register writes go to the emulated GPIOs */
+#ifndef SOC_GPIO_REG_H_
+#define SOC_GPIO_REG_H_
+#include <stdint.h>
+#define GPIO_OUT_W1TS_REG	0x60091008
+#define GPIO_OUT_W1TC_REG	0x6009100C
+void EmuRegWrite(uint32_t reg, uint32_t value);
+#define REG_WRITE(reg, value)	EmuRegWrite((reg), (value))
+#endif /* SOC_GPIO_REG_H_ */
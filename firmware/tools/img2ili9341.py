@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""
+Converts a PNG or BMP image into a compressed image for the ILI9341 driver.
+
+The output is a C source file with an ili9341_image_t variable (see ili9341.h),
+drawn with ILI9341DrawImage(). Pixels are converted to RGB565 and compressed
+with the smallest format (unless one is selected):
+    raw          RGB565, 2 bytes/pixel
+    rle          RLE packets of RGB565 pixels
+    palette      palette indexes of 1, 2, 4 or 8 bits (up to 256 colors)
+    palette_rle  RLE packets of 8 bits palette indexes (up to 256 colors)
+
+Transparent pixels (PNG alpha) are blended over the background color.
+
+Usage:
+    python3 img2ili9341.py input.png output.c --name image_name [--size 240x320]
+                           [--format rle] [--background 0xFFFFFF]
+"""
+import argparse
+import struct
+import zlib
+
+FORMATS = ["raw", "rle", "palette", "palette_rle"]
+FORMAT_ENUM = {
+    "raw": "ILI9341_IMAGE_RAW",
+    "rle": "ILI9341_IMAGE_RLE",
+    "palette": "ILI9341_IMAGE_PALETTE",
+    "palette_rle": "ILI9341_IMAGE_PALETTE_RLE",
+}
+RLE_MAX = 128
+LCD_MAX = 320
+
+
+def read_bmp(data):
+    """Uncompressed BMP (1, 4, 8, 24 or 32 bits). Returns (width, height, rows of (r, g, b, a))."""
+    offset, = struct.unpack_from("<I", data, 10)
+    width, height, _, bits, compression = struct.unpack_from("<iiHHI", data, 18)
+    if compression not in (0, 3) or bits not in (1, 4, 8, 24, 32):
+        raise SystemExit("Only uncompressed BMP files are supported")
+    header_size, = struct.unpack_from("<I", data, 14)
+    palette = []
+    if bits <= 8:
+        colors, = struct.unpack_from("<I", data, 46)
+        colors = colors or (1 << bits)
+        for i in range(colors):
+            b, g, r, _ = data[14 + header_size + i * 4:18 + header_size + i * 4]
+            palette.append((r, g, b, 255))
+    bottom_up = height > 0
+    height = abs(height)
+    stride = (width * bits + 31) // 32 * 4
+    rows = []
+    for y in range(height):
+        line = data[offset + y * stride:offset + (y + 1) * stride]
+        row = []
+        for x in range(width):
+            if bits == 24:
+                b, g, r = line[x * 3:x * 3 + 3]
+                row.append((r, g, b, 255))
+            elif bits == 32:
+                b, g, r, _ = line[x * 4:x * 4 + 4]
+                row.append((r, g, b, 255))
+            else:
+                bit = x * bits
+                index = (line[bit // 8] >> (8 - bits - bit % 8)) & ((1 << bits) - 1)
+                row.append(palette[index])
+        rows.append(row)
+    if bottom_up:
+        rows.reverse()
+    return width, height, rows
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(data):
+    """Non interlaced PNG (8 bits channels or palette). Returns (width, height, rows of (r, g, b, a))."""
+    pos = 8
+    idat = b""
+    palette, alpha = [], []
+    while pos < len(data):
+        length, kind = struct.unpack_from(">I4s", data, pos)
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += length + 12
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b"tRNS":
+            alpha = list(chunk)
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+    if interlace or (color != 3 and depth != 8) or color not in (0, 2, 3, 4, 6):
+        raise SystemExit("Only non interlaced PNG files with 8 bits channels or palette are supported")
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    bits = channels * depth
+    stride = (width * bits + 7) // 8
+    bpp = max(1, bits // 8)
+    raw = zlib.decompress(idat)
+    rows, prev = [], bytearray(stride)
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            c = prev[i - bpp] if i >= bpp else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + prev[i]) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + (a + prev[i]) // 2) & 0xFF
+            elif kind == 4:
+                line[i] = (line[i] + paeth(a, prev[i], c)) & 0xFF
+        prev = line
+        row = []
+        for x in range(width):
+            if color == 3:
+                bit = x * depth
+                index = (line[bit // 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1)
+                r, g, b = palette[index]
+                row.append((r, g, b, alpha[index] if index < len(alpha) else 255))
+            elif color == 0:
+                v = line[x]
+                row.append((v, v, v, 255))
+            elif color == 4:
+                v, a = line[x * 2:x * 2 + 2]
+                row.append((v, v, v, a))
+            elif color == 2:
+                r, g, b = line[x * 3:x * 3 + 3]
+                row.append((r, g, b, 255))
+            else:
+                row.append(tuple(line[x * 4:x * 4 + 4]))
+        rows.append(row)
+    return width, height, rows
+
+
+def resize(rows, width, height):
+    """Nearest neighbor resize."""
+    src_h, src_w = len(rows), len(rows[0])
+    return [[rows[y * src_h // height][x * src_w // width] for x in range(width)] for y in range(height)]
+
+
+def to_rgb565(rows, background):
+    """Flattens the image to RGB565 pixels, blending transparent pixels over the background."""
+    bg = ((background >> 16) & 0xFF, (background >> 8) & 0xFF, background & 0xFF)
+    pixels = []
+    for row in rows:
+        for r, g, b, a in row:
+            r, g, b = [(c * a + k * (255 - a)) // 255 for c, k in zip((r, g, b), bg)]
+            pixels.append(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return pixels
+
+
+def rle_encode(values, emit):
+    """RLE packets (see ili9341_image_format_t). emit(value) returns the bytes of one value."""
+    out = bytearray()
+    literal = []
+    i = 0
+
+    def flush():
+        if literal:
+            out.append(len(literal) - 1)
+            for v in literal:
+                out.extend(emit(v))
+            literal.clear()
+
+    while i < len(values):
+        run = 1
+        while i + run < len(values) and run < RLE_MAX and values[i + run] == values[i]:
+            run += 1
+        if run >= 2:
+            flush()
+            out.append(0x80 | (run - 1))
+            out.extend(emit(values[i]))
+            i += run
+        else:
+            literal.append(values[i])
+            if len(literal) == RLE_MAX:
+                flush()
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def encoded_size(result):
+    """Bytes of an encode() result: data and palette (2 bytes per color)."""
+    data, palette, _ = result
+    return len(data) + 2 * len(palette or [])
+
+
+def encode(pixels, fmt):
+    """Returns (data, palette, bpp) for the format, None if the format can't be used."""
+    rgb = lambda v: bytes((v >> 8, v & 0xFF))
+    if fmt == "raw":
+        return b"".join(rgb(v) for v in pixels), None, 0
+    if fmt == "rle":
+        return rle_encode(pixels, rgb), None, 0
+    palette = sorted(set(pixels))
+    if len(palette) > 256:
+        return None
+    index = {c: i for i, c in enumerate(palette)}
+    indexes = [index[v] for v in pixels]
+    if fmt == "palette_rle":
+        return rle_encode(indexes, lambda v: bytes((v,))), palette, 8
+    bpp = next(b for b in (1, 2, 4, 8) if len(palette) <= 1 << b)
+    data = bytearray()
+    acc, used = 0, 0
+    for i in indexes:
+        acc = (acc << bpp) | i
+        used += bpp
+        if used == 8:
+            data.append(acc)
+            acc, used = 0, 0
+    if used:
+        data.append(acc << (8 - used))
+    return bytes(data), palette, bpp
+
+
+def write_c(path, name, width, height, fmt, data, palette, bpp):
+    with open(path, "w") as f:
+        f.write("/* Generated by img2ili9341.py, do not edit */\n")
+        f.write("#include <stddef.h>\n")
+        f.write('#include "ili9341.h"\n\n')
+        if palette is not None:
+            f.write("static const uint16_t %s_palette[%d] = {\n" % (name, len(palette)))
+            for i in range(0, len(palette), 8):
+                f.write("\t" + ", ".join("0x%04X" % c for c in palette[i:i + 8]) + ",\n")
+            f.write("};\n\n")
+        f.write("static const uint8_t %s_data[%d] = {\n" % (name, len(data)))
+        for i in range(0, len(data), 16):
+            f.write("\t" + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",\n")
+        f.write("};\n\n")
+        f.write("const ili9341_image_t %s = {\n" % name)
+        f.write("\t.width = %d,\n" % width)
+        f.write("\t.height = %d,\n" % height)
+        f.write("\t.format = %s,\n" % FORMAT_ENUM[fmt])
+        f.write("\t.bpp = %d,\n" % bpp)
+        f.write("\t.palette = %s,\n" % ("%s_palette" % name if palette is not None else "NULL"))
+        f.write("\t.data = %s_data,\n" % name)
+        f.write("\t.size = %d\n" % len(data))
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="PNG or BMP file")
+    parser.add_argument("output", help="C source file")
+    parser.add_argument("--name", required=True, help="ili9341_image_t variable name")
+    parser.add_argument("--size", help="resize to WIDTHxHEIGHT pixels")
+    parser.add_argument("--format", choices=FORMATS, help="compression format (default: the smallest)")
+    parser.add_argument("--background", type=lambda v: int(v, 0), default=0xFFFFFF,
+                        help="RGB888 color for transparent pixels (default 0xFFFFFF)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        raw = f.read()
+    if raw[:2] == b"BM":
+        width, height, rows = read_bmp(raw)
+    elif raw[:8] == b"\x89PNG\r\n\x1a\n":
+        width, height, rows = read_png(raw)
+    else:
+        raise SystemExit("Unknown image file (only PNG and BMP are supported)")
+    if args.size:
+        width, height = (int(v) for v in args.size.lower().split("x"))
+        rows = resize(rows, width, height)
+    if width > LCD_MAX or height > LCD_MAX:
+        raise SystemExit("Image is bigger than the LCD (%dx%d), use --size" % (width, height))
+
+    pixels = to_rgb565(rows, args.background)
+    candidates = [args.format] if args.format else FORMATS
+    results = {}
+    for fmt in candidates:
+        result = encode(pixels, fmt)
+        if result is not None:
+            results[fmt] = result
+    if not results:
+        raise SystemExit("Image has more than 256 colors, %s format can't be used" % args.format)
+    fmt = min(results, key=lambda k: encoded_size(results[k]))
+    data, palette, bpp = results[fmt]
+    write_c(args.output, args.name, width, height, fmt, data, palette, bpp)
+    print("%s: %dx%d, %s, %d bytes (raw %d bytes)" % (args.name, width, height, fmt, encoded_size(results[fmt]),
+                                                      width * height * 2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""
+Converts a WAV file into an IMA-ADPCM sound for the buzzer_audio driver.
+
+The output is a C source file with a buzzer_audio_t variable (see buzzer_audio.h).
+The audio is mixed to mono and resampled to the selected sample rate.
+
+Usage:
+    python3 wav2adpcm.py input.wav output.c --name sound_name [--rate 8000]
+"""
+import argparse
+import struct
+import wave
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8,
+               -1, -1, -1, -1, 2, 4, 6, 8]
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767]
+
+RATE_MIN = 8000
+RATE_MAX = 16000
+
+
+def read_wav(path):
+    """Reads a PCM WAV file, returns (mono samples as int16, sample rate)."""
+    with wave.open(path, "rb") as wav:
+        channels = wav.getnchannels()
+        width = wav.getsampwidth()
+        rate = wav.getframerate()
+        frames = wav.readframes(wav.getnframes())
+    if width == 1:
+        raw = [(b - 128) << 8 for b in frames]
+    elif width == 2:
+        raw = list(struct.unpack("<%dh" % (len(frames) // 2), frames))
+    else:
+        raise SystemExit("Only 8 and 16 bits WAV files are supported")
+    mono = [sum(raw[i:i + channels]) // channels for i in range(0, len(raw), channels)]
+    return mono, rate
+
+
+def resample(samples, rate_in, rate_out):
+    """Linear interpolation resampling."""
+    if rate_in == rate_out or not samples:
+        return samples
+    n_out = int(len(samples) * rate_out / rate_in)
+    out = []
+    for i in range(n_out):
+        pos = i * rate_in / rate_out
+        j = int(pos)
+        frac = pos - j
+        a = samples[j]
+        b = samples[min(j + 1, len(samples) - 1)]
+        out.append(int(round(a + (b - a) * frac)))
+    return out
+
+
+def adpcm_encode(samples):
+    """IMA-ADPCM encoder. Returns (data, initial predictor, initial step index)."""
+    predictor = samples[0] if samples else 0
+    index = 0
+    first_predictor, first_index = predictor, index
+    nibbles = []
+    for sample in samples:
+        step = STEP_TABLE[index]
+        diff = sample - predictor
+        nibble = 0
+        if diff < 0:
+            nibble = 8
+            diff = -diff
+        delta = step >> 3
+        if diff >= step:
+            nibble |= 4
+            diff -= step
+            delta += step
+        if diff >= step >> 1:
+            nibble |= 2
+            diff -= step >> 1
+            delta += step >> 1
+        if diff >= step >> 2:
+            nibble |= 1
+            delta += step >> 2
+        # Same reconstruction as the decoder, so errors don't accumulate
+        predictor += -delta if nibble & 8 else delta
+        predictor = max(-32768, min(32767, predictor))
+        index = max(0, min(88, index + INDEX_TABLE[nibble]))
+        nibbles.append(nibble)
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    data = bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, len(nibbles), 2))
+    return data, first_predictor, first_index
+
+
+def write_c(path, name, data, samples, rate, predictor, index):
+    with open(path, "w") as f:
+        f.write("/* Generated by wav2adpcm.py, do not edit */\n")
+        f.write('#include "buzzer_audio.h"\n\n')
+        f.write("static const uint8_t %s_data[%d] = {\n" % (name, len(data)))
+        for i in range(0, len(data), 16):
+            f.write("\t" + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",\n")
+        f.write("};\n\n")
+        f.write("const buzzer_audio_t %s = {\n" % name)
+        f.write("\t.data = %s_data,\n" % name)
+        f.write("\t.samples = %d,\n" % samples)
+        f.write("\t.sample_rate = %d,\n" % rate)
+        f.write("\t.predictor = %d,\n" % predictor)
+        f.write("\t.step_index = %d\n" % index)
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="WAV file (PCM, 8 or 16 bits)")
+    parser.add_argument("output", help="C source file")
+    parser.add_argument("--name", required=True, help="buzzer_audio_t variable name")
+    parser.add_argument("--rate", type=int, default=RATE_MIN, help="sample rate (%d to %d Hz)" % (RATE_MIN, RATE_MAX))
+    args = parser.parse_args()
+    if not RATE_MIN <= args.rate <= RATE_MAX:
+        raise SystemExit("Sample rate must be between %d and %d Hz" % (RATE_MIN, RATE_MAX))
+
+    samples, rate = read_wav(args.input)
+    samples = resample(samples, rate, args.rate)
+    data, predictor, index = adpcm_encode(samples)
+    write_c(args.output, args.name, data, len(samples), args.rate, predictor, index)
+    print("%s: %d samples, %d bytes (%.1f s)" % (args.name, len(samples), len(data), len(samples) / args.rate))
+
+
+if __name__ == "__main__":
+    main()